@@ -9,6 +9,7 @@
 #import <VerovioFramework/functorparams.h>
 #import <VerovioFramework/comparison.h>
 #import <VerovioFramework/toolkit.h>
+#import <VerovioFramework/rendercache.h>
 #import <VerovioFramework/rest.h>
 #import <VerovioFramework/tuplet.h>
 #import <VerovioFramework/bboxdevicecontext.h>
@@ -145,6 +146,9 @@
 #import <VerovioFramework/editortoolkit.h>
 #import <VerovioFramework/dynam.h>
 #import <VerovioFramework/svgdevicecontext.h>
+#import <VerovioFramework/displaylistdevicecontext.h>
+#import <VerovioFramework/rasterdevicecontext.h>
+#import <VerovioFramework/pdfdevicecontext.h>
 #import <VerovioFramework/turn.h>
 #import <VerovioFramework/drawinginterface.h>
 #import <VerovioFramework/systemelement.h>
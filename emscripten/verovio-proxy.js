@@ -9,6 +9,9 @@ verovio.vrvToolkit.constructor = Module.cwrap('vrvToolkit_constructor', 'number'
 // void destructor(Toolkit *ic)
 verovio.vrvToolkit.destructor = Module.cwrap('vrvToolkit_destructor', null, ['number']);
 
+// void completeLayout(Toolkit *ic)
+verovio.vrvToolkit.completeLayout = Module.cwrap('vrvToolkit_completeLayout', null, ['number']);
+
 // bool edit(Toolkit *ic, const char *editorAction) 
 verovio.vrvToolkit.edit = Module.cwrap('vrvToolkit_edit', 'number', ['number', 'string']);
 
@@ -24,6 +27,9 @@ verovio.vrvToolkit.getElementAttr = Module.cwrap('vrvToolkit_getElementAttr', 's
 // char *getElementsAtTime(Toolkit *ic, int time)
 verovio.vrvToolkit.getElementsAtTime = Module.cwrap('vrvToolkit_getElementsAtTime', 'string', ['number', 'number']);
 
+// char *getGlyphSprite(Toolkit *ic, bool allGlyphs)
+verovio.vrvToolkit.getGlyphSprite = Module.cwrap('vrvToolkit_getGlyphSprite', 'string', ['number', 'number']);
+
 // char *getHumdrum(Toolkit *ic)
 verovio.vrvToolkit.getHumdrum = Module.cwrap('vrvToolkit_getHumdrum', 'string');
 
@@ -51,6 +57,9 @@ verovio.vrvToolkit.getMIDIValuesForElement = Module.cwrap('vrvToolkit_getMIDIVal
 // char *getVersion(Toolkit *ic)
 verovio.vrvToolkit.getVersion = Module.cwrap('vrvToolkit_getVersion', 'string', ['number']);
 
+// bool isLayoutComplete(Toolkit *ic)
+verovio.vrvToolkit.isLayoutComplete = Module.cwrap('vrvToolkit_isLayoutComplete', 'number', ['number']);
+
 // bool loadData(Toolkit *ic, const char *data)
 verovio.vrvToolkit.loadData = Module.cwrap('vrvToolkit_loadData', 'number', ['number', 'string']);
 
@@ -63,12 +72,21 @@ verovio.vrvToolkit.redoPagePitchPosLayout = Module.cwrap('vrvToolkit_redoPagePit
 // char *renderData(Toolkit *ic, const char *data, const char *options)
 verovio.vrvToolkit.renderData = Module.cwrap('vrvToolkit_renderData', 'string', ['number', 'string', 'string']);
 
+// char *renderMeasureRangeToSVG(Toolkit *ic, int firstMeasure, int lastMeasure)
+verovio.vrvToolkit.renderMeasureRangeToSVG = Module.cwrap('vrvToolkit_renderMeasureRangeToSVG', 'string', ['number', 'number', 'number']);
+
 // char *renderToMidi(Toolkit *ic, const char *rendering_options)
 verovio.vrvToolkit.renderToMIDI = Module.cwrap('vrvToolkit_renderToMIDI', 'string', ['number', 'string']);
 
 // char *renderToSvg(Toolkit *ic, int pageNo, const char *rendering_options)
 verovio.vrvToolkit.renderToSVG = Module.cwrap('vrvToolkit_renderToSVG', 'string', ['number', 'number', 'string']);
 
+// char *renderToSVGClip(Toolkit *ic, int pageNo, int x, int y, int width, int height, const char *rendering_options)
+verovio.vrvToolkit.renderToSVGClip = Module.cwrap('vrvToolkit_renderToSVGClip', 'string', ['number', 'number', 'number', 'number', 'number', 'number', 'string']);
+
+// char *renderToSVGPatch(Toolkit *ic, int pageNo)
+verovio.vrvToolkit.renderToSVGPatch = Module.cwrap('vrvToolkit_renderToSVGPatch', 'string', ['number', 'number']);
+
 // char *renderToTimemap(Toolkit *ic)
 verovio.vrvToolkit.renderToTimemap = Module.cwrap('vrvToolkit_renderToTimemap', 'string', ['number']);
 
@@ -92,6 +110,10 @@ verovio.toolkit.prototype.destroy = function () {
 	verovio.vrvToolkit.destructor(this.ptr);
 };
 
+verovio.toolkit.prototype.completeLayout = function () {
+	verovio.vrvToolkit.completeLayout(this.ptr);
+};
+
 verovio.toolkit.prototype.edit = function (editorAction) {
 	return verovio.vrvToolkit.edit(this.ptr, JSON.stringify(editorAction));
 };
@@ -112,6 +134,10 @@ verovio.toolkit.prototype.getElementsAtTime = function (millisec) {
 	return JSON.parse(verovio.vrvToolkit.getElementsAtTime(this.ptr, millisec));
 };
 
+verovio.toolkit.prototype.getGlyphSprite = function (allGlyphs) {
+	return verovio.vrvToolkit.getGlyphSprite(this.ptr, allGlyphs ? 1 : 0);
+};
+
 verovio.toolkit.prototype.getHumdrum = function () {
 	return verovio.vrvToolkit.getHumdrum(this.ptr);
 };
@@ -148,6 +174,10 @@ verovio.toolkit.prototype.getVersion = function () {
 	return verovio.vrvToolkit.getVersion(this.ptr);
 };
 
+verovio.toolkit.prototype.isLayoutComplete = function () {
+	return verovio.vrvToolkit.isLayoutComplete(this.ptr) != 0;
+};
+
 verovio.toolkit.prototype.loadData = function (data) {
 	return verovio.vrvToolkit.loadData(this.ptr, data);
 };
@@ -164,6 +194,10 @@ verovio.toolkit.prototype.renderData = function (data, options) {
 	return verovio.vrvToolkit.renderData(this.ptr, data, JSON.stringify(options));
 };
 
+verovio.toolkit.prototype.renderMeasureRangeToSVG = function (firstMeasure, lastMeasure) {
+	return verovio.vrvToolkit.renderMeasureRangeToSVG(this.ptr, firstMeasure, lastMeasure);
+};
+
 verovio.toolkit.prototype.renderPage = function (pageNo, options) {
 	console.warn("Method renderPage is deprecated; use renderToSVG instead");
 	return verovio.vrvToolkit.renderToSVG(this.ptr, pageNo, JSON.stringify(options));
@@ -182,6 +216,14 @@ verovio.toolkit.prototype.renderToSVG = function (pageNo, options) {
 	return verovio.vrvToolkit.renderToSVG(this.ptr, pageNo, JSON.stringify(options));
 };
 
+verovio.toolkit.prototype.renderToSVGClip = function (pageNo, x, y, width, height, options) {
+	return verovio.vrvToolkit.renderToSVGClip(this.ptr, pageNo, x, y, width, height, JSON.stringify(options));
+};
+
+verovio.toolkit.prototype.renderToSVGPatch = function (pageNo) {
+	return JSON.parse(verovio.vrvToolkit.renderToSVGPatch(this.ptr, pageNo));
+};
+
 verovio.toolkit.prototype.renderToTimemap = function () {
 	return JSON.parse(verovio.vrvToolkit.renderToTimemap(this.ptr));
 };
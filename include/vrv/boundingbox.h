@@ -264,6 +264,53 @@ private:
     int m_smuflGlyphFontSize;
 };
 
+//----------------------------------------------------------------------------
+// BezierPolynomial
+//----------------------------------------------------------------------------
+
+/**
+ * This class holds the coefficients of the y position of a cubic bezier as a polynomial in t.
+ * The coefficients are calculated once for the curve and the y position can then be calculated for one or a batch of
+ * x positions, with t proportional to x as in BoundingBox::CalcBezierAtPosition.
+ */
+class BezierPolynomial {
+public:
+    /**
+     * @name Constructors, destructors, and setters
+     */
+    ///@{
+    BezierPolynomial();
+    BezierPolynomial(const Point bezier[4]);
+    virtual ~BezierPolynomial(){};
+    void SetBezier(const Point bezier[4]);
+    ///@}
+
+    /**
+     * Calculate the y position at position x
+     */
+    int CalcYAtPosition(int x) const;
+
+    /**
+     * Calculate the y positions for count x positions.
+     * The loop has no branch and can be vectorized by the compiler.
+     */
+    void CalcYAtPositions(const int *xs, int *ys, int count) const;
+
+private:
+    //
+public:
+    //
+private:
+    /** The x of the start point and the width of the curve */
+    int m_x;
+    int m_width;
+    /** The coefficients of the polynomial from t^3 to t^0 */
+    double m_a;
+    double m_b;
+    double m_c;
+    double m_d;
+};
+
 //----------------------------------------------------------------------------
 // SegmentedLine
 //----------------------------------------------------------------------------
@@ -321,6 +368,60 @@ private:
     ArrayOfIntPairs m_segments;
 };
 
+//----------------------------------------------------------------------------
+// BoundingBoxIndex
+//----------------------------------------------------------------------------
+
+/**
+ * This class stores a list of bounding boxes with an index of their horizontal content position.
+ * The boxes are grouped by width (in powers of two) and sorted by their left position within each group.
+ * This makes it possible to find the boxes overlapping horizontally with another one without looking at all of them.
+ * The horizontal position of the boxes must not change once they have been added.
+ */
+class BoundingBoxIndex {
+public:
+    /**
+     * @name Constructors, destructors, reset methods
+     */
+    ///@{
+    BoundingBoxIndex(){};
+    virtual ~BoundingBoxIndex(){};
+    void Clear();
+    ///@}
+
+    /**
+     * Add a box at the end of the list
+     */
+    void Add(BoundingBox *box);
+
+    /**
+     * Return the boxes in the order they were added
+     */
+    const ArrayOfBoundingBoxes &GetBoxes() const { return m_boxes; }
+
+    /**
+     * Fill the array with the boxes overlapping horizontally (content) with the box.
+     * The boxes are given in the order they were added, as with BoundingBox::HorizontalContentOverlap on each of them.
+     */
+    void FindHorizontalContentOverlaps(const BoundingBox *box, ArrayOfBoundingBoxes &overlappingBoxes) const;
+
+private:
+    //
+public:
+    //
+private:
+    /**
+     * The boxes in the order they were added
+     */
+    ArrayOfBoundingBoxes m_boxes;
+
+    /**
+     * For each width group, the position of the boxes in m_boxes by their left content position.
+     * Group n contains the boxes with a width smaller than 2^n. Boxes without content bounding box are not indexed.
+     */
+    std::vector<std::multimap<int, int> > m_groups;
+};
+
 } // namespace vrv
 
 #endif
@@ -0,0 +1,255 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        displaylistdevicecontext.h
+// Author:      agent
+// Created:     18/10/2026
+// Copyright (c) Authors and others. All rights reserved.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef __VRV_DISPLAY_LIST_DC_H__
+#define __VRV_DISPLAY_LIST_DC_H__
+
+#include <map>
+#include <string>
+#include <vector>
+
+//----------------------------------------------------------------------------
+
+#include "devicecontext.h"
+
+namespace vrv {
+
+//----------------------------------------------------------------------------
+// DisplayListDeviceContext
+//----------------------------------------------------------------------------
+
+/**
+ * This class records the drawing calls of a page into a compact binary display list.
+ * It is designed for clients that replay the drawing themselves (e.g., on a canvas) without parsing SVG.
+ *
+ * The display list starts with the 4 bytes "VRDL" and a version byte (1), followed by the operations. Each
+ * operation is an opcode byte followed by its arguments:
+ * - u: unsigned LEB128 varint;
+ * - s: signed value, zigzag-encoded as a varint (i.e., (v << 1) ^ (v >> 31));
+ * - f: 32-bit IEEE float, little-endian;
+ * - b: a single byte;
+ * - str: u length followed by the UTF-8 bytes;
+ * - istr: interned string, u index in the string table; when the index is the size of the table, a str
+ *   follows and is added to the table;
+ * - pt: a point, as s dx and s dy from the previous point (starting at 0,0 and for all the operations).
+ *
+ * Coordinates are in the drawing units of the page (the viewBox of the SVG), with y going down.
+ *
+ * Operations:
+ * - 0x01 page: s width, s height, s viewBoxWidth, s viewBoxHeight, f userScale, s originX, s originY.
+ *   The page content is translated by the origin (the page margins).
+ * - 0x02 end of page.
+ * - 0x10 start group: b flags (1: has id, 2: prepend, 4: text group, 8: has colour), istr class, [str id],
+ *   [str colour]. The class is the one of the SVG <g> and the colour the one of its @fill.
+ * - 0x11 end group.
+ * - 0x12 resume group: str id. The drawing is added to the group with the id until the matching 0x11.
+ * - 0x13 rotate the current group: pt origin, f angle (clockwise, in degrees).
+ * - 0x20 pen: s colour, s width, s dashLength, b opacity (0-255).
+ * - 0x21 brush: s colour, b opacity (0-255).
+ * - 0x22 font: s pointSize, b style, b weight, istr family.
+ * - 0x30 line: pt, pt.
+ * - 0x31 polygon: u n, n pt (filled with the brush and stroked with the pen).
+ * - 0x32 rectangle: pt, s width, s height, s radius.
+ * - 0x33 ellipse: pt (top-left), s width, s height.
+ * - 0x34 elliptic arc: pt (top-left), s width, s height, f start, f end (degrees, counter-clockwise).
+ * - 0x35 bezier shape: 7 pt, the start, two curves of 3 points each, closed and filled.
+ * - 0x36 glyph: pt, u SMuFL code (size of the current font).
+ * - 0x37 svg shape: pt, s width, s height, str SVG content.
+ * - 0x40 start text: pt, b alignment.
+ * - 0x41 text run: b has position, [pt], str text (with the current font).
+ * - 0x42 move text: pt, b alignment.
+ * - 0x43 move text vertically: s y (absolute).
+ * - 0x44 end text.
+ *
+ * Pen, brush and font operations are written only when changed before a drawing operation. Since there is no
+ * global styling (as with the CSS of the SVG), the fonts are always fully specified.
+ * Colours are the device context values (-1 for the current colour, otherwise 0xRRGGBB).
+ */
+class DisplayListDeviceContext : public DeviceContext {
+public:
+    /**
+     * @name Constructors, destructors, and other standard methods
+     */
+    ///@{
+    DisplayListDeviceContext();
+    virtual ~DisplayListDeviceContext();
+    virtual ClassId GetClassId() const { return DISPLAY_LIST_DEVICE_CONTEXT; }
+    ///@}
+
+    /**
+     * @name Setters
+     */
+    ///@{
+    virtual void SetBackground(int colour, int style = AxSOLID){};
+    virtual void SetBackgroundImage(void *image, double opacity = 1.0){};
+    virtual void SetBackgroundMode(int mode){};
+    virtual void SetTextForeground(int colour){};
+    virtual void SetTextBackground(int colour){};
+    virtual void SetLogicalOrigin(int x, int y);
+    ///@}
+
+    /**
+     * @name Getters
+     */
+    ///@{
+    virtual Point GetLogicalOrigin();
+    ///@}
+
+    /**
+     * @name Drawing methods
+     */
+    ///@{
+    virtual void DrawComplexBezierPath(Point bezier1[4], Point bezier2[4]);
+    virtual void DrawCircle(int x, int y, int radius);
+    virtual void DrawEllipse(int x, int y, int width, int height);
+    virtual void DrawEllipticArc(int x, int y, int width, int height, double start, double end);
+    virtual void DrawLine(int x1, int y1, int x2, int y2);
+    virtual void DrawPolygon(int n, Point points[], int xOffset, int yOffset, int fillStyle = AxODDEVEN_RULE);
+    virtual void DrawRectangle(int x, int y, int width, int height);
+    virtual void DrawRotatedText(const std::string &text, int x, int y, double angle){};
+    virtual void DrawRoundedRectangle(int x, int y, int width, int height, double radius);
+    virtual void DrawText(
+        const std::string &text, const std::wstring wtext = L"", int x = VRV_UNSET, int y = VRV_UNSET);
+    virtual void DrawMusicText(const std::wstring &text, int x, int y, bool setSmuflGlyph = false);
+    virtual void DrawSpline(int n, Point points[]){};
+    virtual void DrawSvgShape(int x, int y, int width, int height, pugi::xml_node svg);
+    virtual void DrawBackgroundImage(int x = 0, int y = 0){};
+    ///@}
+
+    /**
+     * @name Method for starting and ending a text
+     */
+    ///@{
+    virtual void StartText(int x, int y, data_HORIZONTALALIGNMENT alignment = HORIZONTALALIGNMENT_left);
+    virtual void EndText();
+    ///@}
+
+    /**
+     * @name Move a text to the specified position, for example when starting a new line.
+     */
+    ///@{
+    virtual void MoveTextTo(int x, int y, data_HORIZONTALALIGNMENT alignment);
+    virtual void MoveTextVerticallyTo(int y);
+    ///@}
+
+    /**
+     * @name Method for starting and ending a graphic
+     */
+    ///@{
+    virtual void StartGraphic(Object *object, std::string gClass, std::string gId, bool prepend = false);
+    virtual void EndGraphic(Object *object, View *view);
+    ///@}
+
+    /**
+     * @name Method for starting and ending a graphic custom
+     */
+    ///@{
+    virtual void StartCustomGraphic(std::string name, std::string gClass = "", std::string gId = "");
+    virtual void EndCustomGraphic();
+    ///@}
+
+    /**
+     * @name Methods for re-starting and ending a graphic for objects drawn in separate steps
+     */
+    ///@{
+    virtual void ResumeGraphic(Object *object, std::string gId);
+    virtual void EndResumedGraphic(Object *object, View *view);
+    ///@}
+
+    /**
+     * @name Method for starting and ending a text (<tspan>) text graphic
+     */
+    ///@{
+    virtual void StartTextGraphic(Object *object, std::string gClass, std::string gId);
+    virtual void EndTextGraphic(Object *object, View *view);
+    ///@}
+
+    /**
+     * @name Method for rotating a graphic (clockwise).
+     */
+    ///@{
+    virtual void RotateGraphic(Point const &orig, double angle);
+    ///@}
+
+    /**
+     * @name Method for starting and ending page
+     */
+    ///@{
+    virtual void StartPage();
+    virtual void EndPage();
+    ///@}
+
+    /**
+     * Setting the facsimile flag (false by default), for which the viewBox is not scaled
+     */
+    void SetFacsimile(bool facsimile) { m_facsimile = facsimile; }
+
+    /**
+     * Return the display list
+     */
+    const std::string &GetDisplayList() const { return m_data; }
+
+    /**
+     * Replay a display list into another device context (e.g., a SvgDeviceContext).
+     * This is the reference decoder of the format. Since there are no objects, groups are started with
+     * StartCustomGraphic, text groups are skipped, and resumed groups are passed a NULL object.
+     * Return false if the display list is not valid.
+     */
+    static bool Replay(const std::string &displayList, DeviceContext *dc);
+
+private:
+    /**
+     * @name Methods for writing the values
+     */
+    ///@{
+    void WriteOp(unsigned char op) { m_data.push_back((char)op); }
+    void WriteUnsigned(unsigned int value);
+    void WriteSigned(int value);
+    void WriteFloat(float value);
+    void WriteString(const std::string &value);
+    void WriteInterned(const std::string &value);
+    void WritePoint(int x, int y);
+    ///@}
+
+    /**
+     * Write the pen, the brush or the font if they changed since written
+     */
+    ///@{
+    void WritePen();
+    void WriteBrush();
+    void WriteFont();
+    ///@}
+
+    /**
+     * Write a group start with the class, the id and the flags
+     */
+    void WriteGroup(const std::string &gClass, const std::string &gId, unsigned char flags);
+
+public:
+    //
+private:
+    /** The display list */
+    std::string m_data;
+    /** The interned strings and their indexes */
+    std::map<std::string, int> m_strings;
+    /** The previous point for the coordinate deltas */
+    int m_lastX, m_lastY;
+    /** The pen, brush and font written last (with a flag for none written yet) */
+    ///@{
+    bool m_hasPen, m_hasBrush, m_hasFont;
+    Pen m_pen;
+    Brush m_brush;
+    FontInfo m_font;
+    ///@}
+    /** The origin */
+    int m_originX, m_originY;
+    bool m_facsimile;
+};
+
+} // namespace vrv
+
+#endif // __VRV_DISPLAY_LIST_DC_H__
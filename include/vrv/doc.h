@@ -22,9 +22,12 @@ namespace vrv {
 class CastOffPagesParams;
 class FontInfo;
 class Glyph;
+class Layer;
+class Measure;
 class Pages;
 class Page;
 class Score;
+class System;
 
 enum DocType { Raw = 0, Rendering, Transcription, Facs };
 
@@ -112,9 +115,20 @@ public:
 
     /**
      * Get the total page count
+     * When the document is being cast off progressively, only the pages completed so far are counted.
      */
     int GetPageCount();
 
+    /**
+     * @name Get the measures of the document in order and the system of a measure with its position in it.
+     * The index is built when first needed and reset with the drawing page (see Doc::ResetDrawingPage).
+     * GetMeasureSystem returns NULL for a measure that is not a child of a system (e.g., within editorial markup).
+     */
+    ///@{
+    const std::vector<Measure *> &GetMeasureIndex();
+    System *GetMeasureSystem(Measure *measure, int &position);
+    ///@}
+
     /**
      * Return true if the MIDI generation is already done
      */
@@ -234,6 +248,19 @@ public:
      */
     void CastOffDoc();
 
+    /**
+     * Casts off the document progressively until it has at least pageCount complete pages (all of them with 0).
+     * The measures not cast off yet are kept in a pending page at the end of the document. They are laid out
+     * and cast off by chunks as with Doc::RecastOffDoc, and the last page of each chunk is moved back to the
+     * pending page since the next measures can still be added to it. The first call expects a single page.
+     */
+    void CastOffDocProgressive(int pageCount);
+
+    /**
+     * Return true if the document is being cast off progressively and has measures not cast off yet.
+     */
+    bool IsCastOffPending() const { return (m_castOffPendingPage != NULL); }
+
     /**
      * Casts off the running elements (headers and footer)
      * Called from Doc::CastOffDoc
@@ -249,6 +276,34 @@ public:
      */
     void UnCastOffDoc();
 
+    /**
+     * Cast off again the part of the document with measures marked as dirty.
+     * Only the systems with dirty measures are laid out again. The systems are cast off again from the
+     * one before the first dirty system until they match the previous ones, and the pages from the page
+     * of that system. The pages before keep their layout.
+     * Return false without modifying the document if it was not (completely) cast off with Doc::CastOffDoc or if
+     * the layout of the whole document is marked as dirty.
+     */
+    bool RecastOffDoc();
+
+    /**
+     * Cast off again the document after a change of the page size or of the page margins.
+     * The measures are not laid out horizontally again and their stored widths are used. When the width for
+     * the systems did not change, only the pages are cast off again with the stored system heights.
+     * Return false without modifying the document if it was not (completely) cast off with Doc::CastOffDoc or if
+     * some layout is marked as dirty.
+     */
+    bool RebreakDoc();
+
+    /**
+     * Mark the measure of the object as having to be laid out again.
+     * For time spanning elements, the measure of the end element is also marked. For clefs, key signatures and
+     * meter signatures, all the following measures are also marked since their width can change.
+     * The layout of the whole document is marked if no object is given or if the object is not within
+     * a measure of a system.
+     */
+    void MarkLayoutDirty(Object *object = NULL);
+
     /**
      * Cast off of the entire document according to the encoded data (pb and sb).
      * Does not perform any check on the presence and / or validity of such data.
@@ -303,9 +358,9 @@ public:
      * Reset drawing page to NULL.
      * This might be necessary if we have replaced a page in the document.
      * We need to call this because otherwise looking at the page idx will fail.
-     * See Doc::LayOut for an example.
+     * See Doc::LayOut for an example. The measure index is reset too since the measures might have moved.
      */
-    void ResetDrawingPage() { m_drawingPage = NULL; }
+    void ResetDrawingPage();
 
     /**
      * Getter to the drawPage. Normally, getting the page should
@@ -348,6 +403,13 @@ public:
     bool HasFacsimile() const { return m_facsimile != NULL; }
     ///@}
 
+    /**
+     * Return the last clef before the layer in the document (NULL if none).
+     * This is used in facsimile documents where the clef of a layer can be in a previous one.
+     * The clefs are looked up in a table built once and rebuilt when the document has been modified.
+     */
+    Clef *GetClefBeforeLayer(Layer *layer);
+
     //----------//
     // Functors //
     //----------//
@@ -363,11 +425,73 @@ public:
     virtual int PrepareTimestampsEnd(FunctorParams *functorParams);
 
 private:
+    /**
+     * The glyph bounding box and advance scaled for a staff size and grace size.
+     */
+    struct GlyphMetrics {
+        int m_y;
+        int m_width;
+        int m_height;
+        int m_advX;
+    };
+
     /**
      * Calculates the music font size according to the m_interlDefin reference value.
      */
     int CalcMusicFontSize();
 
+    /**
+     * Return true if the scoreDef has to be optimized when casting off the document.
+     */
+    bool IsCastOffOptimized();
+
+    /**
+     * Set the current scoreDef of the pages from a given page and optimize it if required.
+     * The upcoming scoreDef is the one at the beginning of the page, which is the page drawing scoreDef.
+     * Used by Doc::RecastOffDoc for leaving the previous pages untouched.
+     */
+    void SetCurrentScoreDefFromPage(int pageIdx, const ScoreDef &upcomingScoreDef, bool optimize);
+
+    /**
+     * @name Cast off the systems and then the pages of a content page.
+     * The content page needs to be the only page of the document. With useCastOffWidths, the content system
+     * has not been laid out and the measure and label widths stored in Doc::CastOffDoc are used.
+     */
+    ///@{
+    void CastOffSystemsDoc(Page *contentPage, bool useCastOffWidths);
+    void CastOffPagesDoc(Page *contentPage);
+    ///@}
+
+    /**
+     * Fill the list with all the systems and look for the first and last ones with measures marked as dirty.
+     * Return false if a system or a clean measure does not have its cast off values stored.
+     */
+    bool FindDirtySystems(std::vector<System *> &systems, int &firstDirty, int &lastDirty);
+
+    /**
+     * Fill the margin tables from the options.
+     * Called from Doc::SetDrawingPage, also when the page does not change, so the margins are looked up by ClassId
+     * while laying out and changes in the options are taken into account.
+     */
+    void SetDrawingMargins();
+
+    /**
+     * Reset the cached glyph metrics if the font, the font size or the grace factor have changed.
+     * Called from Doc::SetDrawingPage, also when the page does not change.
+     */
+    void ResetGlyphMetrics();
+
+    /**
+     * Return the metrics of a glyph scaled for the staff and grace sizes.
+     * They are calculated the first time and then cached in m_glyphMetrics.
+     */
+    GlyphMetrics GetGlyphMetrics(wchar_t code, int staffSize, bool graceSize) const;
+
+    /**
+     * Fill the measure index with the measures of the document and their system and position.
+     */
+    void BuildMeasureIndex();
+
 public:
     /**
      * A copy of the header tree stored as pugi::xml_document
@@ -453,6 +577,34 @@ private:
     /** Current lyric font */
     FontInfo m_drawingLyricFont;
 
+    /**
+     * @name The left, right, bottom and top margins for each ClassId.
+     * Filled in Doc::SetDrawingMargins.
+     */
+    ///@{
+    double m_drawingLeftMargins[UNSPECIFIED + 1];
+    double m_drawingRightMargins[UNSPECIFIED + 1];
+    double m_drawingBottomMargins[UNSPECIFIED + 1];
+    double m_drawingTopMargins[UNSPECIFIED + 1];
+    ///@}
+
+    /**
+     * The cached glyph metrics for each staff size and grace size (key staffSize * 2 + graceSize).
+     * The tables are indexed by the SMuFL code from SMUFL_CACHE_FIRST and filled in Doc::GetGlyphMetrics.
+     */
+    mutable std::map<int, std::vector<GlyphMetrics> > m_glyphMetrics;
+    /** The font version, font size and grace factor with which the metrics were calculated */
+    int m_glyphMetricsFontVersion;
+    int m_glyphMetricsFontSize;
+    double m_glyphMetricsGraceFactor;
+
+    /**
+     * The measures in document order and their system and position in it, filled in Doc::BuildMeasureIndex.
+     * The positions are only for the measures that are children of a system.
+     */
+    std::vector<Measure *> m_measureIndex;
+    std::map<Measure *, std::pair<System *, int> > m_measurePositions;
+
     /**
      * A flag to indicate whether the currentScoreDef has been set or not.
      * If yes, SetCurrentScoreDef will not parse the document (again) unless
@@ -486,6 +638,40 @@ private:
      */
     bool m_isMensuralMusicOnly;
 
+    /**
+     * A flag to indicate that the layout of the whole document has to be redone.
+     * Set by Doc::MarkLayoutDirty and reset when the document is cast off.
+     */
+    bool m_isLayoutDirty;
+
+    /**
+     * @name The page header and footer heights (first page and other pages) calculated in Doc::CastOffDoc.
+     * They are kept for casting off the pages again in Doc::RecastOffDoc.
+     */
+    ///@{
+    int m_castOffPgHeadHeight;
+    int m_castOffPgFootHeight;
+    int m_castOffPgHead2Height;
+    int m_castOffPgFoot2Height;
+    ///@}
+
+    /**
+     * The page with the measures not cast off yet by Doc::CastOffDocProgressive (NULL otherwise).
+     * It is always the last page of the document.
+     */
+    Page *m_castOffPendingPage;
+
+    /**
+     * @name The width available for the systems, the widths of the labels and the width of the initial
+     * scoreDef in Doc::CastOffDoc. They are kept for casting off the systems again in Doc::RebreakDoc.
+     */
+    ///@{
+    int m_castOffSystemWidth;
+    int m_castOffLabelsWidth;
+    int m_castOffAbbrLabelsWidth;
+    int m_castOffScoreDefWidth;
+    ///@}
+
     /** Page width (MEI scoredef@page.width) - currently not saved */
     int m_pageWidth;
     /** Page height (MEI scoredef@page.height) - currently not saved */
@@ -501,6 +687,9 @@ private:
 
     /** Facsimile information */
     Facsimile *m_facsimile = NULL;
+
+    /** The last clef before each layer - filled in Doc::GetClefBeforeLayer */
+    MapOfObjectClefs m_layerClefs;
 };
 
 } // namespace vrv
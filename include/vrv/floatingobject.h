@@ -275,6 +275,17 @@ public:
      */
     int CalcAdjustment(BoundingBox *boundingBox, bool &discard, int margin = 0);
 
+    /**
+     * @name Getters for the top and bottom beziers of the thick curve (see BoundingBox::CalcThickBezier).
+     * The points are absolute and the polynomials are used for calculating the y positions.
+     * They are calculated once and kept until the curve parameters or its position change.
+     */
+    ///@{
+    void GetThickBezierPoints(Point topBezier[4], Point bottomBezier[4]);
+    const BezierPolynomial &GetTopBezierPolynomial();
+    const BezierPolynomial &GetBottomBezierPolynomial();
+    ///@}
+
     /**
      * @name Getters for the current parameters
      */
@@ -302,7 +313,11 @@ public:
     const ArrayOfCurveSpannedElements *GetSpannedElements() { return &m_spannedElements; }
 
 private:
-    //
+    /**
+     * Calculate the top and bottom beziers if the curve parameters or its position changed
+     */
+    void UpdateThickBezier();
+
 public:
     //
 private:
@@ -321,6 +336,18 @@ private:
 
     /** The cached min or max value (depending on the curvature) */
     int m_cachedMinMaxY;
+
+    /**
+     * @name The cached top and bottom beziers of the thick curve with their polynomials.
+     * The drawingY for which they were calculated is VRV_UNSET when they need to be calculated.
+     */
+    ///@{
+    int m_cachedThickBezierY;
+    Point m_topBezier[4];
+    Point m_bottomBezier[4];
+    BezierPolynomial m_topBezierPolynomial;
+    BezierPolynomial m_bottomBezierPolynomial;
+    ///@}
 };
 
 //----------------------------------------------------------------------------
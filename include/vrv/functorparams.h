@@ -806,6 +806,9 @@ public:
  * member 2: a pointer to the current page
  * member 3: the cummulated shift (m_drawingYRel of the first system of the current page)
  * member 4: the page height
+ * member 5: the heights of the page header and footer (first page and other pages)
+ * member 6: the y position of the current system in the content page
+ * member 7: the system margin
  **/
 
 class CastOffPagesParams : public FunctorParams {
@@ -821,6 +824,8 @@ public:
         m_pgFootHeight = 0;
         m_pgHead2Height = 0;
         m_pgFoot2Height = 0;
+        m_contentYRel = 0;
+        m_systemMargin = 0;
     }
     Page *m_contentPage;
     Doc *m_doc;
@@ -831,6 +836,8 @@ public:
     int m_pgFootHeight;
     int m_pgHead2Height;
     int m_pgFoot2Height;
+    int m_contentYRel;
+    int m_systemMargin;
 };
 
 //----------------------------------------------------------------------------
@@ -1446,15 +1453,16 @@ public:
 //----------------------------------------------------------------------------
 
 /**
- * member 0: ArrayOfInterfaceUuidPairs holds the interface / uuid pairs to match
- * member 1: bool* fillList for indicating whether the pairs have to be stacked or not
+ * member 0: MapOfUuidLinkingInterfaces holds the interfaces waiting for their @next target (by uuid)
+ * member 1: MapOfUuidLinkingInterfaces holds the interfaces waiting for their @sameas target (by uuid)
+ * member 2: bool* fillList for indicating whether the interfaces have to be stacked or matched
  **/
 
 class PrepareLinkingParams : public FunctorParams {
 public:
     PrepareLinkingParams() { m_fillList = true; }
-    ArrayOfLinkingInterfaceUuidPairs m_nextUuidPairs;
-    ArrayOfLinkingInterfaceUuidPairs m_sameasUuidPairs;
+    MapOfUuidLinkingInterfaces m_nextInterfaces;
+    MapOfUuidLinkingInterfaces m_sameasInterfaces;
     bool m_fillList;
 };
 
@@ -1463,14 +1471,14 @@ public:
 //----------------------------------------------------------------------------
 
 /**
- * member 0: ArrayOfInterfaceUuidPairs holds the interface / uuid pairs to match
- * member 1: bool* fillList for indicating whether the pairs have to be stacked or not
+ * member 0: MapOfUuidPlistInterfaces holds the interfaces waiting for a @plist target (by uuid)
+ * member 1: bool* fillList for indicating whether the interfaces have to be stacked or matched
  **/
 
 class PreparePlistParams : public FunctorParams {
 public:
     PreparePlistParams() { m_fillList = true; }
-    ArrayOfPlistInterfaceUuidPairs m_interfaceUuidPairs;
+    MapOfUuidPlistInterfaces m_interfaces;
     bool m_fillList;
 };
 
@@ -1538,13 +1546,13 @@ public:
 //----------------------------------------------------------------------------
 
 /**
- * member 0: std::vector< Object*>* that holds the current elements to match
+ * member 0: MapOfUuidPointingInterfaces holds the elements waiting for their @startid target (by uuid)
  **/
 
 class PrepareTimePointingParams : public FunctorParams {
 public:
     PrepareTimePointingParams() {}
-    ArrayOfPointingInterClassIdPairs m_timePointingInterfaces;
+    MapOfUuidPointingInterfaces m_timePointingInterfaces;
 };
 
 //----------------------------------------------------------------------------
@@ -1552,14 +1560,14 @@ public:
 //----------------------------------------------------------------------------
 
 /**
- * member 0: std::vector< Object*>* that holds the current elements to match
- * member 1: bool* fillList for indicating whether the elements have to be stacked or not
+ * member 0: MapOfUuidSpanningInterObjectPairs holds the elements waiting for their @startid or @endid target (by uuid)
+ * member 1: bool* fillList for indicating whether the elements have to be stacked or matched
  **/
 
 class PrepareTimeSpanningParams : public FunctorParams {
 public:
     PrepareTimeSpanningParams() { m_fillList = true; }
-    ArrayOfSpanningInterClassIdPairs m_timeSpanningInterfaces;
+    MapOfUuidSpanningInterObjectPairs m_timeSpanningInterfaces;
     bool m_fillList;
 };
 
@@ -10,6 +10,7 @@
 
 #include <algorithm>
 #include <string>
+#include <vector>
 
 //----------------------------------------------------------------------------
 
@@ -18,6 +19,17 @@
 
 namespace vrv {
 
+/**
+ * The outline of a glyph with absolute moves (M), lines (L), cubic curves (C) and closes (Z).
+ * The coordinates are in the units of the <symbol> (with the transformation of the path applied), starting
+ * at the origin of the viewBox.
+ */
+struct GlyphOutline {
+    std::vector<char> m_ops;
+    std::vector<double> m_coords;
+    double m_unitsX, m_unitsY;
+};
+
 /**
  * This class is used for storing a music font glyph.
  * All glyph values are integers. However, for keeping precision as high
@@ -54,7 +66,7 @@ public:
     int GetUnitsPerEm() const { return m_unitsPerEm; }
 
     /** Get the path */
-    std::string GetPath() { return m_path; }
+    std::string GetPath() const { return m_path; }
 
     /** Get the code string */
     std::string GetCodeStr() { return m_codeStr; }
@@ -83,6 +95,11 @@ public:
      */
     const Point *GetAnchor(SMuFLGlyphAnchor anchor);
 
+    /**
+     * Return the outline of the glyph (e.g., for drawing it without SVG), loaded from the file the first time.
+     */
+    const GlyphOutline &GetOutline();
+
 private:
     //
 public:
@@ -103,6 +120,9 @@ private:
     std::string m_codeStr;
     /** A map of the available anchors */
     std::map<SMuFLGlyphAnchor, Point> m_anchors;
+    /** The outline, loaded when first needed */
+    GlyphOutline m_outline;
+    bool m_hasOutline;
 };
 
 } // namespace vrv
@@ -125,6 +125,12 @@ public:
      */
     bool IsOfType(const std::vector<AlignmentType> &types);
 
+    /**
+     * Return true if the alignment comes before an alignment of the type at the time in a HorizontalAligner.
+     * The alignments are ordered by time and then by type.
+     */
+    bool IsBefore(double time, AlignmentType type) const;
+
     /**
      * Retrive the minimum left and maximum right position for the objects in an alignment.
      * Returns (-)VRV_UNSET in nothing for the staff specified.
@@ -385,10 +391,22 @@ protected:
      */
     void AddAlignment(Alignment *alignment, int idx = -1);
 
+    /**
+     * Check that the alignments from idx (and the one before) are still ordered after a change.
+     */
+    void CheckOrder(int idx);
+
 private:
     //
 public:
     //
+protected:
+    /**
+     * A flag indicating that the alignments are ordered by time and type, which is the case unless an
+     * alignment is added after the right barline. SearchAlignmentAtTime uses a binary search when set.
+     */
+    bool m_isOrdered;
+
 private:
 };
 
@@ -8,6 +8,8 @@
 #ifndef __VRV_IOMEI_H__
 #define __VRV_IOMEI_H__
 
+#include <map>
+#include <set>
 #include <sstream>
 
 //----------------------------------------------------------------------------
@@ -634,6 +636,25 @@ private:
      */
     bool IsEditorialElementName(std::string elementName);
 
+    /**
+     * @name Methods for partial loading with a measure range and a staff selection.
+     * Skipped measures are scanned for clef, key signature and meter signature changes, which are
+     * passed on with scoreDef elements inserted before the first loaded measure.
+     * See options --measure-range and --staff-selection
+     */
+    ///@{
+    void InitSelection();
+    bool IsMeasureSelected(pugi::xml_node measure);
+    bool IsMeasureRangeBoundary(pugi::xml_node measure, const std::string &boundary);
+    bool IsStaffSelected(pugi::xml_node element);
+    void SkipScoreDef(pugi::xml_node scoreDef);
+    void SkipMeasureContent(pugi::xml_node parentNode, int staffN);
+    void SkipStaffDefChange(int staffN, pugi::xml_node element, const std::string &prefix,
+        const std::vector<std::string> &attributes);
+    void FlushSkippedStaffDefChanges();
+    bool ReadSkippedScoreDefs(Object *parent);
+    ///@}
+
     /**
      * Read score-based MEI.
      * The data is read into an object, which is then converted to page-based MEI.
@@ -711,6 +732,24 @@ private:
      * This is not the case when selecting a mDiv that is not the first one with a score in the tree.
      */
     bool m_useScoreDefForDoc;
+
+    /**
+     * @name Members for the measure range and staff selection.
+     * m_skippedScoreDefs holds the <scoreDef> elements to be read before the first selected measure, either from the
+     * input or created in m_skippedScoreDefDoc from the changes collected in m_skippedStaffDefChanges.
+     */
+    ///@{
+    bool m_hasMeasureRange;
+    bool m_measureRangeStarted;
+    bool m_measureRangeEnded;
+    int m_measureCount;
+    std::string m_measureRangeStart;
+    std::string m_measureRangeEnd;
+    std::set<int> m_selectedStaves;
+    std::map<int, std::map<std::string, std::string> > m_skippedStaffDefChanges;
+    std::vector<pugi::xml_node> m_skippedScoreDefs;
+    pugi::xml_document m_skippedScoreDefDoc;
+    ///@}
 };
 
 } // namespace vrv
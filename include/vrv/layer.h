@@ -74,7 +74,7 @@ public:
 
     /**
      * Get the current clef for the test element.
-     * Goes back on the layer until a clef is found.
+     * Looks for the last clef before it in the layer using the clef table of the layer.
      * This is used when inserting a note by passing a y position because we need
      * to know the clef in order to get the pitch.
      */
@@ -82,7 +82,7 @@ public:
 
     /**
      * Get the current clef based on facsimile for the test element.
-     * This goes back by facsimile position until a clef is found.
+     * This goes back by facsimile position until a clef is found, possibly in a previous layer.
      * Returns NULL if a clef cannot be found via this method.
      */
     Clef *GetClefFacs(LayerElement *test);
@@ -215,6 +215,12 @@ public:
      */
     // virtual int ResetDrawing(FunctorParams *);
 
+protected:
+    /**
+     * The flat list is not filtered but this builds the clef table.
+     */
+    virtual void FilterList(ArrayOfObjects *childList);
+
 private:
     //
 public:
@@ -238,6 +244,12 @@ private:
     Mensur *m_cautionStaffDefMensur;
     MeterSig *m_cautionStaffDefMeterSig;
     bool m_drawCautionKeySigCancel;
+
+    /**
+     * The clef applying to each element of the list (NULL if none in the layer before it).
+     * Built in Layer::FilterList every time the list is reset.
+     */
+    MapOfObjectClefs m_clefTable;
 };
 
 } // namespace vrv
@@ -166,6 +166,25 @@ public:
      */
     int GetDrawingOverflow();
 
+    /**
+     * @name Store and get the width and the overflow used when casting off the systems.
+     * They are stored when the measure is laid out in the content system and kept afterwards, so the
+     * systems can be cast off again without laying out the measure (see Doc::RecastOffDoc).
+     */
+    ///@{
+    void StoreCastOffValues();
+    int GetCastOffWidth() const { return m_castOffWidth; }
+    int GetCastOffOverflow() const { return m_castOffOverflow; }
+    ///@}
+
+    /**
+     * @name Set and get the flag indicating that the measure has been edited since the last layout
+     */
+    ///@{
+    void SetLayoutDirty(bool isLayoutDirty) { m_isLayoutDirty = isLayoutDirty; }
+    bool IsLayoutDirty() const { return m_isLayoutDirty; }
+    ///@}
+
     /**
      * @name Setter and getter of the drawing scoreDef
      */
@@ -354,11 +373,6 @@ public:
      */
     virtual int PrepareTimePointingEnd(FunctorParams *functorParams);
 
-    /**
-     * See Object::PrepareTimeSpanningEnd
-     */
-    virtual int PrepareTimeSpanningEnd(FunctorParams *functorParams);
-
     /**
      * See Object::PrepareBoundaries
      */
@@ -449,6 +463,19 @@ private:
      */
     bool m_hasAlignmentRefWithMultipleLayers;
 
+    /**
+     * @name The width and the overflow stored when casting off the systems
+     */
+    ///@{
+    int m_castOffWidth;
+    int m_castOffOverflow;
+    ///@}
+
+    /**
+     * A flag indicating that the measure has to be laid out again
+     */
+    bool m_isLayoutDirty;
+
     /**
      * Start time state variables.
      */
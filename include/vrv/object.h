@@ -221,7 +221,7 @@ public:
      */
     virtual void CloneReset();
 
-    std::string GetUuid() const { return m_uuid; }
+    const std::string &GetUuid() const { return m_uuid; }
     void SetUuid(std::string uuid);
     void SwapUuid(Object *other);
     void ResetUuid();
@@ -928,12 +928,11 @@ public:
 
     /**
      * Match start and end for TimeSpanningInterface elements (such as tie or slur).
-     * If fillList is set to false, only the remaining elements will be matched.
-     * This is used when processing a second time in the other direction
+     * If fillList is set to false, the elements are not stacked anymore but matched by uuid.
+     * This is used when processing a second time once all the elements are stacked.
      */
     ///@{
     virtual int PrepareTimeSpanning(FunctorParams *) { return FUNCTOR_CONTINUE; }
-    virtual int PrepareTimeSpanningEnd(FunctorParams *) { return FUNCTOR_CONTINUE; }
     ///@}
 
     /**
@@ -1172,6 +1171,12 @@ private:
     ClassId m_iteratorElementType;
     ///@}
 
+    /**
+     * The position of the last child found by Object::GetChildIndex.
+     * Used as a starting point for the next search.
+     */
+    int m_childIdxHint;
+
     /**
      * A vector for storing the list of AttClassId (MEI att classes) implemented.
      */
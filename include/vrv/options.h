@@ -454,6 +454,7 @@ public:
 
     OptionBool m_adjustPageHeight;
     OptionIntMap m_breaks;
+    OptionDbl m_detailThreshold;
     OptionBool m_evenNoteSpacing;
     OptionBool m_humType;
     OptionBool m_justifyIncludeLastPage;
@@ -474,7 +475,13 @@ public:
     OptionInt m_pageMarginRight;
     OptionInt m_pageMarginTop;
     OptionInt m_pageWidth;
+    OptionInt m_pngWidth;
+    OptionBool m_progressiveLayout;
     OptionBool m_svgBoundingBoxes;
+    OptionBool m_svgCompact;
+    OptionString m_svgGlyphSprite;
+    OptionBool m_svgRemoveEmptyGroups;
+    OptionBool m_svgRemoveXlink;
     OptionBool m_svgViewBox;
     OptionInt m_unit;
     OptionBool m_useFacsimile;
@@ -527,6 +534,8 @@ public:
     OptionArray m_appXPathQuery;
     OptionArray m_choiceXPathQuery;
     OptionString m_mdivXPathQuery;
+    OptionString m_measureRange;
+    OptionArray m_staffSelection;
     OptionArray m_substXPathQuery;
 
     /**
@@ -88,6 +88,11 @@ public:
      */
     void LayOut(bool force = false);
 
+    /**
+     * Return true if the page has been laid out with Page::LayOut (and possibly justified).
+     */
+    bool IsLayoutDone() const { return m_layoutDone; }
+
     /**
      * Do the layout for a transcription page (with layout information).
      * This only calculates positioning or layer element parts using provided layout of parents.
@@ -0,0 +1,301 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        pdfdevicecontext.h
+// Author:      agent
+// Created:     19/10/2026
+// Copyright (c) Authors and others. All rights reserved.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef __VRV_PDF_DC_H__
+#define __VRV_PDF_DC_H__
+
+#include <map>
+#include <ostream>
+#include <set>
+#include <string>
+#include <vector>
+
+//----------------------------------------------------------------------------
+
+#include "devicecontext.h"
+
+namespace vrv {
+
+//----------------------------------------------------------------------------
+// PdfDeviceContext
+//----------------------------------------------------------------------------
+
+/**
+ * This class draws the pages into a single PDF document written to a stream.
+ * Each page is written as soon as it is drawn, so only the content of the current page is kept in memory.
+ *
+ * The glyphs of the music font are written once as form XObjects from their outlines and are shared by all the
+ * pages, as are the fonts and the other resources (which are written at the end of the document).
+ * The text is written with the standard Times fonts (WinAnsi encoding, other characters being replaced by '?'),
+ * and the VerovioText glyphs with the glyph XObjects.
+ * The page size is the one of the SVG in mm (i.e., the page units in tenths of mm at the scale).
+ *
+ * The document is complete only once EndDocument has been called.
+ */
+class PdfDeviceContext : public DeviceContext {
+public:
+    /**
+     * @name Constructors, destructors, and other standard methods
+     */
+    ///@{
+    PdfDeviceContext(std::ostream &output);
+    virtual ~PdfDeviceContext();
+    virtual ClassId GetClassId() const { return PDF_DEVICE_CONTEXT; }
+    ///@}
+
+    /**
+     * @name Setters
+     */
+    ///@{
+    virtual void SetBackground(int colour, int style = AxSOLID){};
+    virtual void SetBackgroundImage(void *image, double opacity = 1.0){};
+    virtual void SetBackgroundMode(int mode){};
+    virtual void SetTextForeground(int colour){};
+    virtual void SetTextBackground(int colour){};
+    virtual void SetLogicalOrigin(int x, int y);
+    ///@}
+
+    /**
+     * @name Getters
+     */
+    ///@{
+    virtual Point GetLogicalOrigin();
+    ///@}
+
+    /**
+     * @name Drawing methods
+     */
+    ///@{
+    virtual void DrawComplexBezierPath(Point bezier1[4], Point bezier2[4]);
+    virtual void DrawCircle(int x, int y, int radius);
+    virtual void DrawEllipse(int x, int y, int width, int height);
+    virtual void DrawEllipticArc(int x, int y, int width, int height, double start, double end);
+    virtual void DrawLine(int x1, int y1, int x2, int y2);
+    virtual void DrawPolygon(int n, Point points[], int xOffset, int yOffset, int fillStyle = AxODDEVEN_RULE);
+    virtual void DrawRectangle(int x, int y, int width, int height);
+    virtual void DrawRotatedText(const std::string &text, int x, int y, double angle){};
+    virtual void DrawRoundedRectangle(int x, int y, int width, int height, double radius);
+    virtual void DrawText(
+        const std::string &text, const std::wstring wtext = L"", int x = VRV_UNSET, int y = VRV_UNSET);
+    virtual void DrawMusicText(const std::wstring &text, int x, int y, bool setSmuflGlyph = false);
+    virtual void DrawSpline(int n, Point points[]){};
+    virtual void DrawSvgShape(int x, int y, int width, int height, pugi::xml_node svg){};
+    virtual void DrawBackgroundImage(int x = 0, int y = 0){};
+    ///@}
+
+    /**
+     * @name Method for starting and ending a text
+     */
+    ///@{
+    virtual void StartText(int x, int y, data_HORIZONTALALIGNMENT alignment = HORIZONTALALIGNMENT_left);
+    virtual void EndText();
+    ///@}
+
+    /**
+     * @name Move a text to the specified position, for example when starting a new line.
+     */
+    ///@{
+    virtual void MoveTextTo(int x, int y, data_HORIZONTALALIGNMENT alignment);
+    virtual void MoveTextVerticallyTo(int y);
+    ///@}
+
+    /**
+     * @name Method for starting and ending a graphic
+     */
+    ///@{
+    virtual void StartGraphic(Object *object, std::string gClass, std::string gId, bool prepend = false);
+    virtual void EndGraphic(Object *object, View *view);
+    ///@}
+
+    /**
+     * @name Method for starting and ending a graphic custom
+     */
+    ///@{
+    virtual void StartCustomGraphic(std::string name, std::string gClass = "", std::string gId = "");
+    virtual void EndCustomGraphic();
+    ///@}
+
+    /**
+     * @name Methods for re-starting and ending a graphic for objects drawn in separate steps
+     */
+    ///@{
+    virtual void ResumeGraphic(Object *object, std::string gId);
+    virtual void EndResumedGraphic(Object *object, View *view);
+    ///@}
+
+    /**
+     * @name Method for starting and ending a text (<tspan>) text graphic
+     */
+    ///@{
+    virtual void StartTextGraphic(Object *object, std::string gClass, std::string gId);
+    virtual void EndTextGraphic(Object *object, View *view);
+    ///@}
+
+    /**
+     * @name Method for rotating a graphic (clockwise).
+     */
+    ///@{
+    virtual void RotateGraphic(Point const &orig, double angle);
+    ///@}
+
+    /**
+     * @name Method for starting and ending page
+     */
+    ///@{
+    virtual void StartPage();
+    virtual void EndPage();
+    ///@}
+
+    /**
+     * Write the shared resources, the page tree and the cross-reference table.
+     * Nothing can be drawn afterwards. Return false if the stream is in a failed state.
+     */
+    bool EndDocument();
+
+    /**
+     * Setting the facsimile flag (false by default), for which the page is not scaled
+     */
+    void SetFacsimile(bool facsimile) { m_facsimile = facsimile; }
+
+    /**
+     * Return the number of pages written so far
+     */
+    int GetPageCount() const { return (int)m_pageObjects.size(); }
+
+private:
+    /**
+     * The state of a group: the current colour, the visibility and the transformation (for rotated groups).
+     * The transformation is the affine matrix (a, b, c, d, e, f) applied to the logical coordinates.
+     */
+    struct GroupState {
+        int m_colour;
+        bool m_visible;
+        double m_transform[6];
+    };
+
+    /**
+     * A text run waiting for the end of the line to be aligned
+     */
+    struct TextRun {
+        std::wstring m_text;
+        FontInfo m_font;
+        int m_colour;
+        bool m_visible;
+        int m_y;
+    };
+
+    /**
+     * Push a group state (a copy of the current one) and apply the colour and the visibility of the object
+     */
+    void PushGroup(Object *object, const std::string &gId);
+
+    /**
+     * Pop the current group state (the state of the page is never popped)
+     */
+    void PopGroup();
+
+    /**
+     * @name Methods for writing the objects of the document.
+     * The object numbers are reserved with AddObject and the objects can be written in any order.
+     * The streams are compressed.
+     */
+    ///@{
+    void Write(const std::string &data);
+    int AddObject();
+    void WriteObject(int number, const std::string &dictionary);
+    void WriteStream(int number, const std::string &entries, const std::string &stream);
+    ///@}
+
+    /**
+     * @name Methods for writing the content of the current page
+     */
+    ///@{
+    void AppendNumber(double value, int decimals = 2);
+    void AppendPoint(double x, double y);
+    void AppendMatrix(const double matrix[6]);
+    void AppendArc(double cx, double cy, double rx, double ry, double start, double sweep, bool moveTo);
+    ///@}
+
+    /**
+     * @name Methods for setting the graphics state of the current page (written only when changed).
+     * The colours AxNONE are the colour of the group.
+     */
+    ///@{
+    void SetFill(int colour, float opacity);
+    void SetStroke(int colour, float opacity, double width, int dashLength, bool round);
+    ///@}
+
+    /**
+     * Draw a glyph with its XObject, with its origin at x, y and the font size
+     */
+    void DrawGlyph(Glyph *glyph, int x, int y, int pointSize);
+
+    /**
+     * Return the object number of the XObject of the glyph, written the first time
+     */
+    int GetGlyphObject(Glyph *glyph);
+
+    /**
+     * Return the object number of the standard font for the font info, written the first time
+     */
+    int GetFontObject(FontInfo &font);
+
+    /**
+     * Draw the text runs of the current line with the alignment of the text
+     */
+    void FlushTextLine();
+
+public:
+    //
+private:
+    /** The output stream and the number of bytes written so far */
+    std::ostream &m_output;
+    size_t m_position;
+    /** The offsets of the objects (the index being the object number) */
+    std::vector<size_t> m_offsets;
+    /** The page objects */
+    std::vector<int> m_pageObjects;
+    /** The XObjects of the glyphs (by glyph file) and the fonts (by base font name) */
+    ///@{
+    std::map<std::string, int> m_glyphObjects;
+    std::map<std::string, int> m_fontObjects;
+    ///@}
+    /** The fill and stroke alpha values (0-255) used for the graphics state resources */
+    std::set<int> m_alphas;
+    /** The content of the current page and its size in points */
+    ///@{
+    std::string m_content;
+    double m_pageWidth, m_pageHeight;
+    ///@}
+    /** The current graphics state of the page */
+    ///@{
+    int m_fillColour, m_strokeColour;
+    int m_fillAlpha, m_strokeAlpha;
+    double m_lineWidth;
+    int m_dashLength;
+    int m_lineRound;
+    ///@}
+    /** The group states and the states of the groups with an id (for resuming them) */
+    ///@{
+    std::vector<GroupState> m_groups;
+    std::map<std::string, GroupState> m_groupStates;
+    ///@}
+    /** The text runs of the current line, the position and the alignment */
+    ///@{
+    std::vector<TextRun> m_textRuns;
+    int m_textX, m_textY;
+    data_HORIZONTALALIGNMENT m_textAlignment;
+    ///@}
+    /** The origin */
+    int m_originX, m_originY;
+    bool m_facsimile;
+    bool m_ended;
+};
+
+} // namespace vrv
+
+#endif // __VRV_PDF_DC_H__
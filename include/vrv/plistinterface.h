@@ -96,13 +96,13 @@ protected:
 private:
     /**
      * An array of resolved references.
-     * Filled in InterfacePreparePlist (backward).
+     * Filled in Object::PreparePlist when matching the uuids.
      */
     ArrayOfObjects m_references;
 
     /**
      * An array of parsed any uris stored as uuids.
-     * Filled in InterfacePreparePlist (backward and forward).
+     * Filled in InterfacePreparePlist.
      */
     std::vector<std::string> m_uuids;
 };
@@ -0,0 +1,277 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        rasterdevicecontext.h
+// Author:      agent
+// Created:     19/10/2026
+// Copyright (c) Authors and others. All rights reserved.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef __VRV_RASTER_DC_H__
+#define __VRV_RASTER_DC_H__
+
+#include <map>
+#include <string>
+#include <vector>
+
+//----------------------------------------------------------------------------
+
+#include "devicecontext.h"
+
+namespace vrv {
+
+//----------------------------------------------------------------------------
+// RasterDeviceContext
+//----------------------------------------------------------------------------
+
+/**
+ * This class draws a page into an RGB image with an anti-aliased scanline rasteriser and writes it as PNG.
+ * It is designed for thumbnails and previews without an external SVG rasteriser.
+ *
+ * Shapes are filled by accumulating the signed area covered by their edges in each pixel (non-zero winding),
+ * and lines are stroked as polygons. The glyphs are filled with their outlines from the SVG path data of the
+ * font loaded by the Resources. Since there are no outlines for the text fonts, the text (other than the
+ * VerovioText glyphs) is greeked with the bounding box of each character.
+ */
+class RasterDeviceContext : public DeviceContext {
+public:
+    /**
+     * @name Constructors, destructors, and other standard methods
+     * The width is the width of the image in pixels (0 for the width of the page at the user scale).
+     */
+    ///@{
+    RasterDeviceContext(int pixelWidth = 0);
+    virtual ~RasterDeviceContext();
+    virtual ClassId GetClassId() const { return RASTER_DEVICE_CONTEXT; }
+    ///@}
+
+    /**
+     * @name Setters
+     */
+    ///@{
+    virtual void SetBackground(int colour, int style = AxSOLID);
+    virtual void SetBackgroundImage(void *image, double opacity = 1.0){};
+    virtual void SetBackgroundMode(int mode){};
+    virtual void SetTextForeground(int colour){};
+    virtual void SetTextBackground(int colour){};
+    virtual void SetLogicalOrigin(int x, int y);
+    ///@}
+
+    /**
+     * @name Getters
+     */
+    ///@{
+    virtual Point GetLogicalOrigin();
+    ///@}
+
+    /**
+     * @name Drawing methods
+     */
+    ///@{
+    virtual void DrawComplexBezierPath(Point bezier1[4], Point bezier2[4]);
+    virtual void DrawCircle(int x, int y, int radius);
+    virtual void DrawEllipse(int x, int y, int width, int height);
+    virtual void DrawEllipticArc(int x, int y, int width, int height, double start, double end);
+    virtual void DrawLine(int x1, int y1, int x2, int y2);
+    virtual void DrawPolygon(int n, Point points[], int xOffset, int yOffset, int fillStyle = AxODDEVEN_RULE);
+    virtual void DrawRectangle(int x, int y, int width, int height);
+    virtual void DrawRotatedText(const std::string &text, int x, int y, double angle){};
+    virtual void DrawRoundedRectangle(int x, int y, int width, int height, double radius);
+    virtual void DrawText(
+        const std::string &text, const std::wstring wtext = L"", int x = VRV_UNSET, int y = VRV_UNSET);
+    virtual void DrawMusicText(const std::wstring &text, int x, int y, bool setSmuflGlyph = false);
+    virtual void DrawSpline(int n, Point points[]){};
+    virtual void DrawSvgShape(int x, int y, int width, int height, pugi::xml_node svg){};
+    virtual void DrawBackgroundImage(int x = 0, int y = 0){};
+    ///@}
+
+    /**
+     * @name Method for starting and ending a text
+     */
+    ///@{
+    virtual void StartText(int x, int y, data_HORIZONTALALIGNMENT alignment = HORIZONTALALIGNMENT_left);
+    virtual void EndText();
+    ///@}
+
+    /**
+     * @name Move a text to the specified position, for example when starting a new line.
+     */
+    ///@{
+    virtual void MoveTextTo(int x, int y, data_HORIZONTALALIGNMENT alignment);
+    virtual void MoveTextVerticallyTo(int y);
+    ///@}
+
+    /**
+     * @name Method for starting and ending a graphic
+     */
+    ///@{
+    virtual void StartGraphic(Object *object, std::string gClass, std::string gId, bool prepend = false);
+    virtual void EndGraphic(Object *object, View *view);
+    ///@}
+
+    /**
+     * @name Method for starting and ending a graphic custom
+     */
+    ///@{
+    virtual void StartCustomGraphic(std::string name, std::string gClass = "", std::string gId = "");
+    virtual void EndCustomGraphic();
+    ///@}
+
+    /**
+     * @name Methods for re-starting and ending a graphic for objects drawn in separate steps
+     */
+    ///@{
+    virtual void ResumeGraphic(Object *object, std::string gId);
+    virtual void EndResumedGraphic(Object *object, View *view);
+    ///@}
+
+    /**
+     * @name Method for starting and ending a text (<tspan>) text graphic
+     */
+    ///@{
+    virtual void StartTextGraphic(Object *object, std::string gClass, std::string gId);
+    virtual void EndTextGraphic(Object *object, View *view);
+    ///@}
+
+    /**
+     * @name Method for rotating a graphic (clockwise).
+     */
+    ///@{
+    virtual void RotateGraphic(Point const &orig, double angle);
+    ///@}
+
+    /**
+     * @name Method for starting and ending page
+     */
+    ///@{
+    virtual void StartPage();
+    virtual void EndPage(){};
+    ///@}
+
+    /**
+     * Setting the facsimile flag (false by default), for which the page is not scaled
+     */
+    void SetFacsimile(bool facsimile) { m_facsimile = facsimile; }
+
+    /**
+     * @name Getters for the image size in pixels
+     */
+    ///@{
+    int GetPixelWidth() const { return m_pixelWidth; }
+    int GetPixelHeight() const { return m_pixelHeight; }
+    ///@}
+
+    /**
+     * Return the image encoded as PNG (8-bit RGB).
+     * The string is empty if the image was too large (see RASTER_MAX_IMAGE_SIZE) and no page was drawn.
+     */
+    std::string GetPNG() const;
+
+private:
+    /**
+     * The state of a group: the current colour, the visibility and the transformation (for rotated groups).
+     * The transformation is the affine matrix (a, b, c, d, e, f) applied to the logical coordinates.
+     */
+    struct GroupState {
+        int m_colour;
+        bool m_visible;
+        double m_transform[6];
+    };
+
+    /**
+     * A text run waiting for the end of the line to be aligned
+     */
+    struct TextRun {
+        std::wstring m_text;
+        FontInfo m_font;
+        int m_colour;
+        bool m_visible;
+        int m_y;
+    };
+
+    /**
+     * Push a group state (a copy of the current one) and apply the colour and the visibility of the object
+     */
+    void PushGroup(Object *object, const std::string &gId);
+
+    /**
+     * Pop the current group state (the state of the page is never popped)
+     */
+    void PopGroup();
+
+    /**
+     * @name Methods for building a path in logical coordinates.
+     * The coordinates are transformed and scaled to pixels, and the curves are flattened.
+     * The contours are closed implicitly when filling.
+     */
+    ///@{
+    void MoveTo(double x, double y);
+    void LineTo(double x, double y);
+    void CurveTo(double x1, double y1, double x2, double y2, double x3, double y3);
+    void ClosePath();
+    void AddStroke(double x1, double y1, double x2, double y2, double width);
+    void AddEllipse(double x, double y, double width, double height);
+    ///@}
+
+    /**
+     * Fill the path with the colour (AxNONE for the colour of the group) and the opacity, and clear it
+     */
+    void FillPath(int colour, float opacity);
+
+    /**
+     * @name Methods for the rasteriser
+     */
+    ///@{
+    void AddEdge(double x0, double y0, double x1, double y1);
+    void AccumulateEdge(double x0, double y0, double x1, double y1, int width, int height);
+    void AccumulateLine(double x0, double y0, double x1, double y1, int width, int height);
+    ///@}
+
+    /**
+     * Fill the outline of a glyph with its origin at x, y and the size of the current font
+     */
+    void FillGlyph(Glyph *glyph, int x, int y, int pointSize, int colour);
+
+    /**
+     * Draw the text runs of the current line with the alignment of the text
+     */
+    void FlushTextLine();
+
+public:
+    //
+private:
+    /** The image size and the scale from the logical coordinates to pixels */
+    int m_pixelWidth, m_pixelHeight;
+    double m_scale;
+    /** The RGB pixels */
+    std::vector<unsigned char> m_image;
+    int m_backgroundColour;
+    /** The coverage buffer of the rasteriser */
+    std::vector<float> m_coverage;
+    /** The edges of the current path in pixels (x0, y0, x1, y1) and their bounding box */
+    ///@{
+    std::vector<double> m_edges;
+    double m_edgesMinX, m_edgesMinY, m_edgesMaxX, m_edgesMaxY;
+    ///@}
+    /** The start and the current point of the current contour in pixels */
+    ///@{
+    bool m_hasContour;
+    double m_startX, m_startY, m_currentX, m_currentY;
+    ///@}
+    /** The group states and the states of the groups with an id (for resuming them) */
+    ///@{
+    std::vector<GroupState> m_groups;
+    std::map<std::string, GroupState> m_groupStates;
+    ///@}
+    /** The text runs of the current line, the position and the alignment */
+    ///@{
+    std::vector<TextRun> m_textRuns;
+    int m_textX, m_textY;
+    data_HORIZONTALALIGNMENT m_textAlignment;
+    ///@}
+    /** The origin */
+    int m_originX, m_originY;
+    bool m_facsimile;
+};
+
+} // namespace vrv
+
+#endif // __VRV_RASTER_DC_H__
@@ -0,0 +1,136 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        rendercache.h
+// Author:      agent
+// Created:     18/10/2026
+// Copyright (c) Authors and others. All rights reserved.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef __VRV_RENDERCACHE_H__
+#define __VRV_RENDERCACHE_H__
+
+#include <list>
+#include <map>
+#include <string>
+
+//----------------------------------------------------------------------------
+
+namespace vrv {
+
+//----------------------------------------------------------------------------
+// RenderCache
+//----------------------------------------------------------------------------
+
+/**
+ * This class stores rendered output (SVG, MIDI, timemap) identified by a content key.
+ * The entries are kept either in memory or as files in a directory. In both cases the
+ * least recently used entries are evicted when the total size exceeds the maximum size.
+ * With a directory, only the entries known by the cache (written or read by it) are
+ * evicted. Since the key is a hash, each entry also stores a source description (e.g.,
+ * the options and the length of the data) that has to match for the entry to be used.
+ */
+class RenderCache {
+public:
+    /**
+     * @name Constructors and destructors
+     * An empty directory means that the entries are kept in memory.
+     * A maximum size of 0 means no limit.
+     */
+    ///@{
+    RenderCache(const std::string &directory, int maxSize, bool verify);
+    virtual ~RenderCache();
+    ///@}
+
+    /**
+     * Look for an entry and copy its content into content.
+     * Return false if the entry does not exist, if its source is not the same (i.e., with a hash collision), or if it
+     * is invalid (when verifying).
+     */
+    bool Get(const std::string &key, const std::string &source, std::string &content);
+
+    /**
+     * Add or replace an entry.
+     * The entry is not added if it is larger than the maximum size.
+     */
+    void Put(const std::string &key, const std::string &source, const std::string &content);
+
+    /**
+     * Remove all the entries and reset the counters.
+     */
+    void Clear();
+
+    /**
+     * @name Getters for the counters
+     */
+    ///@{
+    int GetHits() const { return m_hits; }
+    int GetMisses() const { return m_misses; }
+    int GetEvictions() const { return m_evictions; }
+    int GetInvalids() const { return m_invalids; }
+    int GetCollisions() const { return m_collisions; }
+    int GetEntryCount() const { return (int)m_entries.size(); }
+    int GetSize() const { return m_size; }
+    ///@}
+
+    /**
+     * Return a 64-bit FNV-1a hash of the data as a hexadecimal string.
+     */
+    static std::string Hash(const std::string &data);
+
+private:
+    /**
+     * Move the entry to the front of the LRU list.
+     */
+    void Touch(const std::string &key);
+
+    /**
+     * Remove an entry (and its file when using a directory).
+     */
+    void Remove(const std::string &key);
+
+    /**
+     * Evict the least recently used entries until the size is below the maximum.
+     */
+    void Evict();
+
+    /**
+     * @name Read and write the files when using a directory
+     */
+    ///@{
+    std::string GetFilename(const std::string &key) const;
+    bool ReadFile(const std::string &key, std::string &source, std::string &content, std::string &checksum);
+    bool WriteFile(
+        const std::string &key, const std::string &source, const std::string &content, const std::string &checksum);
+    ///@}
+
+public:
+    //
+private:
+    struct Entry {
+        std::string m_source;
+        std::string m_content;
+        std::string m_checksum;
+        int m_size;
+        std::list<std::string>::iterator m_lru;
+    };
+
+    std::string m_directory;
+    int m_maxSize;
+    bool m_verify;
+
+    /** The entries - content is empty when using a directory */
+    std::map<std::string, Entry> m_entries;
+    /** The keys from the most recently to the least recently used */
+    std::list<std::string> m_lru;
+    /** The total size of the entries */
+    int m_size;
+
+    int m_hits;
+    int m_misses;
+    int m_evictions;
+    int m_invalids;
+    int m_collisions;
+};
+
+} // namespace vrv
+
+#endif
@@ -10,9 +10,9 @@
 
 #include <fstream>
 #include <iostream>
-#include <list>
 #include <sstream>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 //----------------------------------------------------------------------------
@@ -31,6 +31,10 @@ namespace vrv {
  * This class implements a drawing context for generating SVG files.
  * The music font is embedded by incorporating ./data/[fontname]/[glyph].xml glyphs within
  * the SVG file.
+ * The SVG is written to a buffer while drawing. Only the elements that can still be changed (the open ones
+ * and the ones that can be resumed within the current system) are kept in memory, and the drawn elements
+ * (path, use, etc.) are serialized immediately. The root element, the <desc> and the <defs> are added when
+ * committing.
  */
 class SvgDeviceContext : public DeviceContext {
 public:
@@ -181,6 +185,45 @@ public:
      */
     void SetSvgViewBox(bool svgViewBox) { m_svgViewBox = svgViewBox; }
 
+    /**
+     * Setting m_svgCompact flag (false by default).
+     * The SVG is written without indentation and with relative path commands. The stroke of the lines and
+     * curves is given by the global style when used.
+     */
+    void SetSvgCompact(bool svgCompact) { m_svgCompact = svgCompact; }
+
+    /**
+     * Setting m_svgRemoveEmptyGroups flag (false by default)
+     */
+    void SetSvgRemoveEmptyGroups(bool svgRemoveEmptyGroups) { m_svgRemoveEmptyGroups = svgRemoveEmptyGroups; }
+
+    /**
+     * Setting m_svgRemoveXlink flag (false by default).
+     * Only the href attribute (SVG 2) is written in <use> elements.
+     */
+    void SetSvgRemoveXlink(bool svgRemoveXlink) { m_svgRemoveXlink = svgRemoveXlink; }
+
+    /**
+     * Setting m_svgRemoveLabels flag (false by default).
+     * The @label attributes are not written as <title> elements (e.g., for low-detail rendering).
+     */
+    void SetSvgRemoveLabels(bool svgRemoveLabels) { m_svgRemoveLabels = svgRemoveLabels; }
+
+    /**
+     * Setting the URL of an external glyph sprite (empty by default).
+     * The <use> elements reference the glyphs in the sprite and no <defs> is written.
+     */
+    void SetGlyphSprite(const std::string &glyphSprite) { m_glyphSprite = glyphSprite; }
+
+    /**
+     * @name Getter and setter for the files of the glyphs used.
+     * Setting them without drawing a page gives a glyph sprite (an empty SVG with the <defs> only).
+     */
+    ///@{
+    const std::vector<std::string> &GetSmuflGlyphs() const { return m_smuflGlyphs; }
+    void SetSmuflGlyphs(const std::vector<std::string> &smuflGlyphs) { m_smuflGlyphs = smuflGlyphs; }
+    ///@}
+
 private:
     /**
      * Copy the content of a file to the output stream.
@@ -211,9 +254,146 @@ private:
 
     void WriteLine(std::string);
 
-    std::string GetColour(int colour);
+    /**
+     * Return the colour as a string.
+     * The predefined colours are taken from a table and other ones are written to m_colour.
+     */
+    const char *GetColour(int colour);
+
+    /**
+     * Position where an element is added within its parent.
+     * Drawn elements are added before the first <g> child (see AppendChild).
+     */
+    enum SvgPosition { SVG_APPEND = 0, SVG_BEFORE_GROUP, SVG_PREPEND };
+
+    /**
+     * An SVG element that has been started and that is not serialized yet.
+     * The children are either elements or already serialized text (which also includes the indentation).
+     * Streamed elements (the root, the definition scale and the page margin) write their content directly to
+     * m_svgBody.
+     */
+    struct SvgNode {
+        SvgNode(const std::string &name, SvgNode *parent, SvgPosition position, bool streamed);
+        ~SvgNode();
+
+        struct Child {
+            std::string m_xml;
+            SvgNode *m_node;
+            bool m_isGroup;
+        };
+
+        std::string m_name;
+        // The id of a <g> that can be resumed (empty otherwise)
+        std::string m_id;
+        // The serialized attributes, each with a leading space
+        std::string m_attributes;
+        std::vector<Child> m_children;
+        SvgNode *m_parent;
+        int m_depth;
+        SvgPosition m_position;
+        // The index of the first <g> child (-1 if none)
+        int m_firstGroup;
+        bool m_streamed;
+        // For streamed nodes, the position of the content and of the first <g> child in m_svgBody
+        size_t m_bodyStart;
+        size_t m_bodyFirstGroup;
+    };
+
+    /**
+     * @name Start and end an element.
+     * Streamed elements are written when started and need to have all their attributes.
+     */
+    ///@{
+    SvgNode *StartNode(const std::string &name, SvgPosition position = SVG_APPEND);
+    void StartStreamedNode(const std::string &name, const std::string &attributes);
+    void EndNode();
+    ///@}
+
+    /**
+     * Add an element with no children (serialized without indentation) to the current element.
+     */
+    void AppendChild(const std::string &xml, SvgPosition position = SVG_BEFORE_GROUP, bool isGroup = false);
+
+    /**
+     * @name Add a child to the current element.
+     * A serialized child (with its indentation) is written directly to m_svgBody when the current element is
+     * streamed.
+     */
+    ///@{
+    void AddSerialized(const std::string &xml, SvgPosition position, bool isGroup = false);
+    void AddNode(SvgNode *node, SvgPosition position);
+    int GetChildIndex(SvgPosition position);
+    void InsertChild(SvgNode::Child &child, int index);
+    ///@}
+
+    /**
+     * @name Serialize an element with no children and add it to the current element.
+     * StartLeaf returns the m_leaf buffer with the indentation and the tag name. EndLeaf closes the tag unless
+     * the content was added.
+     */
+    ///@{
+    std::string &StartLeaf(const char *name);
+    void EndLeaf(bool closeTag = true);
+    ///@}
+
+    /**
+     * Write a serialized element to m_svgBody at the position within the streamed parent
+     */
+    void WriteToBody(SvgNode *parent, const std::string &xml, SvgPosition position, bool isGroup);
+
+    /**
+     * Serialize a node and its children to the output string
+     */
+    void WriteNode(std::string &output, SvgNode *node);
+
+    /**
+     * Return true if the node is a <g> with no content and empty groups are removed
+     */
+    bool IsRemoved(SvgNode *node) const;
 
-    pugi::xml_node AppendChild(std::string name);
+    /**
+     * Return true if the stroke of the lines and curves in the current colour is given by the global style
+     */
+    bool UseStrokeStyle() { return m_svgCompact && this->UseGlobalStyling(); }
+
+    /**
+     * Remove the <g> of a node and of its descendants from m_groupNodes once written
+     */
+    void RemoveGroups(SvgNode *node);
+
+    /**
+     * @name Methods for serializing the attributes and the text.
+     * The values are escaped as they are by pugixml.
+     */
+    ///@{
+    static void AppendAttribute(std::string &xml, const char *name, const std::string &value);
+    static void AppendAttribute(std::string &xml, const char *name, const char *value);
+    static void AppendAttribute(std::string &xml, const char *name, int value);
+    static void AppendAttribute(std::string &xml, const char *name, float value);
+    static void AppendAttribute(std::string &xml, const char *name, double value);
+    static void StartAttribute(std::string &xml, const char *name);
+    static void AppendEscaped(std::string &xml, const char *value, bool attribute);
+    ///@}
+
+    /**
+     * Write a newline and the indentation of the depth (nothing in compact mode)
+     */
+    void AppendIndent(std::string &xml, int depth);
+
+    /**
+     * @name Methods for formatting numbers without allocating a temporary string.
+     * AppendInt is the same as "%d" and AppendPoint as "%d%c%d". AppendFormatted is for a single decimal value.
+     */
+    ///@{
+    static void AppendInt(std::string &xml, int value);
+    static void AppendPoint(std::string &xml, int x, int y, char separator);
+    static void AppendFormatted(std::string &xml, const char *format, double value);
+    ///@}
+
+    /**
+     * Serialize a pugi node (e.g., the glyph <defs>) with a newline and the indentation of the depth
+     */
+    void AppendPugiNode(std::string &xml, pugi::xml_node node, int depth);
 
 public:
     //
@@ -225,11 +405,17 @@ private:
      */
     bool m_vrvTextFont;
 
-    // we use a std::stringstream because we want to prepend the <defs> which will know only when we reach the end of
-    // the page
+    // the content of the root <svg> element written so far
+    // the <defs> are prepended when committing because we know them only when we reach the end of the page
     // some viewer seem to support to have the <defs> at the end, but some do not (pdf2svg, for example)
-    // for this reason, the full svg is finally written a string from the destructor or when Flush() is called
-    std::ostringstream m_outdata;
+    std::string m_svgBody;
+
+    // the full svg once committed
+    std::string m_outdata;
+
+    // the buffer for the elements with no children (see StartLeaf) and for the colour (see GetColour)
+    std::string m_leaf;
+    char m_colour[8];
 
     bool m_committed; // did we flushed the file?
     int m_originX, m_originY;
@@ -238,12 +424,13 @@ private:
     // they will be added at the end of the file as <defs>
     std::vector<std::string> m_smuflGlyphs;
 
-    // pugixml data
-    pugi::xml_document m_svgDoc;
-    pugi::xml_node m_svgNode;
-    pugi::xml_node m_pageNode;
-    pugi::xml_node m_currentNode;
-    std::list<pugi::xml_node> m_svgNodeStack;
+    // the elements
+    SvgNode *m_svgNode;
+    SvgNode *m_pageNode;
+    SvgNode *m_currentNode;
+    std::vector<SvgNode *> m_svgNodeStack;
+    // the <g> with an id that are still in memory and can be resumed
+    std::unordered_map<std::string, SvgNode *> m_groupNodes;
 
     // output as mm (for pdf generation with a 72 dpi)
     bool m_mmOutput;
@@ -252,6 +439,13 @@ private:
     bool m_svgBoundingBoxes;
     // use viewbox on svg root element
     bool m_svgViewBox;
+    // compact output
+    bool m_svgCompact;
+    bool m_svgRemoveEmptyGroups;
+    bool m_svgRemoveXlink;
+    bool m_svgRemoveLabels;
+    // the url of the external glyph sprite
+    std::string m_glyphSprite;
 };
 
 } // namespace vrv
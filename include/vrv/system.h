@@ -86,6 +86,19 @@ public:
      */
     int GetHeight() const;
 
+    /**
+     * @name Set and get the values stored when casting off the document.
+     * The height is the one of the system laid out in the content page.
+     * The scoreDef width is the width used for casting off the system.
+     * They are used for casting off the document again (see Doc::RecastOffDoc).
+     */
+    ///@{
+    void StoreCastOffHeight() { m_castOffHeight = this->GetHeight(); }
+    int GetCastOffHeight() const { return m_castOffHeight; }
+    void SetCastOffScoreDefWidth(int width) { m_castOffScoreDefWidth = width; }
+    int GetCastOffScoreDefWidth() const { return m_castOffScoreDefWidth; }
+    ///@}
+
     /**
      * Return the index position of the system in its page parent
      */
@@ -304,6 +317,14 @@ private:
      * This does not mean that a staff is hidden, but only that it can be optimized.
      */
     bool m_drawingIsOptimized;
+
+    /**
+     * @name The height and the scoreDef width stored when casting off the document
+     */
+    ///@{
+    int m_castOffHeight;
+    int m_castOffScoreDefWidth;
+    ///@}
 };
 
 } // namespace vrv
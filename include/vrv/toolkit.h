@@ -8,6 +8,7 @@
 #ifndef __VRV_TOOLKIT_H__
 #define __VRV_TOOLKIT_H__
 
+#include <map>
 #include <string>
 
 //----------------------------------------------------------------------------
@@ -20,6 +21,7 @@
 namespace vrv {
 
 class EditorToolkit;
+class RenderCache;
 
 enum FileFormat {
     UNKNOWN = 0,
@@ -79,6 +81,41 @@ public:
      */
     bool SaveFile(const std::string &filename);
 
+    /**
+     * @name Save and load a snapshot of the document.
+     * A snapshot is a versioned binary file with the options and the document as page-based MEI, that is with its
+     * pages already cast off. Loading it only skips the system and page breaking: the MEI is still parsed and
+     * PrepareDrawing and the layout of the pages are run again since the drawing state is not serialized.
+     * The gain is therefore limited to the cast-off time. It can be loaded only with the same version of Verovio.
+     */
+    ///@{
+    bool SaveSnapshot(const std::string &filename);
+    bool LoadSnapshot(const std::string &filename);
+    std::string GetSnapshot();
+    bool LoadSnapshotData(const std::string &data);
+    ///@}
+
+    /**
+     * @name Enable, disable and clear the render cache
+     * With the cache enabled, the SVG, MIDI and timemap output is stored with a key built from the input data,
+     * the options and the version. The data passed to LoadData is not loaded as long as everything requested
+     * is found in the cache. The entries are kept in memory, or in the directory if one is given, and the least
+     * recently used ones are evicted when the maximum size (in bytes) is reached. With verify, the checksum of the
+     * entries is checked before they are used. Since the ids in the output have to be valid for the document loaded
+     * later, the cache is used only when they are deterministic, that is with the xmlIdSeed option or when all the
+     * elements have an xml:id in the data. It is not used with the progressiveLayout option.
+     */
+    ///@{
+    void EnableRenderCache(const std::string &directory = "", int maxSize = 64 * 1024 * 1024, bool verify = false);
+    void DisableRenderCache();
+    void ClearRenderCache();
+    ///@}
+
+    /**
+     * Return the counters of the render cache (hits, misses, evictions, invalid entries, collisions) as a JSON string.
+     */
+    std::string GetRenderCacheStats() const;
+
     /**
      * @name Getter and setter for options as JSON string
      */
@@ -129,18 +166,98 @@ public:
      */
     bool RenderToDeviceContext(int pageNo, DeviceContext *deviceContext);
 
+    /**
+     * Render a rectangle of the page to the deviceContext.
+     * The rectangle is given in the units of the page options from the top-left corner of the page.
+     * The size of the deviceContext is the one of the rectangle.
+     * Page number is 1-based.
+     */
+    bool RenderToDeviceContext(int pageNo, DeviceContext *deviceContext, int x, int y, int width, int height);
+
     /**
      * Render the page in SVG and returns it as a string.
      * Page number is 1-based
      */
     std::string RenderToSVG(int pageNo = 1, bool xml_declaration = false);
 
+    /**
+     * Render a rectangle of the page in SVG and returns it as a string.
+     * See RenderToDeviceContext for the rectangle.
+     * Page number is 1-based
+     */
+    std::string RenderToSVG(int pageNo, int x, int y, int width, int height, bool xml_declaration = false);
+
+    /**
+     * Render the page in SVG and return the changes since the previous call for the page as a JSON string.
+     * The patch has the <g> elements that changed since the previous rendering with the id of the element they
+     * replace and the ids of the ones that were removed, so the SVG of the page can be updated in place (e.g., after
+     * Edit). The id of the new element can be different when it was generated again (e.g., for a system).
+     * An element that moved to another parent is only given within the replaced parent, so the removals and the
+     * replacements can be applied in any order.
+     * For example {"page": 1, "full": false, "replace": [{"id": "note-1", "svg": "<g ...>...</g>"}], "remove": []}
+     * The <defs> are given when changed. The full SVG is given with "full": true for the first rendering of the page
+     * or when the changes cannot be expressed as a patch (e.g., when the size of the page changed).
+     * Page number is 1-based
+     */
+    std::string RenderToSVGPatch(int pageNo = 1);
+
+    /**
+     * Render a range of measures in SVG and returns it as a string.
+     * This is designed for the continuous layout (--breaks none) where all the measures are in one system.
+     * The measures are 1-based indexes in the document and both have to be in the same system.
+     * The output has the height of the page and the width of the measures.
+     */
+    std::string RenderMeasureRangeToSVG(int firstMeasure, int lastMeasure, bool xml_declaration = false);
+
+    /**
+     * Render the page in a binary display list and returns it as a string.
+     * See DisplayListDeviceContext for the format.
+     * Page number is 1-based
+     */
+    std::string RenderToDisplayList(int pageNo = 1);
+
+    /**
+     * Render the page in PNG and returns it as a (binary) string.
+     * The width is in pixels, 0 for the width of the page at the current scale.
+     * Page number is 1-based
+     */
+    std::string RenderToPNG(int pageNo = 1, int width = 0);
+
+    /**
+     * Render the page in PNG and save it to the file.
+     * Page number is 1-based
+     */
+    bool RenderToPNGFile(const std::string &filename, int pageNo = 1, int width = 0);
+
+    /**
+     * Render all the pages in a single PDF and returns it as a (binary) string.
+     */
+    std::string RenderToPDF();
+
+    /**
+     * Render all the pages in a single PDF and save it to the file.
+     * The pages are written to the file as they are rendered.
+     */
+    bool RenderToPDFFile(const std::string &filename);
+
     /**
      * Render the page in SVG and save it to the file.
-     * Page number is 1-based.
+     * Page number is 1-based. The file is gzip compressed when its extension is .svgz.
      */
     bool RenderToSVGFile(const std::string &filename, int pageNo = 1);
 
+    /**
+     * Return the glyph sprite for the svgGlyphSprite option as an SVG string.
+     * The sprite has the definitions of the glyphs used in the pages rendered so far, or of all the glyphs of the
+     * font with allGlyphs (e.g., for fetching it before any page).
+     */
+    std::string GetGlyphSprite(bool allGlyphs = false);
+
+    /**
+     * Write the glyph sprite to the file.
+     */
+    bool GetGlyphSpriteFile(const std::string &filename, bool allGlyphs = false);
+
     /**
      * Creates a midi file, opens it, and writes to it.
      * currently generates a dummy midi file.
@@ -261,9 +378,13 @@ public:
     /**
      * @name Get the pages for a loaded file
      * The SetFormat with FileFormat does not perform any validation
+     * With the progressiveLayout option, GetPageCount returns the number of pages cast off so far until
+     * IsLayoutComplete returns true. CompleteLayout casts off the remaining pages.
      */
     ///@{
     int GetPageCount();
+    bool IsLayoutComplete();
+    void CompleteLayout();
     ///@}
 
     /**
@@ -280,6 +401,45 @@ private:
     bool IsUTF16(const std::string &filename);
     bool LoadUTF16File(const std::string &filename);
 
+    /**
+     * Import the data and cast off the document. Called from LoadData.
+     */
+    bool ImportData(const std::string &data);
+
+    /**
+     * @name Methods for the render cache
+     * LoadPendingData loads the data for which loading was deferred and has to be called by all methods using the
+     * document. It also casts off the pages not cast off yet with the progressiveLayout option, up to pageNo only
+     * when given. The keys are built from the digest of the data, the options, the scale and the version.
+     * SetRenderCacheDocKey builds the key of the document from m_renderCacheDataDigest and the current options.
+     * HasDeterministicIds checks that a document loaded again from the data will have the same ids.
+     */
+    ///@{
+    void LoadPendingData(int pageNo = 0);
+    void SetRenderCacheDocKey();
+    bool GetRenderCacheEntry(const std::string &output, std::string &content);
+    void PutRenderCacheEntry(const std::string &output, const std::string &content);
+    bool HasDeterministicIds(const std::string &data);
+    ///@}
+
+    /**
+     * Render all the pages with a PdfDeviceContext writing to the stream
+     */
+    bool RenderToPDFStream(std::ostream &output);
+
+    /**
+     * Return the values of all the options as a string.
+     * Used for building the render cache keys and for detecting option changes between layouts.
+     * The page size and margin options are skipped without withPageGeometry.
+     */
+    std::string GetOptionValues(bool withPageGeometry = true) const;
+
+    /**
+     * Add the files of the glyphs used in a page to m_spriteGlyphs.
+     * The list is emptied when another font was loaded.
+     */
+    void AddSpriteGlyphs(const std::vector<std::string> &glyphs);
+
 public:
     //
 private:
@@ -300,6 +460,52 @@ private:
     char *m_cString;
 
     EditorToolkit *m_editorToolkit;
+
+    /**
+     * The render cache (NULL when disabled), the key of the loaded document and the source of the key.
+     * The key is empty when the document cannot be cached (e.g., after editing). The source includes the SHA-256
+     * digest of the data, so entries of another document with the same key are not taken.
+     */
+    RenderCache *m_renderCache;
+    std::string m_renderCacheDocKey;
+    std::string m_renderCacheDocSource;
+    std::string m_renderCacheDataDigest;
+
+    /**
+     * The xmlIdSeed option value (0 when not set), used to generate the same ids when the data is loaded again.
+     */
+    int m_xmlIdSeed;
+
+    /**
+     * Set when RenderToMIDI or RenderToTimemap was found in the cache, in which case the timemap is not calculated.
+     */
+    bool m_midiTimemapFromCache;
+
+    /**
+     * The data for which loading was deferred because its page count was found in the cache.
+     * The page count is looked up again in GetPageCount with the current options.
+     */
+    std::string m_pendingData;
+    bool m_hasPendingData;
+
+    /**
+     * The files of the glyphs used in the pages rendered in SVG (for the glyph sprite) and the font version.
+     */
+    std::vector<std::string> m_spriteGlyphs;
+    int m_spriteFontVersion;
+
+    /**
+     * The option values when the document was cast off with Doc::CastOffDoc (empty otherwise).
+     * Only the edited part of the document is cast off again in RedoLayout if they did not change, and
+     * the measures are not laid out again if only the page geometry options changed.
+     */
+    std::string m_castOffOptionValues;
+    std::string m_castOffLayoutOptionValues;
+
+    /**
+     * The last SVG rendered by RenderToSVGPatch for each page (by page number)
+     */
+    std::map<int, std::string> m_svgPatchPages;
 };
 
 } // namespace vrv
@@ -159,6 +159,38 @@ public:
      */
     void DrawCurrentPage(DeviceContext *dc, bool background = true);
 
+    /**
+     * @name Set and reset a clip rectangle for drawing only a part of the current page.
+     * The rectangle is given in page coordinates (from the top-left corner of the page).
+     * With a clip, the origin of the device context is the top-left corner of the rectangle
+     * and the systems, measures and staves that do not intersect it are not drawn.
+     * The clip is ignored with facsimile documents.
+     * With SetClipMeasures, only the measures of the range and their neighbours within the clip are visited
+     * in the system of the range. The measures have to be in the same system.
+     * Defined in view_page.cpp
+     */
+    ///@{
+    void SetClip(int x, int y, int width, int height);
+    void SetClipMeasures(Measure *first, Measure *last);
+    void ResetClip();
+    bool HasClip() const { return m_hasClip; }
+    int GetClipX() const { return m_clipX; }
+    int GetClipY() const { return m_clipY; }
+    int GetClipWidth() const { return m_clipWidth; }
+    int GetClipHeight() const { return m_clipHeight; }
+    ///@}
+
+    /**
+     * @name Set and get the level-of-detail threshold (0 by default for drawing all the details).
+     * The threshold is a size in logical units. Text, lyrics, articulations and ornaments smaller than it are not
+     * drawn, and the staff lines are simplified when the staff space is smaller than it.
+     * The threshold is ignored when calculating the bounding boxes.
+     */
+    ///@{
+    void SetDetailThreshold(int threshold) { m_detailThreshold = threshold; }
+    int GetDetailThreshold() const { return m_detailThreshold; }
+    ///@}
+
     /**
      * Return the pixel per unit factor of the current page (if any, 1.0 otherwise)
      */
@@ -197,8 +229,10 @@ protected:
     void DrawBarLineDots(DeviceContext *dc, StaffDef *staffDef, Staff *staff, BarLine *barLine);
     void DrawLedgerLines(DeviceContext *dc, Staff *staff, ArrayOfLedgerLines *lines, bool below, bool cueSize);
     void DrawMeasure(DeviceContext *dc, Measure *measure, System *system);
+    void DrawClippedMeasure(DeviceContext *dc, Measure *measure, System *system);
     void DrawMNum(DeviceContext *dc, MNum *mnum, Measure *measure);
     void DrawStaff(DeviceContext *dc, Staff *staff, Measure *measure, System *system);
+    void DrawClippedStaff(DeviceContext *dc, Staff *staff, Measure *measure, System *system);
     void DrawStaffLines(DeviceContext *dc, Staff *staff, Measure *measure, System *system);
     void DrawLayer(DeviceContext *dc, Layer *layer, Staff *staff, Measure *measure);
     void DrawLayerList(DeviceContext *dc, Layer *layer, Staff *staff, Measure *measure, const ClassId classId);
@@ -572,7 +606,44 @@ protected:
      */
     ScoreDef m_drawingScoreDef;
 
+    /**
+     * @name The clip rectangle in page coordinates and in logical coordinates for the current page.
+     * The logical values are set in DrawCurrentPage.
+     */
+    ///@{
+    bool m_hasClip;
+    int m_clipX, m_clipY, m_clipWidth, m_clipHeight;
+    Measure *m_clipFirstMeasure, *m_clipLastMeasure;
+    int m_drawingClipLeft, m_drawingClipRight, m_drawingClipTop, m_drawingClipBottom;
+    ///@}
+
+    /** The level-of-detail threshold */
+    int m_detailThreshold;
+
 private:
+    /**
+     * @name Return true if the extent is outside the clip rectangle (or false without a clip).
+     * The values are logical coordinates. For spanning elements, the extent is the one of the start and end measures.
+     * For measures, it includes the content bounding box.
+     * Defined in view_page.cpp
+     */
+    ///@{
+    bool IsClippedX(int left, int right) const;
+    bool IsClippedY(int top, int bottom) const;
+    bool IsClippedMeasure(Measure *measure) const;
+    bool IsClippedSpanning(Object *element, System *system);
+    ///@}
+
+    /**
+     * @name Return true if the size (or the size of the element for the staff size) is below the detail threshold.
+     * Defined in view_page.cpp
+     */
+    ///@{
+    bool IsBelowDetailThreshold(DeviceContext *dc, int size) const;
+    bool IsBelowDetailThreshold(DeviceContext *dc, Object *element, int staffSize);
+    ///@}
+
+
     /** @name Internal values for storing temporary values for ligatures */
     ///@{
     static int s_drawingLigX[2], s_drawingLigY[2];
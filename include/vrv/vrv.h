@@ -91,6 +91,12 @@ std::string GetFilename(std::string fullpath);
  */
 std::string GetVersion();
 
+/**
+ * Parse a colour (#RRGGBB, #RGB, rgb(r, g, b) or a basic colour keyword) into 0xRRGGBB.
+ * Return false if the colour is not supported.
+ */
+bool ParseColour(const std::string &value, int &colour);
+
 /**
  *
  */
@@ -145,6 +151,10 @@ public:
     static Glyph *GetGlyph(wchar_t smuflCode);
     /** Returns the glyph (if exists) for the text font (bounding box and ASCII only) */
     static Glyph *GetTextGlyph(wchar_t code);
+    /** Returns the glyphs of the current SMuFL font */
+    static const std::map<wchar_t, Glyph> &GetFont() { return m_font; }
+    /** Returns a counter changed every time a SMuFL font is loaded (e.g., for invalidating cached metrics) */
+    static int GetFontVersion() { return m_fontVersion; }
     ///@}
 
 private:
@@ -155,6 +165,8 @@ private:
     static std::string m_path;
     /** The loaded SMuFL font */
     static std::map<wchar_t, Glyph> m_font;
+    /** The counter incremented in Resources::LoadFont */
+    static int m_fontVersion;
     /** A text font used for bounding box calculations */
     static std::map<wchar_t, Glyph> m_textFont;
 };
@@ -165,6 +177,31 @@ private:
 
 std::string Base64Encode(unsigned char const *, unsigned int len);
 
+//----------------------------------------------------------------------------
+// Gzip and zlib compression
+//----------------------------------------------------------------------------
+
+/**
+ * Compress the data in the gzip format (e.g., for .svgz files).
+ * The deflate stream is a single block with the fixed Huffman codes.
+ */
+std::string GzipCompress(const std::string &data);
+
+/**
+ * Compress the data in the zlib format (e.g., for the PNG image data), with the same deflate stream.
+ */
+std::string ZlibCompress(const std::string &data);
+
+/**
+ * Return the CRC-32 of the data (as in gzip and PNG)
+ */
+unsigned int Crc32(const std::string &data);
+
+/**
+ * Return the SHA-256 digest of the data as a hexadecimal string
+ */
+std::string Sha256(const std::string &data);
+
 } // namespace vrv
 
 #endif
@@ -11,6 +11,7 @@
 #include <algorithm>
 #include <list>
 #include <map>
+#include <unordered_map>
 #include <vector>
 
 //----------------------------------------------------------------------------
@@ -218,6 +219,9 @@ enum ClassId {
     //
     BBOX_DEVICE_CONTEXT,
     SVG_DEVICE_CONTEXT,
+    DISPLAY_LIST_DEVICE_CONTEXT,
+    RASTER_DEVICE_CONTEXT,
+    PDF_DEVICE_CONTEXT,
     CUSTOM_DEVICE_CONTEXT,
     //
     UNSPECIFIED
@@ -250,6 +254,7 @@ enum InterfaceId {
 class Alignment;
 class Arpeg;
 class ClassIdComparison;
+class Clef;
 class BeamElementCoord;
 class BoundingBox;
 class Comparison;
@@ -286,16 +291,10 @@ typedef std::vector<BeamElementCoord *> ArrayOfBeamElementCoords;
 
 typedef std::vector<std::pair<int, int> > ArrayOfIntPairs;
 
-typedef std::vector<std::pair<LinkingInterface *, std::string> > ArrayOfLinkingInterfaceUuidPairs;
-
-typedef std::vector<std::pair<PlistInterface *, std::string> > ArrayOfPlistInterfaceUuidPairs;
-
 typedef std::vector<CurveSpannedElement *> ArrayOfCurveSpannedElements;
 
 typedef std::vector<std::pair<Object *, data_MEASUREBEAT> > ArrayOfObjectBeatPairs;
 
-typedef std::vector<std::pair<TimePointInterface *, ClassId> > ArrayOfPointingInterClassIdPairs;
-
 typedef std::vector<std::pair<TimeSpanningInterface *, ClassId> > ArrayOfSpanningInterClassIdPairs;
 
 typedef std::vector<FloatingPositioner *> ArrayOfFloatingPositioners;
@@ -308,6 +307,17 @@ typedef std::vector<TextElement *> ArrayOfTextElements;
 
 typedef std::map<Staff *, std::list<int> > MapOfDotLocs;
 
+typedef std::unordered_multimap<std::string, LinkingInterface *> MapOfUuidLinkingInterfaces;
+
+typedef std::unordered_multimap<std::string, PlistInterface *> MapOfUuidPlistInterfaces;
+
+typedef std::unordered_multimap<std::string, TimePointInterface *> MapOfUuidPointingInterfaces;
+
+typedef std::unordered_multimap<std::string, std::pair<TimeSpanningInterface *, Object *> >
+    MapOfUuidSpanningInterObjectPairs;
+
+typedef std::unordered_map<Object *, Clef *> MapOfObjectClefs;
+
 typedef std::map<std::string, Option *> MapOfStrOptions;
 
 typedef std::map<data_PITCHNAME, data_ACCIDENTAL_WRITTEN> MapOfPitchAccid;
@@ -528,7 +528,12 @@ int BoundingBox::Intersects(FloatingCurvePositioner *curve, Accessor type, int m
     if (p1.x > this->GetRightBy(type)) return 0;
 
     Point topBezier[4], bottomBezier[4];
-    BoundingBox::CalcThickBezier(points, curve->GetThickness(), curve->GetAngle(), topBezier, bottomBezier);
+    curve->GetThickBezierPoints(topBezier, bottomBezier);
+    const BezierPolynomial &topPolynomial = curve->GetTopBezierPolynomial();
+    const BezierPolynomial &bottomPolynomial = curve->GetBottomBezierPolynomial();
+    // The left and right positions of the box for calculating both y positions at once
+    const int xs[2] = { this->GetLeftBy(type), this->GetRightBy(type) };
+    int ys[2];
 
     // The curve overflows on both sides
     if ((p1.x < this->GetLeftBy(type)) && p2.x > this->GetRightBy(type)) {
@@ -537,13 +542,15 @@ int BoundingBox::Intersects(FloatingCurvePositioner *curve, Accessor type, int m
             // The curve is already below the content
             if ((curve->GetTopBy(type) + margin) < this->GetBottomBy(type)) return 0;
             int xMaxY = curve->CalcMinMaxY(topBezier);
-            int leftY = BoundingBox::CalcBezierAtPosition(bottomBezier, this->GetLeftBy(type)) + margin;
-            int rightY = BoundingBox::CalcBezierAtPosition(bottomBezier, this->GetRightBy(type)) + margin;
+            bottomPolynomial.CalcYAtPositions(xs, ys, 2);
+            int leftY = ys[0] + margin;
+            int rightY = ys[1] + margin;
             // Everything is underneath
             if ((leftY >= this->GetTopBy(type)) && (rightY >= this->GetTopBy(type))) return 0;
             // Recalculate for above
-            leftY = BoundingBox::CalcBezierAtPosition(topBezier, this->GetLeftBy(type)) + margin;
-            rightY = BoundingBox::CalcBezierAtPosition(topBezier, this->GetRightBy(type)) + margin;
+            topPolynomial.CalcYAtPositions(xs, ys, 2);
+            leftY = ys[0] + margin;
+            rightY = ys[1] + margin;
             // The box is above the summit of the curve
             if ((this->GetLeftBy(type) < (p1.x + xMaxY)) && (this->GetRightBy(type) > (p1.x + xMaxY)))
                 return (curve->GetTopBy(type) - this->GetBottomBy(type) + margin);
@@ -558,12 +565,14 @@ int BoundingBox::Intersects(FloatingCurvePositioner *curve, Accessor type, int m
             if ((curve->GetBottomBy(type) - margin) > this->GetTopBy(type)) return 0;
             int xMinY = curve->CalcMinMaxY(bottomBezier);
             // Check if the box is above
-            int leftY = BoundingBox::CalcBezierAtPosition(topBezier, this->GetLeftBy(type)) - margin;
-            int rightY = BoundingBox::CalcBezierAtPosition(topBezier, this->GetRightBy(type)) - margin;
+            topPolynomial.CalcYAtPositions(xs, ys, 2);
+            int leftY = ys[0] - margin;
+            int rightY = ys[1] - margin;
             if ((leftY <= this->GetBottomBy(type)) && (rightY <= this->GetBottomBy(type))) return 0;
             // Recalculate for below
-            leftY = BoundingBox::CalcBezierAtPosition(bottomBezier, this->GetLeftBy(type)) - margin;
-            rightY = BoundingBox::CalcBezierAtPosition(bottomBezier, this->GetRightBy(type)) - margin;
+            bottomPolynomial.CalcYAtPositions(xs, ys, 2);
+            leftY = ys[0] - margin;
+            rightY = ys[1] - margin;
             // The box is above the summit of the curve
             if ((this->GetLeftBy(type) < (p1.x + xMinY)) && (this->GetRightBy(type) > (p1.x + xMinY)))
                 return (curve->GetBottomBy(type) - this->GetTopBy(type) - margin);
@@ -586,7 +595,7 @@ int BoundingBox::Intersects(FloatingCurvePositioner *curve, Accessor type, int m
             if (this->GetLeftBy(type) < (p1.x + xMaxY))
                 return (curve->GetTopBy(type) - this->GetBottomBy(type) + margin);
             // Calcultate the Y position of the curve one the left
-            int leftY = BoundingBox::CalcBezierAtPosition(topBezier, this->GetLeftBy(type)) + margin;
+            int leftY = topPolynomial.CalcYAtPosition(this->GetLeftBy(type)) + margin;
             // LogDebug("leftY %d, %d, %d", leftY, this->GetBottomBy(type), this->GetTopBy(type));
             // The content left is below the bottom
             if (leftY < this->GetBottomBy(type)) return 0;
@@ -601,7 +610,7 @@ int BoundingBox::Intersects(FloatingCurvePositioner *curve, Accessor type, int m
             if (this->GetLeftBy(type) < (p1.x + xMinY))
                 return (curve->GetBottomBy(type) - this->GetTopBy(type) - margin);
             // Calcultate the Y position of the curve one the left
-            int leftY = BoundingBox::CalcBezierAtPosition(bottomBezier, this->GetLeftBy(type)) - margin;
+            int leftY = bottomPolynomial.CalcYAtPosition(this->GetLeftBy(type)) - margin;
             // LogDebug("leftY %d, %d, %d", leftY, this->GetBottomBy(type), this->GetTopBy(type));
             // The content left is above the top
             if (leftY > this->GetTopBy(type)) return 0;
@@ -621,7 +630,7 @@ int BoundingBox::Intersects(FloatingCurvePositioner *curve, Accessor type, int m
             if (this->GetRightBy(type) > (p1.x + xMaxY))
                 return (curve->GetTopBy(type) - this->GetBottomBy(type) + margin);
             // Calcultate the Y position of the curve one the right
-            int rightY = BoundingBox::CalcBezierAtPosition(topBezier, this->GetRightBy(type)) + margin;
+            int rightY = topPolynomial.CalcYAtPosition(this->GetRightBy(type)) + margin;
             // LogDebug("rightY %d, %d, %d", rightY, this->GetBottomBy(type), this->GetTopBy(type));
             // The content right is below the bottom
             if (rightY < this->GetBottomBy(type)) return 0;
@@ -636,7 +645,7 @@ int BoundingBox::Intersects(FloatingCurvePositioner *curve, Accessor type, int m
             if (this->GetRightBy(type) > (p1.x + xMinY))
                 return (curve->GetBottomBy(type) - this->GetTopBy(type) - margin);
             // Calcultate the Y position of the curve one the right
-            int rightY = BoundingBox::CalcBezierAtPosition(bottomBezier, this->GetRightBy(type)) - margin;
+            int rightY = bottomPolynomial.CalcYAtPosition(this->GetRightBy(type)) - margin;
             // LogDebug("rightY %d, %d, %d", rightY, this->GetBottomBy(type), this->GetTopBy(type));
             // The content right is above the top
             if (rightY > this->GetTopBy(type)) return 0;
@@ -716,14 +725,8 @@ pow (t, 3)* bezier[3].y;
 
 int BoundingBox::CalcBezierAtPosition(const Point bezier[4], int x)
 {
-    double t = 0.0;
-    // avoid division by 0
-    if (bezier[3].x != bezier[0].x) t = (double)(x - bezier[0].x) / (double)(bezier[3].x - bezier[0].x);
-    t = std::min(1.0, std::max(0.0, t));
-
-    Point p = BoundingBox::CalcDeCasteljau(bezier, t);
-
-    return p.y;
+    BezierPolynomial polynomial(bezier);
+    return polynomial.CalcYAtPosition(x);
 }
 
 Point BoundingBox::CalcDeCasteljau(const Point bezier[4], double t)
@@ -865,6 +868,57 @@ int BoundingBox::RectBottomOverlap(const Point rect1[2], const Point rect2[2], i
     return std::max(0, rect2[1].y - rect1[0].y + margin);
 }
 
+//----------------------------------------------------------------------------
+// BezierPolynomial
+//----------------------------------------------------------------------------
+
+BezierPolynomial::BezierPolynomial()
+{
+    m_x = 0;
+    m_width = 0;
+    m_a = m_b = m_c = m_d = 0.0;
+}
+
+BezierPolynomial::BezierPolynomial(const Point bezier[4])
+{
+    this->SetBezier(bezier);
+}
+
+void BezierPolynomial::SetBezier(const Point bezier[4])
+{
+    m_x = bezier[0].x;
+    m_width = bezier[3].x - bezier[0].x;
+
+    // The Bernstein form (1-t)^3 y0 + 3t(1-t)^2 y1 + 3t^2(1-t) y2 + t^3 y3 expanded in powers of t
+    m_a = -bezier[0].y + 3.0 * bezier[1].y - 3.0 * bezier[2].y + bezier[3].y;
+    m_b = 3.0 * bezier[0].y - 6.0 * bezier[1].y + 3.0 * bezier[2].y;
+    m_c = -3.0 * bezier[0].y + 3.0 * bezier[1].y;
+    m_d = bezier[0].y;
+}
+
+int BezierPolynomial::CalcYAtPosition(int x) const
+{
+    int y;
+    this->CalcYAtPositions(&x, &y, 1);
+    return y;
+}
+
+void BezierPolynomial::CalcYAtPositions(const int *xs, int *ys, int count) const
+{
+    assert(xs && ys);
+
+    // avoid division by 0 - t is then always 0
+    const double width = (m_width != 0) ? m_width : 1.0;
+    const double factor = (m_width != 0) ? 1.0 : 0.0;
+
+    for (int i = 0; i < count; ++i) {
+        double t = factor * (double)(xs[i] - m_x) / width;
+        t = std::min(1.0, std::max(0.0, t));
+        // Horner's method
+        ys[i] = (int)(((m_a * t + m_b) * t + m_c) * t + m_d);
+    }
+}
+
 //----------------------------------------------------------------------------
 // SegmentedLine
 //----------------------------------------------------------------------------
@@ -924,4 +978,60 @@ void SegmentedLine::AddGap(int start, int end)
     }
 }
 
+//----------------------------------------------------------------------------
+// BoundingBoxIndex
+//----------------------------------------------------------------------------
+
+void BoundingBoxIndex::Clear()
+{
+    m_boxes.clear();
+    m_groups.clear();
+}
+
+void BoundingBoxIndex::Add(BoundingBox *box)
+{
+    assert(box);
+
+    m_boxes.push_back(box);
+
+    // A box without content bounding box never overlaps
+    if (!box->HasContentBB()) return;
+
+    // Find the smallest group for the width - group 30 holds all the wider boxes
+    int width = box->GetContentRight() - box->GetContentLeft();
+    int group = 0;
+    while ((group < 30) && ((1 << group) <= width)) ++group;
+
+    if ((int)m_groups.size() <= group) m_groups.resize(group + 1);
+    m_groups.at(group).insert(std::make_pair(box->GetContentLeft(), (int)m_boxes.size() - 1));
+}
+
+void BoundingBoxIndex::FindHorizontalContentOverlaps(
+    const BoundingBox *box, ArrayOfBoundingBoxes &overlappingBoxes) const
+{
+    assert(box);
+
+    overlappingBoxes.clear();
+
+    if (!box->HasContentBB()) return;
+
+    std::vector<int> positions;
+    for (int group = 0; group < (int)m_groups.size(); ++group) {
+        const std::multimap<int, int> &lefts = m_groups.at(group);
+        // The overlapping boxes of the group start less than 2^group before the left of the box (except in group 30)
+        // and before its right
+        std::multimap<int, int>::const_iterator iter
+            = (group < 30) ? lefts.upper_bound(box->GetContentLeft() - (1 << group)) : lefts.begin();
+        for (; (iter != lefts.end()) && (iter->first < box->GetContentRight()); ++iter) {
+            if (box->HorizontalContentOverlap(m_boxes.at(iter->second))) positions.push_back(iter->second);
+        }
+    }
+
+    // Keep the order in which they were added
+    std::sort(positions.begin(), positions.end());
+    for (auto &position : positions) {
+        overlappingBoxes.push_back(m_boxes.at(position));
+    }
+}
+
 } // namespace vrv
@@ -0,0 +1,764 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        displaylistdevicecontext.cpp
+// Author:      agent
+// Created:     18/10/2026
+// Copyright (c) Authors and others. All rights reserved.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "displaylistdevicecontext.h"
+
+//----------------------------------------------------------------------------
+
+#include <algorithm>
+#include <assert.h>
+#include <string.h>
+
+//----------------------------------------------------------------------------
+
+#include "atts_shared.h"
+#include "glyph.h"
+#include "object.h"
+#include "svgdevicecontext.h"
+#include "vrv.h"
+
+namespace vrv {
+
+enum DisplayListOp {
+    DL_PAGE = 0x01,
+    DL_END_PAGE = 0x02,
+    DL_GROUP = 0x10,
+    DL_END_GROUP = 0x11,
+    DL_RESUME_GROUP = 0x12,
+    DL_ROTATE = 0x13,
+    DL_PEN = 0x20,
+    DL_BRUSH = 0x21,
+    DL_FONT = 0x22,
+    DL_LINE = 0x30,
+    DL_POLYGON = 0x31,
+    DL_RECTANGLE = 0x32,
+    DL_ELLIPSE = 0x33,
+    DL_ARC = 0x34,
+    DL_BEZIER = 0x35,
+    DL_GLYPH = 0x36,
+    DL_SVG_SHAPE = 0x37,
+    DL_TEXT = 0x40,
+    DL_TEXT_RUN = 0x41,
+    DL_MOVE_TEXT = 0x42,
+    DL_MOVE_TEXT_Y = 0x43,
+    DL_END_TEXT = 0x44
+};
+
+enum DisplayListGroupFlag { DL_GROUP_ID = 1, DL_GROUP_PREPEND = 2, DL_GROUP_TEXT = 4, DL_GROUP_COLOUR = 8 };
+
+//----------------------------------------------------------------------------
+// DisplayListDeviceContext
+//----------------------------------------------------------------------------
+
+DisplayListDeviceContext::DisplayListDeviceContext() : DeviceContext()
+{
+    m_originX = 0;
+    m_originY = 0;
+    m_facsimile = false;
+
+    SetBrush(AxNONE, AxSOLID);
+    SetPen(AxNONE, 1, AxSOLID);
+
+    m_lastX = 0;
+    m_lastY = 0;
+    m_hasPen = false;
+    m_hasBrush = false;
+    m_hasFont = false;
+
+    m_data = "VRDL";
+    m_data.push_back(1);
+}
+
+DisplayListDeviceContext::~DisplayListDeviceContext() {}
+
+void DisplayListDeviceContext::WriteUnsigned(unsigned int value)
+{
+    while (value >= 0x80) {
+        m_data.push_back((char)((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    m_data.push_back((char)value);
+}
+
+void DisplayListDeviceContext::WriteSigned(int value)
+{
+    this->WriteUnsigned(((unsigned int)value << 1) ^ (unsigned int)(value >> 31));
+}
+
+void DisplayListDeviceContext::WriteFloat(float value)
+{
+    unsigned int bits;
+    memcpy(&bits, &value, 4);
+    for (int i = 0; i < 4; ++i) {
+        m_data.push_back((char)((bits >> (8 * i)) & 0xFF));
+    }
+}
+
+void DisplayListDeviceContext::WriteString(const std::string &value)
+{
+    this->WriteUnsigned((unsigned int)value.size());
+    m_data.append(value);
+}
+
+void DisplayListDeviceContext::WriteInterned(const std::string &value)
+{
+    std::map<std::string, int>::iterator iter = m_strings.find(value);
+    if (iter != m_strings.end()) {
+        this->WriteUnsigned(iter->second);
+        return;
+    }
+    int index = (int)m_strings.size();
+    m_strings[value] = index;
+    this->WriteUnsigned(index);
+    this->WriteString(value);
+}
+
+void DisplayListDeviceContext::WritePoint(int x, int y)
+{
+    this->WriteSigned(x - m_lastX);
+    this->WriteSigned(y - m_lastY);
+    m_lastX = x;
+    m_lastY = y;
+}
+
+void DisplayListDeviceContext::WritePen()
+{
+    assert(m_penStack.size());
+
+    const Pen &pen = m_penStack.top();
+    if (m_hasPen && (pen.GetColour() == m_pen.GetColour()) && (pen.GetWidth() == m_pen.GetWidth())
+        && (pen.GetDashLength() == m_pen.GetDashLength()) && (pen.GetOpacity() == m_pen.GetOpacity())) {
+        return;
+    }
+    m_pen = pen;
+    m_hasPen = true;
+
+    this->WriteOp(DL_PEN);
+    this->WriteSigned(pen.GetColour());
+    this->WriteSigned(pen.GetWidth());
+    this->WriteSigned(pen.GetDashLength());
+    m_data.push_back((char)(int)(pen.GetOpacity() * 255 + 0.5));
+}
+
+void DisplayListDeviceContext::WriteBrush()
+{
+    assert(m_brushStack.size());
+
+    const Brush &brush = m_brushStack.top();
+    if (m_hasBrush && (brush.GetColour() == m_brush.GetColour()) && (brush.GetOpacity() == m_brush.GetOpacity())) {
+        return;
+    }
+    m_brush = brush;
+    m_hasBrush = true;
+
+    this->WriteOp(DL_BRUSH);
+    this->WriteSigned(brush.GetColour());
+    m_data.push_back((char)(int)(brush.GetOpacity() * 255 + 0.5));
+}
+
+void DisplayListDeviceContext::WriteFont()
+{
+    assert(m_fontStack.top());
+
+    FontInfo *font = m_fontStack.top();
+    if (m_hasFont && (font->GetPointSize() == m_font.GetPointSize()) && (font->GetStyle() == m_font.GetStyle())
+        && (font->GetWeight() == m_font.GetWeight()) && (font->GetFaceName() == m_font.GetFaceName())) {
+        return;
+    }
+    m_font = *font;
+    m_hasFont = true;
+
+    this->WriteOp(DL_FONT);
+    this->WriteSigned(font->GetPointSize());
+    m_data.push_back((char)font->GetStyle());
+    m_data.push_back((char)font->GetWeight());
+    this->WriteInterned(font->GetFaceName());
+}
+
+void DisplayListDeviceContext::WriteGroup(const std::string &gClass, const std::string &gId, unsigned char flags)
+{
+    if (!gId.empty()) flags |= DL_GROUP_ID;
+    this->WriteOp(DL_GROUP);
+    m_data.push_back((char)flags);
+    this->WriteInterned(gClass);
+    if (!gId.empty()) this->WriteString(gId);
+}
+
+void DisplayListDeviceContext::StartGraphic(Object *object, std::string gClass, std::string gId, bool prepend)
+{
+    // The same class as in the SVG
+    std::string baseClass = object->GetClassName();
+    std::transform(baseClass.begin(), baseClass.begin() + 1, baseClass.begin(), ::tolower);
+    if (gClass.length() > 0) {
+        baseClass.append(" " + gClass);
+    }
+    if (object->HasAttClass(ATT_TYPED)) {
+        AttTyped *att = dynamic_cast<AttTyped *>(object);
+        assert(att);
+        if (att->HasType()) {
+            baseClass.append(" " + att->GetType());
+        }
+    }
+
+    std::string colour;
+    if (object->HasAttClass(ATT_COLOR)) {
+        AttColor *att = dynamic_cast<AttColor *>(object);
+        assert(att);
+        if (att->HasColor()) colour = att->GetColor();
+    }
+
+    unsigned char flags = (prepend) ? DL_GROUP_PREPEND : 0;
+    if (!colour.empty()) flags |= DL_GROUP_COLOUR;
+    this->WriteGroup(baseClass, gId, flags);
+    if (!colour.empty()) this->WriteString(colour);
+}
+
+void DisplayListDeviceContext::EndGraphic(Object *object, View *view)
+{
+    this->WriteOp(DL_END_GROUP);
+}
+
+void DisplayListDeviceContext::StartCustomGraphic(std::string name, std::string gClass, std::string gId)
+{
+    if (gClass.length() > 0) {
+        name.append(" " + gClass);
+    }
+    this->WriteGroup(name, gId, 0);
+}
+
+void DisplayListDeviceContext::EndCustomGraphic()
+{
+    this->WriteOp(DL_END_GROUP);
+}
+
+void DisplayListDeviceContext::ResumeGraphic(Object *object, std::string gId)
+{
+    this->WriteOp(DL_RESUME_GROUP);
+    this->WriteString(gId);
+}
+
+void DisplayListDeviceContext::EndResumedGraphic(Object *object, View *view)
+{
+    this->WriteOp(DL_END_GROUP);
+}
+
+void DisplayListDeviceContext::StartTextGraphic(Object *object, std::string gClass, std::string gId)
+{
+    std::string baseClass = object->GetClassName();
+    std::transform(baseClass.begin(), baseClass.begin() + 1, baseClass.begin(), ::tolower);
+    if (gClass.length() > 0) {
+        baseClass.append(" " + gClass);
+    }
+    this->WriteGroup(baseClass, gId, DL_GROUP_TEXT);
+}
+
+void DisplayListDeviceContext::EndTextGraphic(Object *object, View *view)
+{
+    this->WriteOp(DL_END_GROUP);
+}
+
+void DisplayListDeviceContext::RotateGraphic(Point const &orig, double angle)
+{
+    this->WriteOp(DL_ROTATE);
+    this->WritePoint(orig.x, orig.y);
+    this->WriteFloat((float)angle);
+}
+
+void DisplayListDeviceContext::StartPage()
+{
+    this->WriteOp(DL_PAGE);
+    this->WriteSigned(this->GetWidth());
+    this->WriteSigned(this->GetHeight());
+    int factor = (m_facsimile) ? 1 : DEFINITION_FACTOR;
+    this->WriteSigned(this->GetWidth() * factor);
+    this->WriteSigned(this->GetHeight() * factor);
+    this->WriteFloat((float)this->GetUserScaleX());
+    this->WriteSigned(m_originX);
+    this->WriteSigned(m_originY);
+}
+
+void DisplayListDeviceContext::EndPage()
+{
+    this->WriteOp(DL_END_PAGE);
+}
+
+void DisplayListDeviceContext::SetLogicalOrigin(int x, int y)
+{
+    m_originX = -x;
+    m_originY = -y;
+}
+
+Point DisplayListDeviceContext::GetLogicalOrigin()
+{
+    return Point(m_originX, m_originY);
+}
+
+void DisplayListDeviceContext::DrawComplexBezierPath(Point bezier1[4], Point bezier2[4])
+{
+    this->WritePen();
+    this->WriteOp(DL_BEZIER);
+    // The same order as the SVG path
+    this->WritePoint(bezier1[0].x, bezier1[0].y);
+    this->WritePoint(bezier1[1].x, bezier1[1].y);
+    this->WritePoint(bezier1[2].x, bezier1[2].y);
+    this->WritePoint(bezier1[3].x, bezier1[3].y);
+    this->WritePoint(bezier2[2].x, bezier2[2].y);
+    this->WritePoint(bezier2[1].x, bezier2[1].y);
+    this->WritePoint(bezier2[0].x, bezier2[0].y);
+}
+
+void DisplayListDeviceContext::DrawCircle(int x, int y, int radius)
+{
+    DrawEllipse(x - radius, y - radius, 2 * radius, 2 * radius);
+}
+
+void DisplayListDeviceContext::DrawEllipse(int x, int y, int width, int height)
+{
+    this->WritePen();
+    this->WriteBrush();
+    this->WriteOp(DL_ELLIPSE);
+    this->WritePoint(x, y);
+    this->WriteSigned(width);
+    this->WriteSigned(height);
+}
+
+void DisplayListDeviceContext::DrawEllipticArc(int x, int y, int width, int height, double start, double end)
+{
+    this->WritePen();
+    this->WriteBrush();
+    this->WriteOp(DL_ARC);
+    this->WritePoint(x, y);
+    this->WriteSigned(width);
+    this->WriteSigned(height);
+    this->WriteFloat((float)start);
+    this->WriteFloat((float)end);
+}
+
+void DisplayListDeviceContext::DrawLine(int x1, int y1, int x2, int y2)
+{
+    this->WritePen();
+    this->WriteOp(DL_LINE);
+    this->WritePoint(x1, y1);
+    this->WritePoint(x2, y2);
+}
+
+void DisplayListDeviceContext::DrawPolygon(int n, Point points[], int xOffset, int yOffset, int fillStyle)
+{
+    this->WritePen();
+    this->WriteBrush();
+    this->WriteOp(DL_POLYGON);
+    this->WriteUnsigned(n);
+    for (int i = 0; i < n; ++i) {
+        this->WritePoint(points[i].x + xOffset, points[i].y + yOffset);
+    }
+}
+
+void DisplayListDeviceContext::DrawRectangle(int x, int y, int width, int height)
+{
+    DrawRoundedRectangle(x, y, width, height, 0);
+}
+
+void DisplayListDeviceContext::DrawRoundedRectangle(int x, int y, int width, int height, double radius)
+{
+    this->WriteBrush();
+    this->WriteOp(DL_RECTANGLE);
+    this->WritePoint(x, y);
+    this->WriteSigned(width);
+    this->WriteSigned(height);
+    this->WriteSigned((int)radius);
+}
+
+void DisplayListDeviceContext::DrawMusicText(const std::wstring &text, int x, int y, bool setSmuflGlyph)
+{
+    assert(m_fontStack.top());
+
+    this->WriteFont();
+
+    int w, h, gx, gy;
+
+    // one glyph per char, advanced as in the SVG
+    for (unsigned int i = 0; i < text.length(); ++i) {
+        wchar_t c = text.at(i);
+        Glyph *glyph = Resources::GetGlyph(c);
+        if (!glyph) {
+            continue;
+        }
+
+        this->WriteOp(DL_GLYPH);
+        this->WritePoint(x, y);
+        this->WriteUnsigned((unsigned int)c);
+
+        if (glyph->GetHorizAdvX() > 0)
+            x += glyph->GetHorizAdvX() * m_fontStack.top()->GetPointSize() / glyph->GetUnitsPerEm();
+        else {
+            glyph->GetBoundingBox(gx, gy, w, h);
+            x += w * m_fontStack.top()->GetPointSize() / glyph->GetUnitsPerEm();
+        }
+    }
+}
+
+void DisplayListDeviceContext::DrawSvgShape(int x, int y, int width, int height, pugi::xml_node svg)
+{
+    std::ostringstream stream;
+    svg.print(stream, "", pugi::format_raw);
+
+    this->WriteOp(DL_SVG_SHAPE);
+    this->WritePoint(x, y);
+    this->WriteSigned(width);
+    this->WriteSigned(height);
+    this->WriteString(stream.str());
+}
+
+void DisplayListDeviceContext::StartText(int x, int y, data_HORIZONTALALIGNMENT alignment)
+{
+    this->WriteFont();
+    this->WriteOp(DL_TEXT);
+    this->WritePoint(x, y);
+    m_data.push_back((char)alignment);
+}
+
+void DisplayListDeviceContext::EndText()
+{
+    this->WriteOp(DL_END_TEXT);
+}
+
+void DisplayListDeviceContext::MoveTextTo(int x, int y, data_HORIZONTALALIGNMENT alignment)
+{
+    this->WriteOp(DL_MOVE_TEXT);
+    this->WritePoint(x, y);
+    m_data.push_back((char)alignment);
+}
+
+void DisplayListDeviceContext::MoveTextVerticallyTo(int y)
+{
+    this->WriteOp(DL_MOVE_TEXT_Y);
+    this->WriteSigned(y);
+}
+
+void DisplayListDeviceContext::DrawText(const std::string &text, const std::wstring wtext, int x, int y)
+{
+    this->WriteFont();
+    this->WriteOp(DL_TEXT_RUN);
+    bool hasPosition = ((x != VRV_UNSET) && (y != VRV_UNSET));
+    m_data.push_back((char)hasPosition);
+    if (hasPosition) this->WritePoint(x, y);
+    this->WriteString(text);
+}
+
+//----------------------------------------------------------------------------
+// Reference decoder
+//----------------------------------------------------------------------------
+
+/**
+ * Read the values of a display list (see DisplayListDeviceContext::WriteUnsigned and others).
+ * All the methods set m_valid to false when reading beyond the end.
+ */
+class DisplayListReader {
+public:
+    DisplayListReader(const std::string &data, size_t pos)
+        : m_data(data), m_pos(pos), m_valid(true), m_lastX(0), m_lastY(0)
+    {
+    }
+
+    bool AtEnd() const { return (m_pos >= m_data.size()); }
+    bool IsValid() const { return m_valid; }
+
+    unsigned char ReadByte()
+    {
+        if (m_pos >= m_data.size()) {
+            m_valid = false;
+            return 0;
+        }
+        return (unsigned char)m_data[m_pos++];
+    }
+
+    unsigned int ReadUnsigned()
+    {
+        unsigned int value = 0;
+        int shift = 0;
+        unsigned char byte;
+        do {
+            byte = this->ReadByte();
+            if (shift < 32) value |= (unsigned int)(byte & 0x7F) << shift;
+            shift += 7;
+        } while ((byte & 0x80) && m_valid);
+        return value;
+    }
+
+    int ReadSigned()
+    {
+        unsigned int value = this->ReadUnsigned();
+        return (int)(value >> 1) ^ -(int)(value & 1);
+    }
+
+    float ReadFloat()
+    {
+        unsigned int bits = 0;
+        for (int i = 0; i < 4; ++i) bits |= (unsigned int)this->ReadByte() << (8 * i);
+        float value;
+        memcpy(&value, &bits, 4);
+        return value;
+    }
+
+    std::string ReadString()
+    {
+        unsigned int length = this->ReadUnsigned();
+        if (!m_valid || (length > m_data.size() - m_pos)) {
+            m_valid = false;
+            return "";
+        }
+        std::string value = m_data.substr(m_pos, length);
+        m_pos += length;
+        return value;
+    }
+
+    std::string ReadInterned()
+    {
+        unsigned int index = this->ReadUnsigned();
+        if (index == m_strings.size()) {
+            m_strings.push_back(this->ReadString());
+        }
+        else if (index > m_strings.size()) {
+            m_valid = false;
+            return "";
+        }
+        return m_strings.at(index);
+    }
+
+    Point ReadPoint()
+    {
+        m_lastX += this->ReadSigned();
+        m_lastY += this->ReadSigned();
+        return Point(m_lastX, m_lastY);
+    }
+
+private:
+    const std::string &m_data;
+    size_t m_pos;
+    bool m_valid;
+    int m_lastX, m_lastY;
+    std::vector<std::string> m_strings;
+};
+
+bool DisplayListDeviceContext::Replay(const std::string &displayList, DeviceContext *dc)
+{
+    assert(dc);
+
+    if ((displayList.size() < 5) || (displayList.compare(0, 4, "VRDL") != 0) || (displayList[4] != 1)) {
+        LogError("The data is not a display list (version 1)");
+        return false;
+    }
+
+    // Skip the header
+    DisplayListReader reader(displayList, 5);
+
+    // The current values, pushed on the stacks of the device context for each drawing operation
+    Pen pen(AxNONE, 1, 1.0, 0);
+    Brush brush(AxNONE, 1.0);
+    FontInfo font;
+    FontInfo textFont;
+    FontInfo runFont;
+    // The groups opened (0: group, 1: resumed, 2: text group skipped)
+    std::vector<int> groups;
+
+    while (!reader.AtEnd() && reader.IsValid()) {
+        unsigned char op = reader.ReadByte();
+        switch (op) {
+            case DL_PAGE: {
+                int width = reader.ReadSigned();
+                int height = reader.ReadSigned();
+                int viewBoxWidth = reader.ReadSigned();
+                reader.ReadSigned();
+                float userScale = reader.ReadFloat();
+                int originX = reader.ReadSigned();
+                int originY = reader.ReadSigned();
+                dc->SetWidth(width);
+                dc->SetHeight(height);
+                dc->SetUserScale(userScale, userScale);
+                if (dc->Is(SVG_DEVICE_CONTEXT) && (viewBoxWidth == width) && (width != 0)) {
+                    SvgDeviceContext *svg = dynamic_cast<SvgDeviceContext *>(dc);
+                    assert(svg);
+                    svg->SetFacsimile(true);
+                }
+                dc->SetLogicalOrigin(-originX, -originY);
+                dc->StartPage();
+                break;
+            }
+            case DL_END_PAGE: dc->EndPage(); break;
+            case DL_GROUP: {
+                unsigned char flags = reader.ReadByte();
+                std::string gClass = reader.ReadInterned();
+                std::string gId = (flags & DL_GROUP_ID) ? reader.ReadString() : "";
+                if (flags & DL_GROUP_COLOUR) reader.ReadString();
+                if (flags & DL_GROUP_TEXT) {
+                    groups.push_back(2);
+                }
+                else {
+                    dc->StartCustomGraphic(gClass, "", gId);
+                    groups.push_back(0);
+                }
+                break;
+            }
+            case DL_END_GROUP: {
+                if (groups.empty()) {
+                    LogError("Unbalanced group in the display list");
+                    return false;
+                }
+                if (groups.back() == 0) {
+                    dc->EndCustomGraphic();
+                }
+                else if (groups.back() == 1) {
+                    dc->EndResumedGraphic(NULL, NULL);
+                }
+                groups.pop_back();
+                break;
+            }
+            case DL_RESUME_GROUP: {
+                dc->ResumeGraphic(NULL, reader.ReadString());
+                groups.push_back(1);
+                break;
+            }
+            case DL_ROTATE: {
+                Point orig = reader.ReadPoint();
+                dc->RotateGraphic(orig, reader.ReadFloat());
+                break;
+            }
+            case DL_PEN: {
+                pen.SetColour(reader.ReadSigned());
+                pen.SetWidth(reader.ReadSigned());
+                pen.SetDashLength(reader.ReadSigned());
+                pen.SetOpacity(reader.ReadByte() / 255.0f);
+                break;
+            }
+            case DL_BRUSH: {
+                brush.SetColour(reader.ReadSigned());
+                brush.SetOpacity(reader.ReadByte() / 255.0f);
+                break;
+            }
+            case DL_FONT: {
+                font.SetPointSize(reader.ReadSigned());
+                font.SetStyle((data_FONTSTYLE)reader.ReadByte());
+                font.SetWeight((data_FONTWEIGHT)reader.ReadByte());
+                font.SetFaceName(reader.ReadInterned().c_str());
+                break;
+            }
+            case DL_TEXT: {
+                Point point = reader.ReadPoint();
+                data_HORIZONTALALIGNMENT alignment = (data_HORIZONTALALIGNMENT)reader.ReadByte();
+                textFont = font;
+                dc->SetFont(&textFont);
+                dc->StartText(point.x, point.y, alignment);
+                break;
+            }
+            case DL_TEXT_RUN: {
+                bool hasPosition = (reader.ReadByte() != 0);
+                Point point(VRV_UNSET, VRV_UNSET);
+                if (hasPosition) point = reader.ReadPoint();
+                std::string text = reader.ReadString();
+                runFont = font;
+                dc->SetFont(&runFont);
+                dc->DrawText(text, UTF8to16(text), point.x, point.y);
+                dc->ResetFont();
+                break;
+            }
+            case DL_MOVE_TEXT: {
+                Point point = reader.ReadPoint();
+                dc->MoveTextTo(point.x, point.y, (data_HORIZONTALALIGNMENT)reader.ReadByte());
+                break;
+            }
+            case DL_MOVE_TEXT_Y: dc->MoveTextVerticallyTo(reader.ReadSigned()); break;
+            case DL_END_TEXT: {
+                dc->EndText();
+                dc->ResetFont();
+                break;
+            }
+            default: {
+                // Drawing operations with the current pen, brush and font
+                dc->SetPen(pen.GetColour(), pen.GetWidth(), (pen.GetOpacity() > 0) ? AxSOLID : AxTRANSPARENT,
+                    pen.GetDashLength());
+                dc->SetBrush(brush.GetColour(), (brush.GetOpacity() > 0) ? AxSOLID : AxTRANSPARENT);
+                runFont = font;
+                dc->SetFont(&runFont);
+                switch (op) {
+                    case DL_LINE: {
+                        Point p1 = reader.ReadPoint();
+                        Point p2 = reader.ReadPoint();
+                        dc->DrawLine(p1.x, p1.y, p2.x, p2.y);
+                        break;
+                    }
+                    case DL_POLYGON: {
+                        unsigned int n = reader.ReadUnsigned();
+                        std::vector<Point> points;
+                        for (unsigned int i = 0; (i < n) && reader.IsValid(); ++i) points.push_back(reader.ReadPoint());
+                        if (!points.empty()) dc->DrawPolygon((int)points.size(), &points[0]);
+                        break;
+                    }
+                    case DL_RECTANGLE: {
+                        Point point = reader.ReadPoint();
+                        int width = reader.ReadSigned();
+                        int height = reader.ReadSigned();
+                        dc->DrawRoundedRectangle(point.x, point.y, width, height, reader.ReadSigned());
+                        break;
+                    }
+                    case DL_ELLIPSE: {
+                        Point point = reader.ReadPoint();
+                        int width = reader.ReadSigned();
+                        dc->DrawEllipse(point.x, point.y, width, reader.ReadSigned());
+                        break;
+                    }
+                    case DL_ARC: {
+                        Point point = reader.ReadPoint();
+                        int width = reader.ReadSigned();
+                        int height = reader.ReadSigned();
+                        float start = reader.ReadFloat();
+                        dc->DrawEllipticArc(point.x, point.y, width, height, start, reader.ReadFloat());
+                        break;
+                    }
+                    case DL_BEZIER: {
+                        Point bezier1[4];
+                        Point bezier2[4];
+                        for (int i = 0; i < 4; ++i) bezier1[i] = reader.ReadPoint();
+                        bezier2[3] = bezier1[3];
+                        for (int i = 2; i >= 0; --i) bezier2[i] = reader.ReadPoint();
+                        dc->DrawComplexBezierPath(bezier1, bezier2);
+                        break;
+                    }
+                    case DL_GLYPH: {
+                        Point point = reader.ReadPoint();
+                        std::wstring glyph(1, (wchar_t)reader.ReadUnsigned());
+                        dc->DrawMusicText(glyph, point.x, point.y);
+                        break;
+                    }
+                    case DL_SVG_SHAPE: {
+                        Point point = reader.ReadPoint();
+                        int width = reader.ReadSigned();
+                        int height = reader.ReadSigned();
+                        pugi::xml_document svg;
+                        svg.load_string(reader.ReadString().c_str());
+                        dc->DrawSvgShape(point.x, point.y, width, height, svg.first_child());
+                        break;
+                    }
+                    default: {
+                        LogError("Unknown operation %d in the display list", op);
+                        return false;
+                    }
+                }
+                dc->ResetFont();
+                dc->ResetBrush();
+                dc->ResetPen();
+            }
+        }
+    }
+
+    if (!reader.IsValid()) {
+        LogError("The display list is truncated");
+        return false;
+    }
+    return true;
+}
+
+} // namespace vrv
@@ -9,6 +9,7 @@
 
 //----------------------------------------------------------------------------
 
+#include <algorithm>
 #include <assert.h>
 #include <math.h>
 
@@ -17,6 +18,7 @@
 #include "barline.h"
 #include "beatrpt.h"
 #include "chord.h"
+#include "clef.h"
 #include "comparison.h"
 #include "functorparams.h"
 #include "glyph.h"
@@ -51,6 +53,7 @@
 #include "syl.h"
 #include "system.h"
 #include "text.h"
+#include "timeinterface.h"
 #include "timestamp.h"
 #include "verse.h"
 #include "vrv.h"
@@ -59,6 +62,10 @@
 
 #include "MidiFile.h"
 
+// The range of SMuFL codes (private use area) for which the glyph metrics are cached
+#define SMUFL_CACHE_FIRST 0xE000
+#define SMUFL_CACHE_LAST 0xF8FF
+
 namespace vrv {
 
 //----------------------------------------------------------------------------
@@ -96,15 +103,35 @@ void Doc::Reset()
     m_MIDITimemapTempo = 0.0;
     m_hasAnalyticalMarkup = false;
     m_isMensuralMusicOnly = false;
+    m_isLayoutDirty = false;
+    m_castOffPgHeadHeight = VRV_UNSET;
+    m_castOffPgFootHeight = VRV_UNSET;
+    m_castOffPgHead2Height = VRV_UNSET;
+    m_castOffPgFoot2Height = VRV_UNSET;
+    m_castOffPendingPage = NULL;
+    m_castOffSystemWidth = VRV_UNSET;
+    m_castOffLabelsWidth = VRV_UNSET;
+    m_castOffAbbrLabelsWidth = VRV_UNSET;
+    m_castOffScoreDefWidth = VRV_UNSET;
 
     m_scoreDef.Reset();
 
     m_drawingSmuflFontSize = 0;
     m_drawingLyricFontSize = 0;
 
+    this->SetDrawingMargins();
+    m_glyphMetrics.clear();
+    m_glyphMetricsFontVersion = VRV_UNSET;
+    m_glyphMetricsFontSize = VRV_UNSET;
+    m_glyphMetricsGraceFactor = VRV_UNSET;
+    m_measureIndex.clear();
+    m_measurePositions.clear();
+
     m_header.reset();
     m_front.reset();
     m_back.reset();
+
+    m_layerClefs.clear();
 }
 
 void Doc::SetType(DocType type)
@@ -127,6 +154,31 @@ void Doc::AddChild(Object *child)
     Modify();
 }
 
+Clef *Doc::GetClefBeforeLayer(Layer *layer)
+{
+    // The document has been modified since the table was built (or it has never been)
+    if (this->IsModified()) {
+        m_layerClefs.clear();
+        ArrayOfObjects objects;
+        ClassIdsComparison matchType({ CLEF, LAYER });
+        this->FindAllChildByComparison(&objects, &matchType);
+        Clef *clef = NULL;
+        for (auto &object : objects) {
+            if (object->Is(CLEF)) {
+                clef = dynamic_cast<Clef *>(object);
+                assert(clef);
+            }
+            else {
+                m_layerClefs[object] = clef;
+            }
+        }
+        this->Modify(false);
+    }
+
+    MapOfObjectClefs::iterator iter = m_layerClefs.find(layer);
+    return (iter != m_layerClefs.end()) ? iter->second : NULL;
+}
+
 void Doc::Refresh()
 {
     RefreshViews();
@@ -479,18 +531,13 @@ void Doc::PrepareDrawing()
 
     /************ Resolve @starid / @endid ************/
 
-    // Try to match all spanning elements (slur, tie, etc) by processing backwards
+    // Stack all spanning elements (slur, tie, etc) by the uuid of their start and end
     PrepareTimeSpanningParams prepareTimeSpanningParams;
     Functor prepareTimeSpanning(&Object::PrepareTimeSpanning);
-    Functor prepareTimeSpanningEnd(&Object::PrepareTimeSpanningEnd);
-    this->Process(
-        &prepareTimeSpanning, &prepareTimeSpanningParams, &prepareTimeSpanningEnd, NULL, UNLIMITED_DEPTH, BACKWARD);
+    this->Process(&prepareTimeSpanning, &prepareTimeSpanningParams);
 
-    // First we try backwards because normally the spanning elements are at the end of
-    // the measure. However, in some case, one (or both) end points will appear afterwards
-    // in the encoding. For these, the previous iteration will not have resolved the link and
-    // the spanning elements will remain in the timeSpanningElements array. We try again forwards
-    // but this time without filling the list (that is only will the remaining elements)
+    // Then match them when processing the layer elements. Since all of them are stacked first, the start and end
+    // elements can appear anywhere in the encoding and each one is matched with a look-up
     if (!prepareTimeSpanningParams.m_timeSpanningInterfaces.empty()) {
         prepareTimeSpanningParams.m_fillList = false;
         this->Process(&prepareTimeSpanning, &prepareTimeSpanningParams);
@@ -521,43 +568,40 @@ void Doc::PrepareDrawing()
 
     /************ Resolve linking (@next) ************/
 
-    // Try to match all pointing elements using @next and @sameas
+    // Try to match all pointing elements using @next and @sameas - stacked first and then matched
     PrepareLinkingParams prepareLinkingParams;
     Functor prepareLinking(&Object::PrepareLinking);
     this->Process(&prepareLinking, &prepareLinkingParams);
 
-    // If we have some left process again backward
-    if (!prepareLinkingParams.m_sameasUuidPairs.empty()) {
+    if (!prepareLinkingParams.m_nextInterfaces.empty() || !prepareLinkingParams.m_sameasInterfaces.empty()) {
         prepareLinkingParams.m_fillList = false;
-        this->Process(&prepareLinking, &prepareLinkingParams, NULL, NULL, UNLIMITED_DEPTH, BACKWARD);
+        this->Process(&prepareLinking, &prepareLinkingParams);
     }
 
     // If some are still there, then it is probably an issue in the encoding
-    if (!prepareLinkingParams.m_nextUuidPairs.empty()) {
-        LogWarning("%d element(s) with a @next could match the target", prepareLinkingParams.m_nextUuidPairs.size());
+    if (!prepareLinkingParams.m_nextInterfaces.empty()) {
+        LogWarning("%d element(s) with a @next could match the target", prepareLinkingParams.m_nextInterfaces.size());
     }
-    if (!prepareLinkingParams.m_sameasUuidPairs.empty()) {
+    if (!prepareLinkingParams.m_sameasInterfaces.empty()) {
         LogWarning(
-            "%d element(s) with a @sameas could match the target", prepareLinkingParams.m_sameasUuidPairs.size());
+            "%d element(s) with a @sameas could match the target", prepareLinkingParams.m_sameasInterfaces.size());
     }
 
     /************ Resolve @plist ************/
 
-    // Try to match all pointing elements using @plist
+    // Try to match all pointing elements using @plist - stacked first and then matched
     PreparePlistParams preparePlistParams;
     Functor preparePlist(&Object::PreparePlist);
     this->Process(&preparePlist, &preparePlistParams);
 
-    // If we have some left process again backward.
-    if (!preparePlistParams.m_interfaceUuidPairs.empty()) {
+    if (!preparePlistParams.m_interfaces.empty()) {
         preparePlistParams.m_fillList = false;
-        this->Process(&preparePlist, &preparePlistParams, NULL, NULL, UNLIMITED_DEPTH, BACKWARD);
+        this->Process(&preparePlist, &preparePlistParams);
     }
 
     // If some are still there, then it is probably an issue in the encoding
-    if (!preparePlistParams.m_interfaceUuidPairs.empty()) {
-        LogWarning(
-            "%d element(s) with a @plist could match the target", preparePlistParams.m_interfaceUuidPairs.size());
+    if (!preparePlistParams.m_interfaces.empty()) {
+        LogWarning("%d element(s) with a @plist could match the target", preparePlistParams.m_interfaces.size());
     }
 
     /************ Resolve cross staff ************/
@@ -777,30 +821,172 @@ void Doc::CastOffDoc()
         return;
     }
 
-    // By default, optimize scores
-    bool optimize = (m_scoreDef.GetOptimize() != BOOLEAN_false);
-    // However, if nothing specified, do not if there is only one staffGrp
-    if ((m_scoreDef.GetOptimize() == BOOLEAN_NONE) && (m_scoreDef.GetChildCount(STAFFGRP, UNLIMITED_DEPTH) < 2)) {
-        optimize = false;
-    }
-
     this->SetCurrentScoreDefDoc();
 
     Page *contentPage = this->SetDrawingPage(0);
     assert(contentPage);
     contentPage->LayOutHorizontally();
 
+    System *contentSystem = dynamic_cast<System *>(contentPage->GetChild(0));
+    assert(contentSystem);
+
+    // Store the measure widths and overflows used for casting off the systems, and the widths of the labels and
+    // of the initial scoreDef for casting them off again in Doc::RebreakDoc
+    ArrayOfObjects::const_iterator iter;
+    for (iter = contentSystem->GetChildren()->begin(); iter != contentSystem->GetChildren()->end(); ++iter) {
+        if ((*iter)->Is(MEASURE)) dynamic_cast<Measure *>(*iter)->StoreCastOffValues();
+    }
+    m_castOffLabelsWidth = contentSystem->GetDrawingLabelsWidth();
+    m_castOffAbbrLabelsWidth = contentSystem->GetDrawingAbbrLabelsWidth();
+    m_castOffScoreDefWidth = contentPage->m_drawingScoreDef.GetDrawingWidth();
+
+    this->CastOffSystemsDoc(contentPage, false);
+    this->CastOffPagesDoc(contentPage);
+}
+
+void Doc::CastOffDocProgressive(int pageCount)
+{
+    Pages *pages = this->GetPages();
+    assert(pages);
+
+    if (!m_castOffPendingPage) {
+        if (pages->GetChildCount() != 1) {
+            LogDebug("Document is already cast off");
+            return;
+        }
+
+        this->SetCurrentScoreDefDoc();
+
+        Page *contentPage = this->SetDrawingPage(0);
+        assert(contentPage);
+        System *contentSystem = dynamic_cast<System *>(contentPage->GetChild(0));
+        assert(contentSystem);
+        // Nothing to cast off by chunks
+        if (contentSystem->GetChildCount(MEASURE) == 0) {
+            this->CastOffDoc();
+            return;
+        }
+        m_castOffSystemWidth
+            = this->m_drawingPageWidth - this->m_drawingPageMarginLeft - this->m_drawingPageMarginRight;
+
+        // Calculate the running element heights with the content page detached
+        pages->DetachChild(0);
+        this->ResetDrawingPage();
+        CastOffPagesParams castOffPagesParams(contentPage, this, NULL);
+        CastOffRunningElements(&castOffPagesParams);
+        m_castOffPgHeadHeight = castOffPagesParams.m_pgHeadHeight;
+        m_castOffPgFootHeight = castOffPagesParams.m_pgFootHeight;
+        m_castOffPgHead2Height = castOffPagesParams.m_pgHead2Height;
+        m_castOffPgFoot2Height = castOffPagesParams.m_pgFoot2Height;
+        pages->AddChild(contentPage);
+
+        m_castOffPendingPage = contentPage;
+        m_isLayoutDirty = false;
+    }
+
+    int chunkSize = 16;
+    while (m_castOffPendingPage && ((pageCount == 0) || (this->GetPageCount() < pageCount))) {
+        // The pending page is detached while the chunk is cast off
+        Page *pendingPage = m_castOffPendingPage;
+        m_castOffPendingPage = NULL;
+        pages->DetachChild(pendingPage->GetIdx());
+        System *pendingSystem = dynamic_cast<System *>(pendingPage->GetChild(0));
+        assert(pendingSystem);
+
+        int pageCountBefore = pages->GetChildCount();
+        Page *lastPage = dynamic_cast<Page *>(pages->GetLast());
+        if (!lastPage) {
+            lastPage = new Page();
+            pages->AddChild(lastPage);
+        }
+
+        // Move the measures of the previous chunk (still dirty) and the next ones to a new system on the last
+        // page, and mark them as dirty so Doc::RecastOffDoc lays them out and casts them off
+        System *system = new System();
+        lastPage->AddChild(system);
+        int measureCount = 0;
+        int i;
+        for (i = 0; i < pendingSystem->GetChildCount(); ++i) {
+            Object *child = pendingSystem->GetChild(i);
+            if (child->Is(MEASURE)) {
+                Measure *measure = dynamic_cast<Measure *>(child);
+                assert(measure);
+                if (!measure->IsLayoutDirty()) {
+                    if ((pageCount != 0) && (measureCount == chunkSize)) break;
+                    measure->SetLayoutDirty(true);
+                    ++measureCount;
+                }
+            }
+            system->AddChild(pendingSystem->Relinquish(i));
+        }
+        pendingSystem->ClearRelinquishedChildren();
+
+        if (!this->RecastOffDoc()) {
+            LogError("The document could not be cast off progressively");
+        }
+
+        if (pendingSystem->GetChildCount() == 0) {
+            delete pendingPage;
+            break;
+        }
+
+        // Move the last page back to the pending page since it can still be completed with the next measures
+        lastPage = dynamic_cast<Page *>(pages->GetLast());
+        assert(lastPage);
+        int idx = 0;
+        ArrayOfObjects::const_iterator systemIter;
+        ArrayOfObjects::const_iterator iter;
+        for (systemIter = lastPage->GetChildren()->begin(); systemIter != lastPage->GetChildren()->end();
+             ++systemIter) {
+            for (iter = (*systemIter)->GetChildren()->begin(); iter != (*systemIter)->GetChildren()->end(); ++iter) {
+                if ((*iter)->Is(MEASURE)) dynamic_cast<Measure *>(*iter)->SetLayoutDirty(true);
+            }
+            int count = (*systemIter)->GetChildCount();
+            pendingSystem->MoveChildrenFrom(*systemIter, idx);
+            idx += count;
+        }
+        pages->DeleteChild(lastPage);
+        pages->AddChild(pendingPage);
+        m_castOffPendingPage = pendingPage;
+
+        // Take more measures if no page was completed
+        if (pages->GetChildCount() - 1 <= pageCountBefore) chunkSize *= 2;
+    }
+}
+
+void Doc::CastOffSystemsDoc(Page *contentPage, bool useCastOffWidths)
+{
+    assert(contentPage);
+
+    bool optimize = this->IsCastOffOptimized();
+
     System *contentSystem = dynamic_cast<System *>(contentPage->DetachChild(0));
     assert(contentSystem);
 
+    ArrayOfObjects::const_iterator iter;
+    // Place the measures as in the content system using the stored widths since it was not laid out
+    if (useCastOffWidths) {
+        int xRel = 0;
+        for (iter = contentSystem->GetChildren()->begin(); iter != contentSystem->GetChildren()->end(); ++iter) {
+            if (!(*iter)->Is(MEASURE)) continue;
+            Measure *measure = dynamic_cast<Measure *>(*iter);
+            assert(measure);
+            measure->SetDrawingXRel(xRel);
+            xRel += measure->GetCastOffWidth();
+        }
+        contentSystem->SetDrawingLabelsWidth(m_castOffLabelsWidth);
+        contentSystem->SetDrawingAbbrLabelsWidth(m_castOffAbbrLabelsWidth);
+    }
+
     System *currentSystem = new System();
     contentPage->AddChild(currentSystem);
     CastOffSystemsParams castOffSystemsParams(contentSystem, contentPage, currentSystem, this);
     castOffSystemsParams.m_systemWidth = this->m_drawingPageWidth - this->m_drawingPageMarginLeft
         - this->m_drawingPageMarginRight - currentSystem->m_systemLeftMar - currentSystem->m_systemRightMar;
-    castOffSystemsParams.m_shift = -contentSystem->GetDrawingLabelsWidth();
-    castOffSystemsParams.m_currentScoreDefWidth
-        = contentPage->m_drawingScoreDef.GetDrawingWidth() + contentSystem->GetDrawingAbbrLabelsWidth();
+    m_castOffSystemWidth = this->m_drawingPageWidth - this->m_drawingPageMarginLeft - this->m_drawingPageMarginRight;
+    castOffSystemsParams.m_shift = -m_castOffLabelsWidth;
+    castOffSystemsParams.m_currentScoreDefWidth = m_castOffScoreDefWidth + m_castOffAbbrLabelsWidth;
+    currentSystem->SetCastOffScoreDefWidth(castOffSystemsParams.m_currentScoreDefWidth);
 
     Functor castOffSystems(&Object::CastOffSystems);
     Functor castOffSystemsEnd(&Object::CastOffSystemsEnd);
@@ -817,6 +1003,20 @@ void Doc::CastOffDoc()
     // We can actually optimise this and have a custom version that does not redo all the calculation
     contentPage->LayOutVertically();
 
+    // Store the system heights used for casting off the pages
+    for (iter = contentPage->GetChildren()->begin(); iter != contentPage->GetChildren()->end(); ++iter) {
+        dynamic_cast<System *>(*iter)->StoreCastOffHeight();
+    }
+}
+
+void Doc::CastOffPagesDoc(Page *contentPage)
+{
+    Pages *pages = this->GetPages();
+    assert(pages);
+    assert(contentPage && (pages->GetChildCount() == 1) && (pages->GetChild(0) == contentPage));
+
+    bool optimize = this->IsCastOffOptimized();
+
     // Detach the contentPage
     pages->DetachChild(0);
     assert(contentPage && !contentPage->GetParent());
@@ -825,7 +1025,15 @@ void Doc::CastOffDoc()
     Page *currentPage = new Page();
     CastOffPagesParams castOffPagesParams(contentPage, this, currentPage);
     CastOffRunningElements(&castOffPagesParams);
+    // Keep the running element heights for Doc::RecastOffDoc
+    m_castOffPgHeadHeight = castOffPagesParams.m_pgHeadHeight;
+    m_castOffPgFootHeight = castOffPagesParams.m_pgFootHeight;
+    m_castOffPgHead2Height = castOffPagesParams.m_pgHead2Height;
+    m_castOffPgFoot2Height = castOffPagesParams.m_pgFoot2Height;
     castOffPagesParams.m_pageHeight = this->m_drawingPageHeight - this->m_drawingPageMarginBot;
+    // The first system is placed below the header (see Page::AlignSystems)
+    castOffPagesParams.m_contentYRel = this->m_drawingPageHeight - castOffPagesParams.m_pgHeadHeight;
+    castOffPagesParams.m_systemMargin = (m_options->m_spacingSystem.GetValue()) * this->GetDrawingUnit(100);
     Functor castOffPages(&Object::CastOffPages);
     pages->AddChild(currentPage);
     contentPage->Process(&castOffPages, &castOffPagesParams);
@@ -835,6 +1043,374 @@ void Doc::CastOffDoc()
     if (optimize) {
         this->OptimizeScoreDefDoc(false);
     }
+
+    m_isLayoutDirty = false;
+}
+
+bool Doc::RecastOffDoc()
+{
+    Pages *pages = this->GetPages();
+    assert(pages);
+
+    if (m_isLayoutDirty || m_castOffPendingPage || (m_castOffPgHeadHeight == VRV_UNSET)) {
+        return false;
+    }
+
+    // Check that all the systems and measures have their cast off values and look for the dirty ones
+    std::vector<System *> systems;
+    int firstDirty = VRV_UNSET;
+    int lastDirty = VRV_UNSET;
+    if (!this->FindDirtySystems(systems, firstDirty, lastDirty)) {
+        return false;
+    }
+
+    // Nothing to do
+    if (firstDirty == VRV_UNSET) {
+        return true;
+    }
+
+    bool optimize = this->IsCastOffOptimized();
+    ArrayOfObjects::const_iterator iter;
+
+    // We start from the system before the first dirty one since its last measure can now fit in it
+    int restart = std::max(0, firstDirty - 1);
+    Page *restartPage = dynamic_cast<Page *>(systems.at(restart)->GetParent());
+    assert(restartPage);
+    int restartPageIdx = restartPage->GetIdx();
+    // The scoreDef at the beginning of the page that is cast off again
+    ScoreDef upcomingScoreDef = restartPage->m_drawingScoreDef;
+    int scoreDefWidth = systems.at(restart)->GetCastOffScoreDefWidth();
+    // The number of systems kept before on the restart page
+    int restartSystemIdx = systems.at(restart)->GetIdx();
+
+    // Move the content of the systems up to the last dirty one to a content page placed after the restart page,
+    // or before it when starting from the beginning since the first page has its own scoreDef drawing flags
+    int contentPageIdx = (restart == 0) ? 0 : restartPageIdx + 1;
+    Page *contentPage = new Page();
+    System *contentSystem = new System();
+    contentPage->AddChild(contentSystem);
+    contentPage->SetParent(pages);
+    pages->InsertChild(contentPage, contentPageIdx);
+    int i;
+    for (i = restart; i <= lastDirty; ++i) {
+        contentSystem->MoveChildrenFrom(systems.at(i));
+        systems.at(i)->GetParent()->DeleteChild(systems.at(i));
+    }
+
+    // The pages laid out for rendering have their measures justified and are cast off again from the restart
+    // page, so we redo the horizontal layout of their remaining systems as in Doc::RebreakDoc
+    for (i = 0; i < pages->GetChildCount(); ++i) {
+        Page *page = dynamic_cast<Page *>(pages->GetChild(i));
+        assert(page);
+        if ((i < restartPageIdx) || (page == contentPage) || !page->IsLayoutDone()) continue;
+        this->SetDrawingPage(i);
+        page->LayOutHorizontally();
+    }
+    this->ResetDrawingPage();
+
+    // Cast off the systems and add the content of the next ones until a system break occurs where a previous
+    // system starts. The systems added have been laid out on their own (and justified if their page was rendered),
+    // so once we know how far to go, everything is laid out and cast off again with the same system breaks.
+    Functor castOffSystems(&Object::CastOffSystems);
+    int nextSystem = lastDirty + 1;
+    bool addSystems = true;
+    while (true) {
+        this->SetCurrentScoreDefFromPage(restartPageIdx, upcomingScoreDef, false);
+
+        // Lay out the content and store the values of the dirty measures only - the other ones keep the values
+        // of the content system they were laid out in (the first one would have the system scoreDef in addition)
+        this->SetDrawingPage(contentPageIdx);
+        contentPage->LayOutHorizontally();
+        for (iter = contentSystem->GetChildren()->begin(); iter != contentSystem->GetChildren()->end(); ++iter) {
+            Measure *measure = dynamic_cast<Measure *>(*iter);
+            if (measure && measure->IsLayoutDirty()) measure->StoreCastOffValues();
+        }
+
+        contentPage->DetachChild(0);
+        System *currentSystem = new System();
+        contentPage->AddChild(currentSystem);
+        CastOffSystemsParams castOffSystemsParams(contentSystem, contentPage, currentSystem, this);
+        castOffSystemsParams.m_systemWidth = this->m_drawingPageWidth - this->m_drawingPageMarginLeft
+            - this->m_drawingPageMarginRight - currentSystem->m_systemLeftMar - currentSystem->m_systemRightMar;
+        if (restart == 0) {
+            m_castOffLabelsWidth = contentSystem->GetDrawingLabelsWidth();
+            m_castOffAbbrLabelsWidth = contentSystem->GetDrawingAbbrLabelsWidth();
+            m_castOffScoreDefWidth = contentPage->m_drawingScoreDef.GetDrawingWidth();
+            castOffSystemsParams.m_shift = -m_castOffLabelsWidth;
+            scoreDefWidth = m_castOffScoreDefWidth + m_castOffAbbrLabelsWidth;
+        }
+        castOffSystemsParams.m_currentScoreDefWidth = scoreDefWidth;
+        currentSystem->SetCastOffScoreDefWidth(scoreDefWidth);
+
+        int childIdx = 0;
+        int xRel = 0;
+        while (true) {
+            for (; childIdx < contentSystem->GetChildCount(); ++childIdx) {
+                Object *child = contentSystem->GetChild(childIdx);
+                // Place the measures as in the content system using the stored widths
+                if (child->Is(MEASURE)) {
+                    Measure *measure = dynamic_cast<Measure *>(child);
+                    assert(measure);
+                    measure->SetDrawingXRel(xRel);
+                    xRel += measure->GetCastOffWidth();
+                }
+                child->Process(&castOffSystems, &castOffSystemsParams);
+            }
+            if (!addSystems || (nextSystem >= (int)systems.size())) break;
+            // Same conditions as in Measure::CastOffSystems
+            Measure *firstMeasure = dynamic_cast<Measure *>(systems.at(nextSystem)->GetFirst());
+            if (firstMeasure && castOffSystemsParams.m_pendingObjects.empty()
+                && (firstMeasure->GetCastOffOverflow() <= (this->GetDrawingUnit(100) * 5))
+                && (xRel + firstMeasure->GetCastOffWidth() + castOffSystemsParams.m_currentScoreDefWidth
+                           - castOffSystemsParams.m_shift
+                       > castOffSystemsParams.m_systemWidth)) {
+                break;
+            }
+            contentSystem->MoveChildrenFrom(systems.at(nextSystem));
+            systems.at(nextSystem)->GetParent()->DeleteChild(systems.at(nextSystem));
+            ++nextSystem;
+        }
+        contentSystem->CastOffSystemsEnd(&castOffSystemsParams);
+        delete contentSystem;
+
+        if (!addSystems || (nextSystem == lastDirty + 1)) break;
+
+        // Move the content of the new systems back to a content system
+        addSystems = false;
+        contentSystem = new System();
+        for (iter = contentPage->GetChildren()->begin(); iter != contentPage->GetChildren()->end(); ++iter) {
+            contentSystem->MoveChildrenFrom(*iter);
+        }
+        contentPage->ClearChildren();
+        contentPage->AddChild(contentSystem);
+    }
+
+    this->SetCurrentScoreDefFromPage(restartPageIdx, upcomingScoreDef, optimize);
+
+    // Lay out the new systems vertically and store their heights
+    this->SetDrawingPage(contentPageIdx);
+    contentPage->LayOutVertically();
+    for (iter = contentPage->GetChildren()->begin(); iter != contentPage->GetChildren()->end(); ++iter) {
+        dynamic_cast<System *>(*iter)->StoreCastOffHeight();
+    }
+
+    // Detach the contentPage and move to it the systems of the restart page before and of the pages after
+    pages->DetachChild(contentPageIdx);
+    assert(contentPage && !contentPage->GetParent());
+    this->ResetDrawingPage();
+    for (i = 0; i < restartPage->GetChildCount(); ++i) {
+        Object *system = restartPage->Relinquish(i);
+        if (i < restartSystemIdx) {
+            system->SetParent(contentPage);
+            contentPage->InsertChild(system, i);
+        }
+        else {
+            contentPage->AddChild(system);
+        }
+    }
+    while (pages->GetChildCount() > restartPageIdx + 1) {
+        Object *page = pages->GetChild(restartPageIdx + 1);
+        contentPage->MoveChildrenFrom(page);
+        pages->DeleteChild(page);
+    }
+    pages->DeleteChild(restartPage);
+
+    Page *currentPage = new Page();
+    CastOffPagesParams castOffPagesParams(contentPage, this, currentPage);
+    castOffPagesParams.m_pgHeadHeight = (restartPageIdx == 0) ? m_castOffPgHeadHeight : VRV_UNSET;
+    castOffPagesParams.m_pgFootHeight = m_castOffPgFootHeight;
+    castOffPagesParams.m_pgHead2Height = m_castOffPgHead2Height;
+    castOffPagesParams.m_pgFoot2Height = m_castOffPgFoot2Height;
+    castOffPagesParams.m_pageHeight = this->m_drawingPageHeight - this->m_drawingPageMarginBot;
+    castOffPagesParams.m_contentYRel = this->m_drawingPageHeight;
+    if (restartPageIdx == 0) castOffPagesParams.m_contentYRel -= m_castOffPgHeadHeight;
+    castOffPagesParams.m_systemMargin = (m_options->m_spacingSystem.GetValue()) * this->GetDrawingUnit(100);
+    Functor castOffPages(&Object::CastOffPages);
+    pages->AddChild(currentPage);
+    contentPage->Process(&castOffPages, &castOffPagesParams);
+    delete contentPage;
+
+    this->SetCurrentScoreDefFromPage(restartPageIdx, upcomingScoreDef, optimize);
+
+    return true;
+}
+
+bool Doc::RebreakDoc()
+{
+    Pages *pages = this->GetPages();
+    assert(pages);
+
+    if (m_isLayoutDirty || m_castOffPendingPage || (m_castOffSystemWidth == VRV_UNSET)) {
+        return false;
+    }
+
+    // Edited measures need to be laid out horizontally again
+    std::vector<System *> systems;
+    int firstDirty = VRV_UNSET;
+    int lastDirty = VRV_UNSET;
+    if (!this->FindDirtySystems(systems, firstDirty, lastDirty) || (firstDirty != VRV_UNSET)) {
+        return false;
+    }
+
+    // Update the page dimensions from the options
+    this->ResetDrawingPage();
+    this->SetDrawingPage(0);
+    int systemWidth = this->m_drawingPageWidth - this->m_drawingPageMarginLeft - this->m_drawingPageMarginRight;
+    this->ResetDrawingPage();
+
+    // The systems are the same and only the pages need to be cast off again with the stored system heights
+    if (systemWidth == m_castOffSystemWidth) {
+        Page *contentPage = new Page();
+        std::vector<System *>::iterator iter;
+        for (iter = systems.begin(); iter != systems.end(); ++iter) {
+            Object *parent = (*iter)->GetParent();
+            contentPage->AddChild(parent->Relinquish((*iter)->GetIdx()));
+        }
+        pages->ClearChildren();
+        pages->AddChild(contentPage);
+        this->CastOffPagesDoc(contentPage);
+        return true;
+    }
+
+    // The pages laid out for rendering have their measures justified, so we redo their horizontal layout
+    ArrayOfObjects::const_iterator pageIter;
+    for (pageIter = pages->GetChildren()->begin(); pageIter != pages->GetChildren()->end(); ++pageIter) {
+        Page *page = dynamic_cast<Page *>(*pageIter);
+        assert(page);
+        if (!page->IsLayoutDone()) continue;
+        this->SetDrawingPage(page->GetIdx());
+        page->LayOutHorizontally();
+    }
+
+    // Cast off the systems again without laying out the measures, whose widths did not change
+    this->UnCastOffDoc();
+    Page *contentPage = this->SetDrawingPage(0);
+    assert(contentPage);
+    this->CastOffSystemsDoc(contentPage, true);
+    this->CastOffPagesDoc(contentPage);
+
+    return true;
+}
+
+bool Doc::FindDirtySystems(std::vector<System *> &systems, int &firstDirty, int &lastDirty)
+{
+    Pages *pages = this->GetPages();
+    assert(pages);
+
+    ArrayOfObjects::const_iterator pageIter;
+    ArrayOfObjects::const_iterator iter;
+    for (pageIter = pages->GetChildren()->begin(); pageIter != pages->GetChildren()->end(); ++pageIter) {
+        for (iter = (*pageIter)->GetChildren()->begin(); iter != (*pageIter)->GetChildren()->end(); ++iter) {
+            System *system = dynamic_cast<System *>(*iter);
+            if (!system) {
+                return false;
+            }
+            bool isDirty = false;
+            ArrayOfObjects::const_iterator childIter;
+            for (childIter = system->GetChildren()->begin(); childIter != system->GetChildren()->end(); ++childIter) {
+                Measure *measure = dynamic_cast<Measure *>(*childIter);
+                if (!measure) continue;
+                if (measure->IsLayoutDirty()) {
+                    if (firstDirty == VRV_UNSET) firstDirty = (int)systems.size();
+                    lastDirty = (int)systems.size();
+                    isDirty = true;
+                }
+                else if (measure->GetCastOffWidth() == VRV_UNSET) {
+                    return false;
+                }
+            }
+            // The height of a system with dirty measures is not used since it is cast off again
+            if (!isDirty && (system->GetCastOffHeight() == VRV_UNSET)) {
+                return false;
+            }
+            systems.push_back(system);
+        }
+    }
+
+    return true;
+}
+
+void Doc::MarkLayoutDirty(Object *object)
+{
+    if (!object) {
+        m_isLayoutDirty = true;
+        return;
+    }
+
+    Measure *measure = dynamic_cast<Measure *>(object->Is(MEASURE) ? object : object->GetFirstParent(MEASURE));
+    if (!measure || !measure->GetParent() || !measure->GetParent()->Is(SYSTEM)) {
+        m_isLayoutDirty = true;
+        return;
+    }
+    measure->SetLayoutDirty(true);
+
+    // Clef, key signature and meter changes also modify the width of the following measures
+    if (object->Is({ CLEF, KEYACCID, KEYSIG, MENSUR, METERSIG, SCOREDEF, STAFFDEF })
+        || object->GetFirstParent(KEYSIG, 1)) {
+        ArrayOfObjects measures;
+        ClassIdComparison matchType(MEASURE);
+        this->FindAllChildByComparison(&measures, &matchType);
+        ArrayOfObjects::iterator iter = std::find(measures.begin(), measures.end(), measure);
+        for (; iter != measures.end(); ++iter) {
+            dynamic_cast<Measure *>(*iter)->SetLayoutDirty(true);
+        }
+    }
+
+    if (object->HasInterface(INTERFACE_TIME_SPANNING)) {
+        TimeSpanningInterface *interface = object->GetTimeSpanningInterface();
+        assert(interface);
+        if (interface->GetEnd()) this->MarkLayoutDirty(interface->GetEnd());
+    }
+}
+
+bool Doc::IsCastOffOptimized()
+{
+    // By default, optimize scores
+    bool optimize = (m_scoreDef.GetOptimize() != BOOLEAN_false);
+    // However, if nothing specified, do not if there is only one staffGrp
+    if ((m_scoreDef.GetOptimize() == BOOLEAN_NONE) && (m_scoreDef.GetChildCount(STAFFGRP, UNLIMITED_DEPTH) < 2)) {
+        optimize = false;
+    }
+    return optimize;
+}
+
+void Doc::SetCurrentScoreDefFromPage(int pageIdx, const ScoreDef &upcomingScoreDef, bool optimize)
+{
+    Pages *pages = this->GetPages();
+    assert(pages);
+
+    if (pageIdx == 0) {
+        this->SetCurrentScoreDefDoc(true);
+        if (optimize) {
+            this->OptimizeScoreDefDoc(false);
+        }
+        return;
+    }
+
+    int i;
+    Functor unsetCurrentScoreDef(&Object::UnsetCurrentScoreDef);
+    UnsetCurrentScoreDefParams unsetCurrentScoreDefParams(&unsetCurrentScoreDef);
+    for (i = pageIdx; i < pages->GetChildCount(); ++i) {
+        pages->GetChild(i)->Process(&unsetCurrentScoreDef, &unsetCurrentScoreDefParams);
+    }
+
+    ScoreDef currentScoreDef = upcomingScoreDef;
+    SetCurrentScoreDefParams setCurrentScoreDefParams(this, &currentScoreDef);
+    Functor setCurrentScoreDef(&Object::SetCurrentScoreDef);
+    for (i = pageIdx; i < pages->GetChildCount(); ++i) {
+        pages->GetChild(i)->Process(&setCurrentScoreDef, &setCurrentScoreDefParams);
+    }
+
+    if (!optimize) return;
+
+    Functor optimizeScoreDef(&Object::OptimizeScoreDef);
+    Functor optimizeScoreDefEnd(&Object::OptimizeScoreDefEnd);
+    OptimizeScoreDefParams optimizeScoreDefParams(this, &optimizeScoreDef, &optimizeScoreDefEnd);
+    // We are not starting with the first system
+    optimizeScoreDefParams.m_firstScoreDef = false;
+    for (i = pageIdx; i < pages->GetChildCount(); ++i) {
+        pages->GetChild(i)->Process(&optimizeScoreDef, &optimizeScoreDefParams, &optimizeScoreDefEnd);
+    }
 }
 
 void Doc::CastOffRunningElements(CastOffPagesParams *params)
@@ -888,6 +1464,7 @@ void Doc::UnCastOffDoc()
     this->Process(&unCastOff, &unCastOffParams);
 
     pages->ClearChildren();
+    m_castOffPendingPage = NULL;
 
     pages->AddChild(contentPage);
 
@@ -1168,42 +1745,132 @@ Pages *Doc::GetPages()
 int Doc::GetPageCount()
 {
     Pages *pages = this->GetPages();
-    return ((pages) ? pages->GetChildCount() : 0);
+    if (!pages) return 0;
+    // The pending page is not complete
+    return (m_castOffPendingPage) ? pages->GetChildCount() - 1 : pages->GetChildCount();
 }
 
-int Doc::GetGlyphHeight(wchar_t code, int staffSize, bool graceSize) const
+void Doc::ResetDrawingPage()
+{
+    m_drawingPage = NULL;
+    m_measureIndex.clear();
+    m_measurePositions.clear();
+}
+
+const std::vector<Measure *> &Doc::GetMeasureIndex()
+{
+    if (m_measureIndex.empty()) this->BuildMeasureIndex();
+
+    return m_measureIndex;
+}
+
+System *Doc::GetMeasureSystem(Measure *measure, int &position)
+{
+    assert(measure);
+
+    if (m_measureIndex.empty()) this->BuildMeasureIndex();
+
+    std::map<Measure *, std::pair<System *, int> >::iterator iter = m_measurePositions.find(measure);
+    // Rebuild the index if the measure was moved without the drawing page being reset
+    if ((iter != m_measurePositions.end())
+        && ((measure->GetParent() != iter->second.first)
+            || (iter->second.first->GetChild(iter->second.second) != measure))) {
+        this->BuildMeasureIndex();
+        iter = m_measurePositions.find(measure);
+    }
+    if (iter == m_measurePositions.end()) return NULL;
+
+    position = iter->second.second;
+    return iter->second.first;
+}
+
+void Doc::BuildMeasureIndex()
 {
+    m_measureIndex.clear();
+    m_measurePositions.clear();
+
+    ArrayOfObjects measures;
+    ClassIdComparison matchMeasure(MEASURE);
+    this->FindAllChildByComparison(&measures, &matchMeasure);
+    for (auto &object : measures) {
+        m_measureIndex.push_back(dynamic_cast<Measure *>(object));
+    }
+
+    ArrayOfObjects systems;
+    ClassIdComparison matchSystem(SYSTEM);
+    this->FindAllChildByComparison(&systems, &matchSystem);
+    for (auto &object : systems) {
+        System *system = dynamic_cast<System *>(object);
+        assert(system);
+        const ArrayOfObjects *children = system->GetChildren();
+        for (int i = 0; i < (int)children->size(); ++i) {
+            if (!children->at(i)->Is(MEASURE)) continue;
+            m_measurePositions[dynamic_cast<Measure *>(children->at(i))] = std::make_pair(system, i);
+        }
+    }
+}
+
+Doc::GlyphMetrics Doc::GetGlyphMetrics(wchar_t code, int staffSize, bool graceSize) const
+{
+    GlyphMetrics *cached = NULL;
+    if ((code >= SMUFL_CACHE_FIRST) && (code <= SMUFL_CACHE_LAST)) {
+        std::vector<GlyphMetrics> &table = m_glyphMetrics[staffSize * 2 + graceSize];
+        if (table.empty()) {
+            GlyphMetrics unset = { VRV_UNSET, VRV_UNSET, VRV_UNSET, VRV_UNSET };
+            table.resize(SMUFL_CACHE_LAST - SMUFL_CACHE_FIRST + 1, unset);
+        }
+        cached = &table.at(code - SMUFL_CACHE_FIRST);
+        if (cached->m_advX != VRV_UNSET) return *cached;
+    }
+
     int x, y, w, h;
     Glyph *glyph = Resources::GetGlyph(code);
     assert(glyph);
     glyph->GetBoundingBox(x, y, w, h);
-    h = h * m_drawingSmuflFontSize / glyph->GetUnitsPerEm();
-    if (graceSize) h = h * this->m_options->m_graceFactor.GetValue();
-    h = h * staffSize / 100;
-    return h;
+    int advX = glyph->GetHorizAdvX();
+
+    // Apply the font size, the grace factor and the staff size to each value as integer values
+    GlyphMetrics metrics = { y, w, h, advX };
+    int *values[4] = { &metrics.m_y, &metrics.m_width, &metrics.m_height, &metrics.m_advX };
+    for (int i = 0; i < 4; ++i) {
+        int &value = *values[i];
+        value = value * m_drawingSmuflFontSize / glyph->GetUnitsPerEm();
+        if (graceSize) value = value * this->m_options->m_graceFactor.GetValue();
+        value = value * staffSize / 100;
+    }
+
+    if (cached) *cached = metrics;
+    return metrics;
+}
+
+void Doc::ResetGlyphMetrics()
+{
+    int fontVersion = Resources::GetFontVersion();
+    double graceFactor = this->m_options->m_graceFactor.GetValue();
+    if ((fontVersion == m_glyphMetricsFontVersion) && (m_drawingSmuflFontSize == m_glyphMetricsFontSize)
+        && (graceFactor == m_glyphMetricsGraceFactor)) {
+        return;
+    }
+
+    m_glyphMetrics.clear();
+    m_glyphMetricsFontVersion = fontVersion;
+    m_glyphMetricsFontSize = m_drawingSmuflFontSize;
+    m_glyphMetricsGraceFactor = graceFactor;
+}
+
+int Doc::GetGlyphHeight(wchar_t code, int staffSize, bool graceSize) const
+{
+    return this->GetGlyphMetrics(code, staffSize, graceSize).m_height;
 }
 
 int Doc::GetGlyphWidth(wchar_t code, int staffSize, bool graceSize) const
 {
-    int x, y, w, h;
-    Glyph *glyph = Resources::GetGlyph(code);
-    assert(glyph);
-    glyph->GetBoundingBox(x, y, w, h);
-    w = w * m_drawingSmuflFontSize / glyph->GetUnitsPerEm();
-    if (graceSize) w = w * this->m_options->m_graceFactor.GetValue();
-    w = w * staffSize / 100;
-    return w;
+    return this->GetGlyphMetrics(code, staffSize, graceSize).m_width;
 }
 
 int Doc::GetGlyphAdvX(wchar_t code, int staffSize, bool graceSize) const
 {
-    Glyph *glyph = Resources::GetGlyph(code);
-    assert(glyph);
-    int advX = glyph->GetHorizAdvX();
-    advX = advX * m_drawingSmuflFontSize / glyph->GetUnitsPerEm();
-    if (graceSize) advX = advX * this->m_options->m_graceFactor.GetValue();
-    advX = advX * staffSize / 100;
-    return advX;
+    return this->GetGlyphMetrics(code, staffSize, graceSize).m_advX;
 }
 
 Point Doc::ConvertFontPoint(const Glyph *glyph, const Point &fontPoint, int staffSize, bool graceSize) const
@@ -1226,14 +1893,7 @@ Point Doc::ConvertFontPoint(const Glyph *glyph, const Point &fontPoint, int staf
 
 int Doc::GetGlyphDescender(wchar_t code, int staffSize, bool graceSize) const
 {
-    int x, y, w, h;
-    Glyph *glyph = Resources::GetGlyph(code);
-    assert(glyph);
-    glyph->GetBoundingBox(x, y, w, h);
-    y = y * m_drawingSmuflFontSize / glyph->GetUnitsPerEm();
-    if (graceSize) y = y * this->m_options->m_graceFactor.GetValue();
-    y = y * staffSize / 100;
-    return y;
+    return this->GetGlyphMetrics(code, staffSize, graceSize).m_y;
 }
 
 int Doc::GetTextGlyphHeight(wchar_t code, FontInfo *font, bool graceSize) const
@@ -1397,56 +2057,67 @@ FontInfo *Doc::GetDrawingLyricFont(int staffSize)
 
 double Doc::GetLeftMargin(const ClassId classId) const
 {
-    if (classId == ACCID) return m_options->m_leftMarginAccid.GetValue();
-    if (classId == BARLINE) return m_options->m_leftMarginBarLine.GetValue();
-    if (classId == BARLINE_ATTR_LEFT) return m_options->m_leftMarginLeftBarLine.GetValue();
-    if (classId == BARLINE_ATTR_RIGHT) return m_options->m_leftMarginRightBarLine.GetValue();
-    if (classId == BEATRPT) return m_options->m_leftMarginBeatRpt.GetValue();
-    if (classId == CHORD) return m_options->m_leftMarginChord.GetValue();
-    if (classId == CLEF) return m_options->m_leftMarginClef.GetValue();
-    if (classId == KEYSIG) return m_options->m_leftMarginKeySig.GetValue();
-    if (classId == MENSUR) return m_options->m_leftMarginMensur.GetValue();
-    if (classId == METERSIG) return m_options->m_leftMarginMeterSig.GetValue();
-    if (classId == MREST) return m_options->m_leftMarginMRest.GetValue();
-    if (classId == MRPT2) return m_options->m_leftMarginMRpt2.GetValue();
-    if (classId == MULTIREST) return m_options->m_leftMarginMultiRest.GetValue();
-    if (classId == MULTIRPT) return m_options->m_leftMarginMultiRpt.GetValue();
-    if (classId == NOTE) return m_options->m_leftMarginNote.GetValue();
-    if (classId == REST) return m_options->m_leftMarginRest.GetValue();
-    return m_options->m_defaultLeftMargin.GetValue();
+    return m_drawingLeftMargins[classId];
 }
 
 double Doc::GetRightMargin(const ClassId classId) const
 {
-    if (classId == ACCID) return m_options->m_rightMarginAccid.GetValue();
-    if (classId == BARLINE) return m_options->m_rightMarginBarLine.GetValue();
-    if (classId == BARLINE_ATTR_LEFT) return m_options->m_rightMarginLeftBarLine.GetValue();
-    if (classId == BARLINE_ATTR_RIGHT) return m_options->m_rightMarginRightBarLine.GetValue();
-    if (classId == BEATRPT) return m_options->m_rightMarginBeatRpt.GetValue();
-    if (classId == CHORD) return m_options->m_rightMarginChord.GetValue();
-    if (classId == CLEF) return m_options->m_rightMarginClef.GetValue();
-    if (classId == KEYSIG) return m_options->m_rightMarginKeySig.GetValue();
-    if (classId == MENSUR) return m_options->m_rightMarginMensur.GetValue();
-    if (classId == METERSIG) return m_options->m_rightMarginMeterSig.GetValue();
-    if (classId == MREST) return m_options->m_rightMarginMRest.GetValue();
-    if (classId == MRPT2) return m_options->m_rightMarginMRpt2.GetValue();
-    if (classId == MULTIREST) return m_options->m_rightMarginMultiRest.GetValue();
-    if (classId == MULTIRPT) return m_options->m_rightMarginMultiRpt.GetValue();
-    if (classId == NOTE) return m_options->m_rightMarginNote.GetValue();
-    if (classId == REST) return m_options->m_rightMarginRest.GetValue();
-    return m_options->m_defaultRightMargin.GetValue();
+    return m_drawingRightMargins[classId];
 }
 
 double Doc::GetBottomMargin(const ClassId classId) const
 {
-    if (classId == HARM) return m_options->m_bottomMarginHarm.GetValue();
-    return m_options->m_defaultBottomMargin.GetValue();
+    return m_drawingBottomMargins[classId];
 }
 
 double Doc::GetTopMargin(const ClassId classId) const
 {
-    if (classId == HARM) return m_options->m_topMarginHarm.GetValue();
-    return m_options->m_defaultTopMargin.GetValue();
+    return m_drawingTopMargins[classId];
+}
+
+void Doc::SetDrawingMargins()
+{
+    std::fill_n(m_drawingLeftMargins, UNSPECIFIED + 1, m_options->m_defaultLeftMargin.GetValue());
+    m_drawingLeftMargins[ACCID] = m_options->m_leftMarginAccid.GetValue();
+    m_drawingLeftMargins[BARLINE] = m_options->m_leftMarginBarLine.GetValue();
+    m_drawingLeftMargins[BARLINE_ATTR_LEFT] = m_options->m_leftMarginLeftBarLine.GetValue();
+    m_drawingLeftMargins[BARLINE_ATTR_RIGHT] = m_options->m_leftMarginRightBarLine.GetValue();
+    m_drawingLeftMargins[BEATRPT] = m_options->m_leftMarginBeatRpt.GetValue();
+    m_drawingLeftMargins[CHORD] = m_options->m_leftMarginChord.GetValue();
+    m_drawingLeftMargins[CLEF] = m_options->m_leftMarginClef.GetValue();
+    m_drawingLeftMargins[KEYSIG] = m_options->m_leftMarginKeySig.GetValue();
+    m_drawingLeftMargins[MENSUR] = m_options->m_leftMarginMensur.GetValue();
+    m_drawingLeftMargins[METERSIG] = m_options->m_leftMarginMeterSig.GetValue();
+    m_drawingLeftMargins[MREST] = m_options->m_leftMarginMRest.GetValue();
+    m_drawingLeftMargins[MRPT2] = m_options->m_leftMarginMRpt2.GetValue();
+    m_drawingLeftMargins[MULTIREST] = m_options->m_leftMarginMultiRest.GetValue();
+    m_drawingLeftMargins[MULTIRPT] = m_options->m_leftMarginMultiRpt.GetValue();
+    m_drawingLeftMargins[NOTE] = m_options->m_leftMarginNote.GetValue();
+    m_drawingLeftMargins[REST] = m_options->m_leftMarginRest.GetValue();
+
+    std::fill_n(m_drawingRightMargins, UNSPECIFIED + 1, m_options->m_defaultRightMargin.GetValue());
+    m_drawingRightMargins[ACCID] = m_options->m_rightMarginAccid.GetValue();
+    m_drawingRightMargins[BARLINE] = m_options->m_rightMarginBarLine.GetValue();
+    m_drawingRightMargins[BARLINE_ATTR_LEFT] = m_options->m_rightMarginLeftBarLine.GetValue();
+    m_drawingRightMargins[BARLINE_ATTR_RIGHT] = m_options->m_rightMarginRightBarLine.GetValue();
+    m_drawingRightMargins[BEATRPT] = m_options->m_rightMarginBeatRpt.GetValue();
+    m_drawingRightMargins[CHORD] = m_options->m_rightMarginChord.GetValue();
+    m_drawingRightMargins[CLEF] = m_options->m_rightMarginClef.GetValue();
+    m_drawingRightMargins[KEYSIG] = m_options->m_rightMarginKeySig.GetValue();
+    m_drawingRightMargins[MENSUR] = m_options->m_rightMarginMensur.GetValue();
+    m_drawingRightMargins[METERSIG] = m_options->m_rightMarginMeterSig.GetValue();
+    m_drawingRightMargins[MREST] = m_options->m_rightMarginMRest.GetValue();
+    m_drawingRightMargins[MRPT2] = m_options->m_rightMarginMRpt2.GetValue();
+    m_drawingRightMargins[MULTIREST] = m_options->m_rightMarginMultiRest.GetValue();
+    m_drawingRightMargins[MULTIRPT] = m_options->m_rightMarginMultiRpt.GetValue();
+    m_drawingRightMargins[NOTE] = m_options->m_rightMarginNote.GetValue();
+    m_drawingRightMargins[REST] = m_options->m_rightMarginRest.GetValue();
+
+    std::fill_n(m_drawingBottomMargins, UNSPECIFIED + 1, m_options->m_defaultBottomMargin.GetValue());
+    m_drawingBottomMargins[HARM] = m_options->m_bottomMarginHarm.GetValue();
+
+    std::fill_n(m_drawingTopMargins, UNSPECIFIED + 1, m_options->m_defaultTopMargin.GetValue());
+    m_drawingTopMargins[HARM] = m_options->m_topMarginHarm.GetValue();
 }
 
 double Doc::GetLeftPosition() const
@@ -1462,6 +2133,9 @@ Page *Doc::SetDrawingPage(int pageIdx)
     }
     // nothing to do
     if (m_drawingPage && m_drawingPage->GetIdx() == pageIdx) {
+        // Only update the cached values since the options could have been changed
+        this->ResetGlyphMetrics();
+        this->SetDrawingMargins();
         return m_drawingPage;
     }
     Pages *pages = this->GetPages();
@@ -1523,6 +2197,10 @@ Page *Doc::SetDrawingPage(int pageIdx)
     m_drawingSmuflFontSize = CalcMusicFontSize();
     m_drawingLyricFontSize = m_options->m_unit.GetValue() * m_options->m_lyricSize.GetValue();
 
+    // cached values
+    this->ResetGlyphMetrics();
+    this->SetDrawingMargins();
+
     glyph_size = GetGlyphWidth(SMUFL_E0A3_noteheadHalf, 100, 0);
     m_drawingLedgerLine = glyph_size * 72 / 100;
 
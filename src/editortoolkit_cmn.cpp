@@ -305,6 +305,9 @@ bool EditorToolkitCMN::Insert(std::string &elementType, std::string const &start
     interface->SetStartid(startid);
     interface->SetEndid(endid);
 
+    m_doc->MarkLayoutDirty(start);
+    m_doc->MarkLayoutDirty(end);
+
     this->m_chainedId = element->GetUuid();
 
     return true;
@@ -321,6 +324,7 @@ bool EditorToolkitCMN::Insert(std::string &elementType, std::string const &start
         return false;
     }
     if (elementType == "note") {
+        m_doc->MarkLayoutDirty(start);
         return this->InsertNote(start);
     }
     // Check if it is a LayerElement
@@ -418,6 +422,11 @@ Object *EditorToolkitCMN::GetElement(std::string &elementId)
         element = m_doc->FindChildByUuid(elementId);
     }
 
+    // The element is about to be edited
+    if (element) {
+        m_doc->MarkLayoutDirty(element);
+    }
+
     return element;
 }
 
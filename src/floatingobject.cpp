@@ -408,6 +408,7 @@ void FloatingCurvePositioner::ResetCurveParams()
     m_thickness = 0;
     m_dir = curvature_CURVEDIR_NONE;
     m_cachedMinMaxY = VRV_UNSET;
+    m_cachedThickBezierY = VRV_UNSET;
     ClearSpannedElements();
 }
 
@@ -427,6 +428,7 @@ void FloatingCurvePositioner::UpdateCurveParams(
     m_thickness = thickness;
     m_dir = curveDir;
     m_cachedMinMaxY = VRV_UNSET;
+    m_cachedThickBezierY = VRV_UNSET;
 }
 
 int FloatingCurvePositioner::CalcMinMaxY(const Point points[4])
@@ -471,8 +473,11 @@ int FloatingCurvePositioner::CalcAdjustment(BoundingBox *boundingBox, bool &disc
     if (p2.x < boundingBox->GetLeftBy(type) + margin) return 0;
     if (p1.x > boundingBox->GetRightBy(type) + margin) return 0;
 
-    Point topBezier[4], bottomBezier[4];
-    BoundingBox::CalcThickBezier(points, this->GetThickness(), this->GetAngle(), topBezier, bottomBezier);
+    const BezierPolynomial &topBezier = this->GetTopBezierPolynomial();
+    const BezierPolynomial &bottomBezier = this->GetBottomBezierPolynomial();
+    // The left and right positions of the box for calculating both y positions at once
+    const int xs[2] = { boundingBox->GetLeftBy(type), boundingBox->GetRightBy(type) };
+    int ys[2];
 
     if (this->GetDir() == curvature_CURVEDIR_above) {
         // The curve is below the content - if the element needs to be kept inside (e.g. a note), then do not return.
@@ -484,18 +489,19 @@ int FloatingCurvePositioner::CalcAdjustment(BoundingBox *boundingBox, bool &disc
         // The curve overflows on both sides
         if ((p1.x < boundingBox->GetLeftBy(type)) && p2.x > boundingBox->GetRightBy(type)) {
             // Calcuate the y positions
-            leftY = BoundingBox::CalcBezierAtPosition(bottomBezier, boundingBox->GetLeftBy(type)) - margin;
-            rightY = BoundingBox::CalcBezierAtPosition(bottomBezier, boundingBox->GetRightBy(type)) - margin;
+            bottomBezier.CalcYAtPositions(xs, ys, 2);
+            leftY = ys[0] - margin;
+            rightY = ys[1] - margin;
         }
         // The curve overflows on the left
         else if ((p1.x < boundingBox->GetLeftBy(type)) && p2.x <= boundingBox->GetRightBy(type)) {
-            leftY = BoundingBox::CalcBezierAtPosition(topBezier, boundingBox->GetLeftBy(type)) - margin;
+            leftY = topBezier.CalcYAtPosition(boundingBox->GetLeftBy(type)) - margin;
             rightY = p2.y - margin;
         }
         // The curve overflows on the right
         else if ((p1.x >= boundingBox->GetLeftBy(type)) && p2.x > boundingBox->GetRightBy(type)) {
             leftY = p1.y - margin;
-            rightY = BoundingBox::CalcBezierAtPosition(topBezier, boundingBox->GetRightBy(type)) - margin;
+            rightY = topBezier.CalcYAtPosition(boundingBox->GetRightBy(type)) - margin;
         }
         // The curve is inside the left and right side of the content
         else {
@@ -522,18 +528,19 @@ int FloatingCurvePositioner::CalcAdjustment(BoundingBox *boundingBox, bool &disc
         // The curve overflows on both sides
         if ((p1.x < boundingBox->GetLeftBy(type)) && p2.x > boundingBox->GetRightBy(type)) {
             // Calcuate the y positions
-            leftY = BoundingBox::CalcBezierAtPosition(topBezier, boundingBox->GetLeftBy(type)) + margin;
-            rightY = BoundingBox::CalcBezierAtPosition(topBezier, boundingBox->GetRightBy(type)) + margin;
+            topBezier.CalcYAtPositions(xs, ys, 2);
+            leftY = ys[0] + margin;
+            rightY = ys[1] + margin;
         }
         // The curve overflows on the left
         else if ((p1.x < boundingBox->GetLeftBy(type)) && p2.x <= boundingBox->GetRightBy(type)) {
-            leftY = BoundingBox::CalcBezierAtPosition(topBezier, boundingBox->GetLeftBy(type)) + margin;
+            leftY = topBezier.CalcYAtPosition(boundingBox->GetLeftBy(type)) + margin;
             rightY = p2.y + margin;
         }
         // The curve overflows on the right
         else if ((p1.x >= boundingBox->GetLeftBy(type)) && p2.x > boundingBox->GetRightBy(type)) {
             leftY = p1.y + margin;
-            rightY = BoundingBox::CalcBezierAtPosition(topBezier, boundingBox->GetRightBy(type)) + margin;
+            rightY = topBezier.CalcYAtPosition(boundingBox->GetRightBy(type)) + margin;
         }
         // The curve is inside the left and right side of the content
         else {
@@ -565,6 +572,43 @@ void FloatingCurvePositioner::GetPoints(Point points[4])
     points[3].y += currentY;
 }
 
+void FloatingCurvePositioner::GetThickBezierPoints(Point topBezier[4], Point bottomBezier[4])
+{
+    this->UpdateThickBezier();
+
+    for (int i = 0; i < 4; ++i) {
+        topBezier[i] = m_topBezier[i];
+        bottomBezier[i] = m_bottomBezier[i];
+    }
+}
+
+const BezierPolynomial &FloatingCurvePositioner::GetTopBezierPolynomial()
+{
+    this->UpdateThickBezier();
+
+    return m_topBezierPolynomial;
+}
+
+const BezierPolynomial &FloatingCurvePositioner::GetBottomBezierPolynomial()
+{
+    this->UpdateThickBezier();
+
+    return m_bottomBezierPolynomial;
+}
+
+void FloatingCurvePositioner::UpdateThickBezier()
+{
+    // Nothing changed since the last calculation
+    if ((m_cachedThickBezierY != VRV_UNSET) && (m_cachedThickBezierY == this->GetDrawingY())) return;
+
+    Point points[4];
+    this->GetPoints(points);
+    BoundingBox::CalcThickBezier(points, this->GetThickness(), this->GetAngle(), m_topBezier, m_bottomBezier);
+    m_topBezierPolynomial.SetBezier(m_topBezier);
+    m_bottomBezierPolynomial.SetBezier(m_bottomBezier);
+    m_cachedThickBezierY = this->GetDrawingY();
+}
+
 //----------------------------------------------------------------------------
 // FloatingObject functor methods
 //----------------------------------------------------------------------------
@@ -10,6 +10,7 @@
 //----------------------------------------------------------------------------
 
 #include <assert.h>
+#include <ctype.h>
 #include <stdlib.h>
 
 //----------------------------------------------------------------------------
@@ -22,6 +23,162 @@
 
 namespace vrv {
 
+//----------------------------------------------------------------------------
+// Glyph outline parsing
+//----------------------------------------------------------------------------
+
+static bool ReadPathNumber(const char *&s, double &value)
+{
+    while ((*s == ' ') || (*s == ',') || (*s == '\t') || (*s == '\n') || (*s == '\r')) ++s;
+    char *end = NULL;
+    value = strtod(s, &end);
+    if (end == s) return false;
+    s = end;
+    return true;
+}
+
+/**
+ * Append a point to the outline with the transformation (scale x, scale y, offset x, offset y)
+ */
+static void AppendOutlinePoint(GlyphOutline &outline, double x, double y, const double transform[4])
+{
+    outline.m_coords.push_back(x * transform[0] - transform[2]);
+    outline.m_coords.push_back(y * transform[1] - transform[3]);
+}
+
+/**
+ * Parse the SVG path data (d) and append it to the outline.
+ * The arcs (not used in the SMuFL fonts) are replaced by lines.
+ */
+static void ParsePathData(const char *s, const double transform[4], GlyphOutline &outline)
+{
+    double x = 0.0, y = 0.0, startX = 0.0, startY = 0.0;
+    // the last control point for the smooth curves
+    double controlX = 0.0, controlY = 0.0;
+    char command = 0;
+    char previous = 0;
+    double v[6];
+
+    while (*s) {
+        while ((*s == ' ') || (*s == ',') || (*s == '\t') || (*s == '\n') || (*s == '\r')) ++s;
+        if (!*s) break;
+        if (isalpha(*s)) {
+            command = *s;
+            ++s;
+        }
+        else if (!command) {
+            LogWarning("Invalid glyph path data");
+            return;
+        }
+        bool relative = (islower(command) != 0);
+        double dx = (relative) ? x : 0.0;
+        double dy = (relative) ? y : 0.0;
+        switch (toupper(command)) {
+            case 'Z':
+                outline.m_ops.push_back('Z');
+                x = startX;
+                y = startY;
+                command = 0;
+                break;
+            case 'M':
+                if (!ReadPathNumber(s, v[0]) || !ReadPathNumber(s, v[1])) return;
+                x = startX = v[0] + dx;
+                y = startY = v[1] + dy;
+                outline.m_ops.push_back('M');
+                AppendOutlinePoint(outline, x, y, transform);
+                // following pairs are lines
+                command = (relative) ? 'l' : 'L';
+                break;
+            case 'L':
+            case 'H':
+            case 'V':
+                if (toupper(command) == 'H') {
+                    if (!ReadPathNumber(s, v[0])) return;
+                    x = v[0] + dx;
+                }
+                else if (toupper(command) == 'V') {
+                    if (!ReadPathNumber(s, v[0])) return;
+                    y = v[0] + dy;
+                }
+                else {
+                    if (!ReadPathNumber(s, v[0]) || !ReadPathNumber(s, v[1])) return;
+                    x = v[0] + dx;
+                    y = v[1] + dy;
+                }
+                outline.m_ops.push_back('L');
+                AppendOutlinePoint(outline, x, y, transform);
+                break;
+            case 'C':
+            case 'S': {
+                double x1, y1;
+                if (toupper(command) == 'C') {
+                    if (!ReadPathNumber(s, v[0]) || !ReadPathNumber(s, v[1])) return;
+                    x1 = v[0] + dx;
+                    y1 = v[1] + dy;
+                }
+                else {
+                    // reflection of the previous control point
+                    bool smooth = (toupper(previous) == 'C') || (toupper(previous) == 'S');
+                    x1 = (smooth) ? 2 * x - controlX : x;
+                    y1 = (smooth) ? 2 * y - controlY : y;
+                }
+                for (int i = 2; i < 6; ++i) {
+                    if (!ReadPathNumber(s, v[i])) return;
+                }
+                controlX = v[2] + dx;
+                controlY = v[3] + dy;
+                x = v[4] + dx;
+                y = v[5] + dy;
+                outline.m_ops.push_back('C');
+                AppendOutlinePoint(outline, x1, y1, transform);
+                AppendOutlinePoint(outline, controlX, controlY, transform);
+                AppendOutlinePoint(outline, x, y, transform);
+                break;
+            }
+            case 'Q':
+            case 'T': {
+                double qx, qy;
+                if (toupper(command) == 'Q') {
+                    if (!ReadPathNumber(s, v[0]) || !ReadPathNumber(s, v[1])) return;
+                    qx = v[0] + dx;
+                    qy = v[1] + dy;
+                }
+                else {
+                    bool smooth = (toupper(previous) == 'Q') || (toupper(previous) == 'T');
+                    qx = (smooth) ? 2 * x - controlX : x;
+                    qy = (smooth) ? 2 * y - controlY : y;
+                }
+                if (!ReadPathNumber(s, v[2]) || !ReadPathNumber(s, v[3])) return;
+                double endX = v[2] + dx;
+                double endY = v[3] + dy;
+                // the quadratic curve as a cubic curve
+                outline.m_ops.push_back('C');
+                AppendOutlinePoint(outline, x + 2.0 / 3.0 * (qx - x), y + 2.0 / 3.0 * (qy - y), transform);
+                AppendOutlinePoint(
+                    outline, endX + 2.0 / 3.0 * (qx - endX), endY + 2.0 / 3.0 * (qy - endY), transform);
+                AppendOutlinePoint(outline, endX, endY, transform);
+                controlX = qx;
+                controlY = qy;
+                x = endX;
+                y = endY;
+                break;
+            }
+            case 'A':
+                for (int i = 0; i < 5; ++i) {
+                    if (!ReadPathNumber(s, v[i])) return;
+                }
+                if (!ReadPathNumber(s, v[0]) || !ReadPathNumber(s, v[1])) return;
+                x = v[0] + dx;
+                y = v[1] + dy;
+                outline.m_ops.push_back('L');
+                AppendOutlinePoint(outline, x, y, transform);
+                break;
+            default: LogWarning("Unsupported command '%c' in glyph path data", command); return;
+        }
+        previous = command;
+    }
+}
+
 //----------------------------------------------------------------------------
 // Glyph
 //----------------------------------------------------------------------------
@@ -33,6 +190,7 @@ Glyph::Glyph()
     m_width = 0;
     m_height = 0;
     m_horizAdvX = 0;
+    m_hasOutline = false;
     m_unitsPerEm = 20480;
     m_path = "[unset]";
     m_codeStr = "[unset]";
@@ -45,6 +203,7 @@ Glyph::Glyph(std::string path, std::string codeStr)
     m_width = 0;
     m_height = 0;
     m_horizAdvX = 0;
+    m_hasOutline = false;
     m_unitsPerEm = 20480;
     m_path = path;
     m_codeStr = codeStr;
@@ -81,6 +240,7 @@ Glyph::Glyph(int unitsPerEm)
     m_width = 0;
     m_height = 0;
     m_horizAdvX = 0;
+    m_hasOutline = false;
     m_unitsPerEm = unitsPerEm * 10;
     m_path = "[unset]";
     m_codeStr = "[unset]";
@@ -136,4 +296,40 @@ const Point *Glyph::GetAnchor(SMuFLGlyphAnchor anchor)
     return &m_anchors[anchor];
 }
 
+const GlyphOutline &Glyph::GetOutline()
+{
+    if (m_hasOutline) return m_outline;
+    m_hasOutline = true;
+
+    m_outline.m_unitsX = 1000.0;
+    m_outline.m_unitsY = 1000.0;
+
+    pugi::xml_document doc;
+    if (!doc.load_file(m_path.c_str())) {
+        LogWarning("Glyph outline '%s' could not be loaded", m_path.c_str());
+        return m_outline;
+    }
+    pugi::xml_node symbol = doc.first_child();
+    double viewBox[4] = { 0.0, 0.0, 1000.0, 1000.0 };
+    if (symbol.attribute("viewBox")) {
+        const char *s = symbol.attribute("viewBox").value();
+        for (int i = 0; i < 4; ++i) ReadPathNumber(s, viewBox[i]);
+    }
+    m_outline.m_unitsX = (viewBox[2] > 0.0) ? viewBox[2] : 1000.0;
+    m_outline.m_unitsY = (viewBox[3] > 0.0) ? viewBox[3] : 1000.0;
+
+    for (pugi::xml_node child = symbol.child("path"); child; child = child.next_sibling("path")) {
+        // only scale transformations (i.e., scale(1,-1)) are used
+        double scaleX = 1.0, scaleY = 1.0;
+        std::string scale = child.attribute("transform").value();
+        if (scale.compare(0, 6, "scale(") == 0) {
+            const char *s = scale.c_str() + 6;
+            if (ReadPathNumber(s, scaleX) && !ReadPathNumber(s, scaleY)) scaleY = scaleX;
+        }
+        const double transform[4] = { scaleX, scaleY, viewBox[0], viewBox[1] };
+        ParsePathData(child.attribute("d").value(), transform, m_outline);
+    }
+    return m_outline;
+}
+
 } // namespace vrv
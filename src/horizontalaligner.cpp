@@ -45,34 +45,47 @@ HorizontalAligner::~HorizontalAligner() {}
 void HorizontalAligner::Reset()
 {
     Object::Reset();
+    m_isOrdered = true;
 }
 
 Alignment *HorizontalAligner::SearchAlignmentAtTime(double time, AlignmentType type, int &idx)
 {
-    int i;
     idx = -1; // the index if we reach the end.
-    Alignment *alignment = NULL;
-    // First try to see if we already have something at the time position
-    for (i = 0; i < GetAlignmentCount(); ++i) {
-        alignment = dynamic_cast<Alignment *>(m_children.at(i));
-        assert(alignment);
-
-        double alignment_time = alignment->GetTime();
-        if (AreEqual(alignment_time, time)) {
-            if (alignment->GetType() == type) {
-                return alignment;
+    // Look for the first alignment at the time with the same type or a type after it, or after the time.
+    // When the alignments are ordered, this is done with a binary search.
+    int first = 0;
+    int last = GetAlignmentCount();
+    if (m_isOrdered) {
+        while (first < last) {
+            int middle = first + (last - first) / 2;
+            Alignment *alignment = dynamic_cast<Alignment *>(m_children.at(middle));
+            assert(alignment);
+            if (alignment->IsBefore(time, type)) {
+                first = middle + 1;
             }
-            else if (alignment->GetType() > type) {
-                idx = i;
-                break;
+            else {
+                last = middle;
             }
         }
-        // nothing found, do not go any further but keep the index
-        if (alignment->GetTime() > time) {
-            idx = i;
-            break;
+    }
+    else {
+        for (; first < last; ++first) {
+            Alignment *alignment = dynamic_cast<Alignment *>(m_children.at(first));
+            assert(alignment);
+            if (!alignment->IsBefore(time, type)) break;
         }
     }
+    // Nothing found to the end
+    if (first == GetAlignmentCount()) return NULL;
+
+    Alignment *alignment = dynamic_cast<Alignment *>(m_children.at(first));
+    assert(alignment);
+    // We already have an alignment of the type at the time position
+    if (AreEqual(alignment->GetTime(), time) && (alignment->GetType() == type)) {
+        return alignment;
+    }
+    // Nothing found, keep the index
+    idx = first;
     return NULL;
 }
 
@@ -81,12 +94,26 @@ void HorizontalAligner::AddAlignment(Alignment *alignment, int idx)
     alignment->SetParent(this);
     if (idx == -1) {
         m_children.push_back(alignment);
+        this->CheckOrder(GetAlignmentCount() - 1);
     }
     else {
         InsertChild(alignment, idx);
+        this->CheckOrder(idx);
+        this->CheckOrder(idx + 1);
     }
 }
 
+void HorizontalAligner::CheckOrder(int idx)
+{
+    if (!m_isOrdered || (idx <= 0) || (idx >= GetAlignmentCount())) return;
+
+    Alignment *previous = dynamic_cast<Alignment *>(m_children.at(idx - 1));
+    assert(previous);
+    Alignment *alignment = dynamic_cast<Alignment *>(m_children.at(idx));
+    assert(alignment);
+    if (alignment->IsBefore(previous->GetTime(), previous->GetType())) m_isOrdered = false;
+}
+
 //----------------------------------------------------------------------------
 // MeasureAligner
 //----------------------------------------------------------------------------
@@ -158,7 +185,11 @@ void MeasureAligner::SetMaxTime(double time)
         alignment = dynamic_cast<Alignment *>(m_children.at(i));
         assert(alignment);
         // Change it only if higher than before
-        if (time > alignment->GetTime()) alignment->SetTime(time);
+        if (time > alignment->GetTime()) {
+            alignment->SetTime(time);
+            this->CheckOrder(i);
+            this->CheckOrder(i + 1);
+        }
     }
 }
 
@@ -537,6 +568,12 @@ bool Alignment::IsOfType(const std::vector<AlignmentType> &types)
     return (std::find(types.begin(), types.end(), m_type) != types.end());
 }
 
+bool Alignment::IsBefore(double time, AlignmentType type) const
+{
+    if (AreEqual(m_time, time)) return (m_type < type);
+    return (m_time < time);
+}
+
 void Alignment::GetLeftRight(int staffN, int &minLeft, int &maxRight)
 {
     Functor getAlignmentLeftRight(&Object::GetAlignmentLeftRight);
@@ -2210,6 +2210,11 @@ MeiInput::MeiInput(Doc *doc, std::string filename) : FileInputStream(doc)
     m_useScoreDefForDoc = false;
     m_readingScoreBased = false;
     m_version = MEI_UNDEFINED;
+    //
+    m_hasMeasureRange = false;
+    m_measureRangeStarted = true;
+    m_measureRangeEnded = false;
+    m_measureCount = 0;
 }
 
 MeiInput::~MeiInput() {}
@@ -2728,8 +2733,16 @@ bool MeiInput::ReadDoc(pugi::xml_node root)
         return false;
     }
 
+    this->InitSelection();
+
     success = ReadMdivChildren(m_doc, body, false);
 
+    if (success && !m_measureRangeStarted) {
+        LogError("The measure range '%s' did not match any measure",
+            m_doc->GetOptions()->m_measureRange.GetValue().c_str());
+        success = false;
+    }
+
     if (success) {
         m_doc->ConvertScoreDefMarkupDoc();
     }
@@ -2828,6 +2841,12 @@ bool MeiInput::ReadPages(Object *parent, pugi::xml_node pages)
     // This is a page-based MEI file
     this->m_hasLayoutInformation = true;
 
+    if (m_hasMeasureRange) {
+        LogWarning("The measure range is not supported with page-based MEI and will be ignored");
+        m_hasMeasureRange = false;
+        m_measureRangeStarted = true;
+    }
+
     bool success = true;
     // We require to have s <scoreDef> as first child of <score>
     pugi::xml_node scoreDef = pages.first_child();
@@ -2920,10 +2939,16 @@ bool MeiInput::ReadSection(Object *parent, pugi::xml_node section)
 
     parent->AddChild(vrvSection);
     ReadUnsupportedAttr(section, vrvSection);
-    if (m_readingScoreBased)
-        return ReadSectionChildren(vrvSection, section);
+    if (m_readingScoreBased) {
+        bool success = ReadSectionChildren(vrvSection, section);
+        // Do not keep sections left empty by the measure range
+        if (success && m_hasMeasureRange && (vrvSection->GetChildCount() == 0)) {
+            parent->DeleteChild(vrvSection);
+        }
+        return success;
+    }
     else
-        return ReadSystemChildren(vrvSection, section);
+        return true;
 }
 
 bool MeiInput::ReadSectionChildren(Object *parent, pugi::xml_node parentNode)
@@ -2950,17 +2975,25 @@ bool MeiInput::ReadSectionChildren(Object *parent, pugi::xml_node parentNode)
             success = ReadExpansion(parent, current);
         }
         else if (std::string(current.name()) == "scoreDef") {
-            success = ReadScoreDef(parent, current);
+            if (!m_measureRangeStarted) {
+                this->SkipScoreDef(current);
+            }
+            else if (!m_measureRangeEnded) {
+                success = ReadScoreDef(parent, current);
+            }
         }
         else if (std::string(current.name()) == "section") {
             success = ReadSection(parent, current);
         }
-        // pb and sb
-        else if (std::string(current.name()) == "pb") {
-            success = ReadPb(parent, current);
-        }
-        else if (std::string(current.name()) == "sb") {
-            success = ReadSb(parent, current);
+        // pb and sb - only within the measure range
+        else if ((std::string(current.name()) == "pb") || (std::string(current.name()) == "sb")) {
+            if (!m_measureRangeStarted || m_measureRangeEnded) continue;
+            if (std::string(current.name()) == "pb") {
+                success = ReadPb(parent, current);
+            }
+            else {
+                success = ReadSb(parent, current);
+            }
         }
         // unmeasured music
         else if (std::string(current.name()) == "staff") {
@@ -2975,7 +3008,9 @@ bool MeiInput::ReadSectionChildren(Object *parent, pugi::xml_node parentNode)
                     return false;
                 }
             }
-            success = ReadStaff(unmeasured, current);
+            if (this->IsStaffSelected(current)) {
+                success = ReadStaff(unmeasured, current);
+            }
         }
         else if (std::string(current.name()) == "measure") {
             // we should not mix measured and unmeasured music within a system...
@@ -2983,7 +3018,13 @@ bool MeiInput::ReadSectionChildren(Object *parent, pugi::xml_node parentNode)
             // if (parent->IsEditorialElement()) {
             //    m_hasMeasureWithinEditMarkup = true;
             //}
-            success = ReadMeasure(parent, current);
+            if (this->IsMeasureSelected(current)) {
+                success = ReadSkippedScoreDefs(parent);
+                if (success) success = ReadMeasure(parent, current);
+            }
+            else if (!m_measureRangeStarted) {
+                this->SkipMeasureContent(current, 0);
+            }
         }
         else {
             LogWarning("Unsupported '<%s>' within <section>", current.name());
@@ -3010,8 +3051,14 @@ bool MeiInput::ReadEnding(Object *parent, pugi::xml_node ending)
 
     parent->AddChild(vrvEnding);
     ReadUnsupportedAttr(ending, vrvEnding);
-    if (m_readingScoreBased)
-        return ReadSectionChildren(vrvEnding, ending);
+    if (m_readingScoreBased) {
+        bool success = ReadSectionChildren(vrvEnding, ending);
+        // Do not keep endings left empty by the measure range
+        if (success && m_hasMeasureRange && (vrvEnding->GetChildCount() == 0)) {
+            parent->DeleteChild(vrvEnding);
+        }
+        return success;
+    }
     else
         return true;
 }
@@ -3184,6 +3231,19 @@ bool MeiInput::ReadSystemChildren(Object *parent, pugi::xml_node parentNode)
         else if (std::string(current.name()) == "boundaryEnd") {
             success = ReadBoundaryEnd(parent, current);
         }
+        // section and ending milestones
+        else if (std::string(current.name()) == "ending") {
+            success = ReadEnding(parent, current);
+        }
+        else if (std::string(current.name()) == "section") {
+            success = ReadSection(parent, current);
+        }
+        else if (std::string(current.name()) == "pb") {
+            success = ReadPb(parent, current);
+        }
+        else if (std::string(current.name()) == "sb") {
+            success = ReadSb(parent, current);
+        }
         // content
         else if (std::string(current.name()) == "scoreDef") {
             // we should not have scoredef with unmeasured music within a system... (?)
@@ -3208,7 +3268,9 @@ bool MeiInput::ReadSystemChildren(Object *parent, pugi::xml_node parentNode)
                     return false;
                 }
             }
-            success = ReadStaff(unmeasured, current);
+            if (this->IsStaffSelected(current)) {
+                success = ReadStaff(unmeasured, current);
+            }
         }
         else if (std::string(current.name()) == "measure") {
             // we should not mix measured and unmeasured music within a system...
@@ -3229,7 +3291,7 @@ bool MeiInput::ReadBoundaryEnd(Object *parent, pugi::xml_node boundaryEnd)
     std::string startUuid;
     Object *start = NULL;
     if (boundaryEnd.attribute("startid")) {
-        std::string startUuid = boundaryEnd.attribute("startid").value();
+        startUuid = boundaryEnd.attribute("startid").value();
         start = m_doc->FindChildByUuid(startUuid);
     }
     if (!start) {
@@ -3237,8 +3299,18 @@ bool MeiInput::ReadBoundaryEnd(Object *parent, pugi::xml_node boundaryEnd)
         return false;
     }
 
+    BoundaryStartInterface *interface = dynamic_cast<BoundaryStartInterface *>(start);
+    if (!interface) {
+        LogError("Start element '%s' for boundaryEnd is not a boundary", startUuid.c_str());
+        return false;
+    }
+
+    // @type only gives the name of the start element (see MeiOutput::WriteBoundaryEnd)
+    boundaryEnd.remove_attribute("type");
+
     BoundaryEnd *vrvBoundaryEnd = new BoundaryEnd(start);
     ReadSystemElement(boundaryEnd, vrvBoundaryEnd);
+    interface->SetEnd(vrvBoundaryEnd);
 
     parent->AddChild(vrvBoundaryEnd);
     return true;
@@ -3433,7 +3505,12 @@ bool MeiInput::ReadStaffGrp(Object *parent, pugi::xml_node staffGrp)
 
     parent->AddChild(vrvStaffGrp);
     ReadUnsupportedAttr(staffGrp, vrvStaffGrp);
-    return ReadStaffGrpChildren(vrvStaffGrp, staffGrp);
+    bool success = ReadStaffGrpChildren(vrvStaffGrp, staffGrp);
+    // Do not keep staffGrp elements without any staffDef left by the staff selection
+    if (success && !m_selectedStaves.empty() && !vrvStaffGrp->FindChildByType(STAFFDEF)) {
+        parent->DeleteChild(vrvStaffGrp);
+    }
+    return success;
 }
 
 bool MeiInput::ReadStaffGrpChildren(Object *parent, pugi::xml_node parentNode)
@@ -3462,7 +3539,9 @@ bool MeiInput::ReadStaffGrpChildren(Object *parent, pugi::xml_node parentNode)
             success = ReadStaffGrp(parent, current);
         }
         else if (std::string(current.name()) == "staffDef") {
-            success = ReadStaffDef(parent, current);
+            if (this->IsStaffSelected(current)) {
+                success = ReadStaffDef(parent, current);
+            }
         }
         else {
             LogWarning("Unsupported '<%s>' within <staffGrp>", current.name());
@@ -3704,6 +3783,10 @@ bool MeiInput::ReadMeasureChildren(Object *parent, pugi::xml_node parentNode)
         else if (IsEditorialElementName(current.name())) {
             success = ReadEditorialElement(parent, current, EDITORIAL_MEASURE);
         }
+        // staves and control events not in the staff selection
+        else if (!this->IsStaffSelected(current)) {
+            continue;
+        }
         // content
         else if (std::string(current.name()) == "anchoredText") {
             success = ReadAnchoredText(parent, current);
@@ -5802,6 +5885,181 @@ bool MeiInput::IsEditorialElementName(std::string elementName)
     return false;
 }
 
+void MeiInput::InitSelection()
+{
+    std::string measureRange = m_doc->GetOptions()->m_measureRange.GetValue();
+    if (!measureRange.empty()) {
+        // A single value (without '-') selects one measure
+        size_t separator = measureRange.find('-');
+        m_measureRangeStart = measureRange.substr(0, separator);
+        m_measureRangeEnd = (separator == std::string::npos) ? m_measureRangeStart : measureRange.substr(separator + 1);
+        m_hasMeasureRange = true;
+        m_measureRangeStarted = m_measureRangeStart.empty();
+    }
+
+    std::vector<std::string> staves = m_doc->GetOptions()->m_staffSelection.GetValue();
+    std::vector<std::string>::iterator iter;
+    for (iter = staves.begin(); iter != staves.end(); ++iter) {
+        std::istringstream iss(*iter);
+        int staffN;
+        while (iss >> staffN) {
+            if (staffN > 0) m_selectedStaves.insert(staffN);
+        }
+        if (!iss.eof()) {
+            LogWarning("Invalid staff selection '%s'", iter->c_str());
+        }
+    }
+}
+
+bool MeiInput::IsMeasureSelected(pugi::xml_node measure)
+{
+    if (!m_hasMeasureRange) return true;
+
+    m_measureCount++;
+    if (m_measureRangeEnded) return false;
+
+    if (!m_measureRangeStarted) {
+        if (!this->IsMeasureRangeBoundary(measure, m_measureRangeStart)) return false;
+        m_measureRangeStarted = true;
+    }
+    // The end measure is included
+    if (this->IsMeasureRangeBoundary(measure, m_measureRangeEnd)) {
+        m_measureRangeEnded = true;
+    }
+    return true;
+}
+
+bool MeiInput::IsMeasureRangeBoundary(pugi::xml_node measure, const std::string &boundary)
+{
+    if (boundary.empty()) return false;
+
+    // Boundaries starting with '#' are positions and not @n values
+    if (boundary.at(0) == '#') {
+        return (atoi(boundary.c_str() + 1) == m_measureCount);
+    }
+    return (boundary == measure.attribute("n").value());
+}
+
+bool MeiInput::IsStaffSelected(pugi::xml_node element)
+{
+    if (m_selectedStaves.empty()) return true;
+
+    std::string elementName = std::string(element.name());
+    std::string staves;
+    if ((elementName == "staff") || (elementName == "staffDef")) {
+        staves = element.attribute("n").value();
+    }
+    else {
+        staves = element.attribute("staff").value();
+    }
+    // Elements without staff reference (e.g., control events with @startid only) are kept
+    if (staves.empty()) return true;
+
+    std::istringstream iss(staves);
+    int staffN;
+    while (iss >> staffN) {
+        if (m_selectedStaves.count(staffN)) return true;
+    }
+    return false;
+}
+
+void MeiInput::SkipScoreDef(pugi::xml_node scoreDef)
+{
+    // Keep the changes collected so far before the scoreDef to preserve the order of the encoding
+    this->FlushSkippedStaffDefChanges();
+    m_skippedScoreDefs.push_back(scoreDef);
+}
+
+void MeiInput::SkipMeasureContent(pugi::xml_node parentNode, int staffN)
+{
+    pugi::xml_node current;
+    for (current = parentNode.first_child(); current; current = current.next_sibling()) {
+        std::string elementName = std::string(current.name());
+        if (elementName == "staff") {
+            this->SkipMeasureContent(current, current.attribute("n").as_int());
+        }
+        // Outside a staff, only editorial markup can have a staff descendant
+        else if (staffN == 0) {
+            if (IsEditorialElementName(elementName)) this->SkipMeasureContent(current, staffN);
+        }
+        else if (elementName == "clef") {
+            this->SkipStaffDefChange(staffN, current, "clef.", { "shape", "line", "dis", "dis.place" });
+        }
+        else if (elementName == "keySig") {
+            this->SkipStaffDefChange(staffN, current, "key.", { "sig", "mode", "pname" });
+        }
+        else if (elementName == "meterSig") {
+            this->SkipStaffDefChange(staffN, current, "meter.", { "count", "unit", "sym" });
+        }
+        else if (current.first_child()) {
+            this->SkipMeasureContent(current, staffN);
+        }
+    }
+}
+
+void MeiInput::SkipStaffDefChange(
+    int staffN, pugi::xml_node element, const std::string &prefix, const std::vector<std::string> &attributes)
+{
+    if (staffN <= 0) return;
+    if (!m_selectedStaves.empty() && (m_selectedStaves.count(staffN) == 0)) return;
+
+    std::map<std::string, std::string> &changes = m_skippedStaffDefChanges[staffN];
+
+    // A new element replaces all the values of a previous one
+    std::map<std::string, std::string>::iterator iter = changes.begin();
+    while (iter != changes.end()) {
+        if (iter->first.compare(0, prefix.size(), prefix) == 0) {
+            iter = changes.erase(iter);
+        }
+        else {
+            ++iter;
+        }
+    }
+
+    std::vector<std::string>::const_iterator attrIter;
+    for (attrIter = attributes.begin(); attrIter != attributes.end(); ++attrIter) {
+        pugi::xml_attribute attribute = element.attribute(attrIter->c_str());
+        if (attribute) changes[prefix + (*attrIter)] = attribute.value();
+    }
+}
+
+void MeiInput::FlushSkippedStaffDefChanges()
+{
+    if (m_skippedStaffDefChanges.empty()) return;
+
+    // Create a scoreDef with one staffDef per staff with changes
+    pugi::xml_node scoreDef = m_skippedScoreDefDoc.append_child("scoreDef");
+    pugi::xml_node staffGrp = scoreDef.append_child("staffGrp");
+
+    std::map<int, std::map<std::string, std::string> >::iterator staffIter;
+    for (staffIter = m_skippedStaffDefChanges.begin(); staffIter != m_skippedStaffDefChanges.end(); ++staffIter) {
+        pugi::xml_node staffDef = staffGrp.append_child("staffDef");
+        staffDef.append_attribute("n") = staffIter->first;
+        std::map<std::string, std::string>::iterator iter;
+        for (iter = staffIter->second.begin(); iter != staffIter->second.end(); ++iter) {
+            staffDef.append_attribute(iter->first.c_str()) = iter->second.c_str();
+        }
+    }
+
+    m_skippedScoreDefs.push_back(scoreDef);
+    m_skippedStaffDefChanges.clear();
+}
+
+bool MeiInput::ReadSkippedScoreDefs(Object *parent)
+{
+    this->FlushSkippedStaffDefChanges();
+
+    bool success = true;
+    std::vector<pugi::xml_node>::iterator iter;
+    for (iter = m_skippedScoreDefs.begin(); iter != m_skippedScoreDefs.end(); ++iter) {
+        if (!success) break;
+        success = ReadScoreDef(parent, *iter);
+    }
+    m_skippedScoreDefs.clear();
+
+    return success;
+}
+
 void MeiInput::UpgradeFTremTo_4_0_0(pugi::xml_node fTrem, FTrem *vrvFTrem)
 {
     if (fTrem.attribute("slash")) {
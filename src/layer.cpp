@@ -76,6 +76,7 @@ void Layer::Reset()
     ResetStaffDefObjects();
 
     m_drawingStemDir = STEMDIRECTION_NONE;
+    m_clefTable.clear();
 }
 
 void Layer::CloneReset()
@@ -94,6 +95,7 @@ void Layer::CloneReset()
     m_cautionStaffDefMeterSig = NULL;
 
     m_drawingStemDir = STEMDIRECTION_NONE;
+    m_clefTable.clear();
 }
 
 void Layer::ResetStaffDefObjects()
@@ -184,23 +186,23 @@ LayerElement *Layer::GetAtPos(int x)
 
 Clef *Layer::GetClef(LayerElement *test)
 {
-    Object *testObject = test;
-
     if (!test) {
         return GetCurrentClef();
     }
 
-    // make sure list is set
-    ResetList(this);
-    if (!test->Is(CLEF)) {
-        testObject = GetListFirstBackward(testObject, CLEF);
-    }
-
-    if (testObject && testObject->Is(CLEF)) {
-        Clef *clef = dynamic_cast<Clef *>(testObject);
+    if (test->Is(CLEF)) {
+        Clef *clef = dynamic_cast<Clef *>(test);
         assert(clef);
         return clef;
     }
+
+    // make sure list and the clef table are set
+    ResetList(this);
+    MapOfObjectClefs::iterator iter = m_clefTable.find(test);
+    if ((iter != m_clefTable.end()) && iter->second) {
+        return iter->second;
+    }
+
     Clef *facsClef = this->GetClefFacs(test);
     if (facsClef != NULL) {
         return facsClef;
@@ -213,6 +215,12 @@ Clef *Layer::GetClefFacs(LayerElement *test)
     Doc *doc = dynamic_cast<Doc *>(this->GetFirstParent(DOC));
     assert(doc);
     if (doc->GetType() == Facs) {
+        ResetList(this);
+        MapOfObjectClefs::iterator iter = m_clefTable.find(test);
+        // The element is in the layer, so this is the clef before it in the layer or the last one before the layer
+        if (iter != m_clefTable.end()) {
+            return (iter->second) ? iter->second : doc->GetClefBeforeLayer(this);
+        }
         ArrayOfObjects clefs;
         ClassIdComparison ac(CLEF);
         doc->FindAllChildBetween(&clefs, &ac, doc->GetFirst(CLEF), test);
@@ -412,6 +420,21 @@ void Layer::SetDrawingCautionValues(StaffDef *currentStaffDef)
     currentStaffDef->SetDrawMeterSig(false);
 }
 
+void Layer::FilterList(ArrayOfObjects *childList)
+{
+    m_clefTable.clear();
+
+    // The list is kept as is but each element is mapped to the last clef before it (or itself for clefs)
+    Clef *clef = NULL;
+    for (auto &object : *childList) {
+        if (object->Is(CLEF)) {
+            clef = dynamic_cast<Clef *>(object);
+            assert(clef);
+        }
+        m_clefTable[object] = clef;
+    }
+}
+
 //----------------------------------------------------------------------------
 // Layer functor methods
 //----------------------------------------------------------------------------
@@ -1451,16 +1451,16 @@ int LayerElement::PrepareTimePointing(FunctorParams *functorParams)
     // Do not look for tstamp pointing to these
     if (this->Is({ ARTIC, ARTIC_PART, BEAM, FLAG, TUPLET, STEM, VERSE })) return FUNCTOR_CONTINUE;
 
-    ArrayOfPointingInterClassIdPairs::iterator iter = params->m_timePointingInterfaces.begin();
-    while (iter != params->m_timePointingInterfaces.end()) {
-        if (iter->first->SetStartOnly(this)) {
-            // We have both the start and the end that are matched
-            iter = params->m_timePointingInterfaces.erase(iter);
-        }
-        else {
-            ++iter;
-        }
+    if (params->m_timePointingInterfaces.empty()) return FUNCTOR_CONTINUE;
+
+    auto range = params->m_timePointingInterfaces.equal_range(this->GetUuid());
+    if (range.first == range.second) return FUNCTOR_CONTINUE;
+
+    MapOfUuidPointingInterfaces::iterator iter;
+    for (iter = range.first; iter != range.second; ++iter) {
+        iter->second->SetStartOnly(this);
     }
+    params->m_timePointingInterfaces.erase(range.first, range.second);
 
     return FUNCTOR_CONTINUE;
 }
@@ -1475,16 +1475,27 @@ int LayerElement::PrepareTimeSpanning(FunctorParams *functorParams)
     // Do not look for tstamp pointing to these
     if (this->Is({ ARTIC, ARTIC_PART, BEAM, FLAG, TUPLET, STEM, VERSE })) return FUNCTOR_CONTINUE;
 
-    ArrayOfSpanningInterClassIdPairs::iterator iter = params->m_timeSpanningInterfaces.begin();
-    while (iter != params->m_timeSpanningInterfaces.end()) {
-        if (iter->first->SetStartAndEnd(this)) {
-            // We have both the start and the end that are matched
-            iter = params->m_timeSpanningInterfaces.erase(iter);
-        }
-        else {
-            ++iter;
+    // Nothing to match when stacking the elements
+    if (params->m_fillList) return FUNCTOR_SIBLINGS;
+
+    // Match the elements waiting for this one (twice when @startid and @endid are identical)
+    auto range = params->m_timeSpanningInterfaces.equal_range(this->GetUuid());
+    if (range.first == range.second) return FUNCTOR_CONTINUE;
+
+    MapOfUuidSpanningInterObjectPairs::iterator iter;
+    for (iter = range.first; iter != range.second; ++iter) {
+        // We do not need to match these outside their measure (for now). Eventually, we could consider them,
+        // for example if we want to display their spanning or for improved midi output
+        Object *object = iter->second.second;
+        if (object->Is({ DIR, DYNAM, HARM }) && (object->GetFirstParent(MEASURE) != this->GetFirstParent(MEASURE))) {
+            continue;
         }
+        iter->second.first->SetStartAndEnd(this);
     }
+    params->m_timeSpanningInterfaces.erase(range.first, range.second);
+
+    // Everything is matched
+    if (params->m_timeSpanningInterfaces.empty()) return FUNCTOR_STOP;
 
     return FUNCTOR_CONTINUE;
 }
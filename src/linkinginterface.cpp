@@ -87,10 +87,10 @@ int LinkingInterface::InterfacePrepareLinking(FunctorParams *functorParams, Obje
     this->SetUuidStr();
 
     if (!m_nextUuid.empty()) {
-        params->m_nextUuidPairs.push_back(std::make_pair(this, m_nextUuid));
+        params->m_nextInterfaces.emplace(m_nextUuid, this);
     }
     if (!m_sameasUuid.empty()) {
-        params->m_sameasUuidPairs.push_back(std::make_pair(this, m_sameasUuid));
+        params->m_sameasInterfaces.emplace(m_sameasUuid, this);
     }
 
     return FUNCTOR_CONTINUE;
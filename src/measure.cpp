@@ -92,6 +92,10 @@ void Measure::CloneReset()
 
     // owned pointers need to be set to NULL;
     m_drawingScoreDef = NULL;
+
+    m_castOffWidth = VRV_UNSET;
+    m_castOffOverflow = VRV_UNSET;
+    m_isLayoutDirty = false;
 }
 
 void Measure::Reset()
@@ -125,6 +129,10 @@ void Measure::Reset()
     m_drawingEnding = NULL;
     m_hasAlignmentRefWithMultipleLayers = false;
 
+    m_castOffWidth = VRV_UNSET;
+    m_castOffOverflow = VRV_UNSET;
+    m_isLayoutDirty = false;
+
     m_scoreTimeOffset.clear();
     m_realTimeOffsetMilliseconds.clear();
     m_currentTempo = 120;
@@ -321,6 +329,12 @@ int Measure::GetDrawingOverflow()
     return std::max(0, overflow);
 }
 
+void Measure::StoreCastOffValues()
+{
+    m_castOffWidth = this->GetWidth();
+    m_castOffOverflow = this->GetDrawingOverflow();
+}
+
 void Measure::SetDrawingScoreDef(ScoreDef *drawingScoreDef)
 {
     assert(!m_drawingScoreDef); // We should always call UnsetCurrentScoreDef before
@@ -889,7 +903,10 @@ int Measure::CastOffSystems(FunctorParams *functorParams)
     assert(params);
 
     // Check if the measure has some overlfowing control elements
-    int overflow = this->GetDrawingOverflow();
+    // The width and the overflow are the ones stored when the content system was laid out
+    int overflow = m_castOffOverflow;
+    // The measure is now laid out and cast off
+    m_isLayoutDirty = false;
 
     if (params->m_currentSystem->GetChildCount() > 0) {
         // We have overflowing content (dir, dynam, tempo) larger than 5 units, keep it as pending
@@ -902,9 +919,10 @@ int Measure::CastOffSystems(FunctorParams *functorParams)
             return FUNCTOR_SIBLINGS;
         }
         // Break it if necessary
-        else if (this->m_drawingXRel + this->GetWidth() + params->m_currentScoreDefWidth - params->m_shift
+        else if (this->m_drawingXRel + m_castOffWidth + params->m_currentScoreDefWidth - params->m_shift
             > params->m_systemWidth) {
             params->m_currentSystem = new System();
+            params->m_currentSystem->SetCastOffScoreDefWidth(params->m_currentScoreDefWidth);
             params->m_page->AddChild(params->m_currentSystem);
             params->m_shift = this->m_drawingXRel;
         }
@@ -1049,31 +1067,7 @@ int Measure::PrepareTimePointingEnd(FunctorParams *functorParams)
             params->m_timePointingInterfaces.size(), this->GetUuid().c_str());
     }
 
-    ArrayOfPointingInterClassIdPairs::iterator iter = params->m_timePointingInterfaces.begin();
-    while (iter != params->m_timePointingInterfaces.end()) {
-        iter = params->m_timePointingInterfaces.erase(iter);
-    }
-
-    return FUNCTOR_CONTINUE;
-}
-
-int Measure::PrepareTimeSpanningEnd(FunctorParams *functorParams)
-{
-    PrepareTimeSpanningParams *params = dynamic_cast<PrepareTimeSpanningParams *>(functorParams);
-    assert(params);
-
-    ArrayOfSpanningInterClassIdPairs::iterator iter = params->m_timeSpanningInterfaces.begin();
-    while (iter != params->m_timeSpanningInterfaces.end()) {
-        // At the end of the measure (going backward) we remove element for which we do not need to match the end (for
-        // now). Eventually, we could consider them, for example if we want to display their spanning or for improved
-        // midi output
-        if ((iter->second == DIR) || (iter->second == DYNAM) || (iter->second == HARM)) {
-            iter = params->m_timeSpanningInterfaces.erase(iter);
-        }
-        else {
-            ++iter;
-        }
-    }
+    params->m_timePointingInterfaces.clear();
 
     return FUNCTOR_CONTINUE;
 }
@@ -88,6 +88,7 @@ Object::Object(const Object &object) : BoundingBox(object)
     m_isAttribute = object.m_isAttribute;
     m_isModified = true;
     m_isReferenceObject = object.m_isReferenceObject;
+    m_childIdxHint = 0;
 
     // Also copy attribute classes
     m_attClasses = object.m_attClasses;
@@ -133,6 +134,7 @@ Object &Object::operator=(const Object &object)
         m_isAttribute = object.m_isAttribute;
         m_isModified = true;
         m_isReferenceObject = object.m_isReferenceObject;
+        m_childIdxHint = 0;
 
         // Also copy attribute classes
         m_attClasses = object.m_attClasses;
@@ -169,6 +171,7 @@ void Object::Init(std::string classid)
     m_isAttribute = false;
     m_isModified = true;
     m_isReferenceObject = false;
+    m_childIdxHint = 0;
 
     this->GenerateUuid();
 
@@ -387,11 +390,10 @@ Object *Object::GetNext(Object *child, const ClassId classId)
 {
     ArrayOfObjects::iterator iteratorEnd, iteratorCurrent;
     iteratorEnd = m_children.end();
-    iteratorCurrent = std::find(m_children.begin(), iteratorEnd, child);
-    if (iteratorCurrent != iteratorEnd) {
-        iteratorCurrent++;
-        iteratorCurrent = std::find_if(iteratorCurrent, iteratorEnd, ObjectComparison(classId));
-    }
+    int idx = this->GetChildIndex(child);
+    if (idx == -1) return NULL;
+    iteratorCurrent = m_children.begin() + idx + 1;
+    iteratorCurrent = std::find_if(iteratorCurrent, iteratorEnd, ObjectComparison(classId));
     return (iteratorCurrent == iteratorEnd) ? NULL : *iteratorCurrent;
 }
 
@@ -399,11 +401,11 @@ Object *Object::GetPrevious(Object *child, const ClassId classId)
 {
     ArrayOfObjects::reverse_iterator riteratorEnd, riteratorCurrent;
     riteratorEnd = m_children.rend();
-    riteratorCurrent = std::find(m_children.rbegin(), riteratorEnd, child);
-    if (riteratorCurrent != riteratorEnd) {
-        ++riteratorCurrent;
-        riteratorCurrent = std::find_if(riteratorCurrent, riteratorEnd, ObjectComparison(classId));
-    }
+    int idx = this->GetChildIndex(child);
+    if (idx == -1) return NULL;
+    // The reverse iterator points to the child before
+    riteratorCurrent = ArrayOfObjects::reverse_iterator(m_children.begin() + idx);
+    riteratorCurrent = std::find_if(riteratorCurrent, riteratorEnd, ObjectComparison(classId));
     return (riteratorCurrent == riteratorEnd) ? NULL : *riteratorCurrent;
 }
 
@@ -645,10 +647,20 @@ void Object::ResetCachedDrawingY() const
 
 int Object::GetChildIndex(const Object *child)
 {
-    ArrayOfObjects::iterator iter;
+    // Start from the position of the previous child found since the children are often looked for in order,
+    // for example when they are moved one by one when casting off. This makes it linear instead of quadratic.
+    int size = (int)m_children.size();
+    int start = (m_childIdxHint < size) ? m_childIdxHint : 0;
     int i;
-    for (iter = m_children.begin(), i = 0; iter != m_children.end(); ++iter, ++i) {
-        if (child == *iter) {
+    for (i = start; i < size; ++i) {
+        if (child == m_children.at(i)) {
+            m_childIdxHint = i;
+            return i;
+        }
+    }
+    for (i = 0; i < start; ++i) {
+        if (child == m_children.at(i)) {
+            m_childIdxHint = i;
             return i;
         }
     }
@@ -1160,30 +1172,40 @@ int Object::PrepareLinking(FunctorParams *functorParams)
     PrepareLinkingParams *params = dynamic_cast<PrepareLinkingParams *>(functorParams);
     assert(params);
 
-    if (params->m_fillList && this->HasInterface(INTERFACE_LINKING)) {
-        LinkingInterface *interface = this->GetLinkingInterface();
-        assert(interface);
-        interface->InterfacePrepareLinking(functorParams, this);
+    if (params->m_fillList) {
+        if (this->HasInterface(INTERFACE_LINKING)) {
+            LinkingInterface *interface = this->GetLinkingInterface();
+            assert(interface);
+            interface->InterfacePrepareLinking(functorParams, this);
+        }
+        return FUNCTOR_CONTINUE;
     }
 
+    const std::string &uuid = this->GetUuid();
+
     // @next
-    std::string uuid = this->GetUuid();
-    auto i = std::find_if(params->m_nextUuidPairs.begin(), params->m_nextUuidPairs.end(),
-        [uuid](std::pair<LinkingInterface *, std::string> pair) { return (pair.second == uuid); });
-    if (i != params->m_nextUuidPairs.end()) {
-        i->first->SetNextLink(this);
-        params->m_nextUuidPairs.erase(i);
+    auto nextRange = params->m_nextInterfaces.equal_range(uuid);
+    if (nextRange.first != nextRange.second) {
+        MapOfUuidLinkingInterfaces::iterator iter;
+        for (iter = nextRange.first; iter != nextRange.second; ++iter) {
+            iter->second->SetNextLink(this);
+        }
+        params->m_nextInterfaces.erase(nextRange.first, nextRange.second);
     }
 
     // @sameas
-    std::string sameas = this->GetUuid();
-    auto j = std::find_if(params->m_sameasUuidPairs.begin(), params->m_sameasUuidPairs.end(),
-        [uuid](std::pair<LinkingInterface *, std::string> pair) { return (pair.second == uuid); });
-    if (j != params->m_sameasUuidPairs.end()) {
-        j->first->SetSameasLink(this);
-        params->m_sameasUuidPairs.erase(j);
+    auto sameasRange = params->m_sameasInterfaces.equal_range(uuid);
+    if (sameasRange.first != sameasRange.second) {
+        MapOfUuidLinkingInterfaces::iterator iter;
+        for (iter = sameasRange.first; iter != sameasRange.second; ++iter) {
+            iter->second->SetSameasLink(this);
+        }
+        params->m_sameasInterfaces.erase(sameasRange.first, sameasRange.second);
     }
 
+    // Everything is matched
+    if (params->m_nextInterfaces.empty() && params->m_sameasInterfaces.empty()) return FUNCTOR_STOP;
+
     return FUNCTOR_CONTINUE;
 }
 
@@ -1192,19 +1214,26 @@ int Object::PreparePlist(FunctorParams *functorParams)
     PreparePlistParams *params = dynamic_cast<PreparePlistParams *>(functorParams);
     assert(params);
 
-    if (params->m_fillList && this->HasInterface(INTERFACE_PLIST)) {
-        PlistInterface *interface = this->GetPlistInterface();
-        assert(interface);
-        return interface->InterfacePreparePlist(functorParams, this);
+    if (params->m_fillList) {
+        if (this->HasInterface(INTERFACE_PLIST)) {
+            PlistInterface *interface = this->GetPlistInterface();
+            assert(interface);
+            interface->InterfacePreparePlist(functorParams, this);
+        }
+        return FUNCTOR_CONTINUE;
     }
 
-    std::string uuid = this->GetUuid();
-    auto i = std::find_if(params->m_interfaceUuidPairs.begin(), params->m_interfaceUuidPairs.end(),
-        [uuid](std::pair<PlistInterface *, std::string> pair) { return (pair.second == uuid); });
-    if (i != params->m_interfaceUuidPairs.end()) {
-        i->first->SetRef(this);
-        params->m_interfaceUuidPairs.erase(i);
+    auto range = params->m_interfaces.equal_range(this->GetUuid());
+    if (range.first == range.second) return FUNCTOR_CONTINUE;
+
+    MapOfUuidPlistInterfaces::iterator iter;
+    for (iter = range.first; iter != range.second; ++iter) {
+        iter->second->SetRef(this);
     }
+    params->m_interfaces.erase(range.first, range.second);
+
+    // Everything is matched
+    if (params->m_interfaces.empty()) return FUNCTOR_STOP;
 
     return FUNCTOR_CONTINUE;
 }
@@ -493,6 +493,12 @@ Options::Options()
     m_breaks.Init(BREAKS_auto, &Option::s_breaks);
     this->Register(&m_breaks, "breaks", &m_general);
 
+    m_detailThreshold.SetInfo("Detail threshold",
+        "The size in pixels below which text, lyrics, articulations and ornaments are not rendered and staff lines "
+        "are simplified (0 for rendering all the details)");
+    m_detailThreshold.Init(0.0, 0.0, 100.0);
+    this->Register(&m_detailThreshold, "detailThreshold", &m_general);
+
     m_evenNoteSpacing.SetInfo("Even note spacing", "Specify the linear spacing factor");
     m_evenNoteSpacing.Init(false);
     this->Register(&m_evenNoteSpacing, "evenNoteSpacing", &m_general);
@@ -574,10 +580,38 @@ Options::Options()
     m_pageWidth.Init(2100, 100, 60000, true);
     this->Register(&m_pageWidth, "pageWidth", &m_general);
 
+    m_pngWidth.SetInfo("PNG width", "The width in pixels of the PNG output (0 for the page width at the scale)");
+    m_pngWidth.Init(0, 0, 60000);
+    this->Register(&m_pngWidth, "pngWidth", &m_general);
+
+    m_progressiveLayout.SetInfo(
+        "Progressive layout", "Cast off the pages progressively when they are rendered instead of all at once");
+    m_progressiveLayout.Init(false);
+    this->Register(&m_progressiveLayout, "progressiveLayout", &m_general);
+
     m_svgBoundingBoxes.SetInfo("Svg bounding boxes viewbox on svg root", "Include bounding boxes in SVG output");
     m_svgBoundingBoxes.Init(false);
     this->Register(&m_svgBoundingBoxes, "svgBoundingBoxes", &m_general);
 
+    m_svgCompact.SetInfo("Compact SVG output",
+        "Write the SVG without indentation and with relative path commands (stroke of the lines in the style)");
+    m_svgCompact.Init(false);
+    this->Register(&m_svgCompact, "svgCompact", &m_general);
+
+    m_svgGlyphSprite.SetInfo("SVG glyph sprite",
+        "Set the URL of an external glyph sprite referenced in the SVG instead of the glyph definitions in each "
+        "page, for example: \"sprite.svg\"; the CLI writes the sprite there relative to the output");
+    m_svgGlyphSprite.Init("");
+    this->Register(&m_svgGlyphSprite, "svgGlyphSprite", &m_general);
+
+    m_svgRemoveEmptyGroups.SetInfo("Remove empty groups in SVG", "Do not write the <g> elements with no content");
+    m_svgRemoveEmptyGroups.Init(false);
+    this->Register(&m_svgRemoveEmptyGroups, "svgRemoveEmptyGroups", &m_general);
+
+    m_svgRemoveXlink.SetInfo("Remove xlink in SVG", "Write only @href (SVG 2) and not @xlink:href in <use> elements");
+    m_svgRemoveXlink.Init(false);
+    this->Register(&m_svgRemoveXlink, "svgRemoveXlink", &m_general);
+
     m_svgViewBox.SetInfo("Use viewbox on svg root", "Use viewBox on svg root element for easy scaling of document");
     m_svgViewBox.Init(false);
     this->Register(&m_svgViewBox, "svgViewBox", &m_general);
@@ -756,6 +790,17 @@ Options::Options()
     m_mdivXPathQuery.Init("");
     this->Register(&m_mdivXPathQuery, "mdivXPathQuery", &m_selectors);
 
+    m_measureRange.SetInfo("Measure range",
+        "Set the range of measures to be loaded (MEI only), for example: \"200-240\"; measures are matched by @n, "
+        "or by position when prefixed with #, for example: \"#1-#20\"; an open range such as \"200-\" is possible");
+    m_measureRange.Init("");
+    this->Register(&m_measureRange, "measureRange", &m_selectors);
+
+    m_staffSelection.SetInfo("Staff selection",
+        "Set the @n of a staff to be loaded (MEI only); all the staves are loaded if none is selected");
+    m_staffSelection.Init();
+    this->Register(&m_staffSelection, "staffSelection", &m_selectors);
+
     m_substXPathQuery.SetInfo("Subst xPath query",
         "Set the xPath query for selecting <subst> child elements, for "
         "example: \"./del\"; by default the first child is selected");
@@ -0,0 +1,848 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        pdfdevicecontext.cpp
+// Author:      agent
+// Created:     19/10/2026
+// Copyright (c) Authors and others. All rights reserved.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "pdfdevicecontext.h"
+
+//----------------------------------------------------------------------------
+
+#include <algorithm>
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+
+//----------------------------------------------------------------------------
+
+#include "atts_shared.h"
+#include "glyph.h"
+#include "object.h"
+#include "vrv.h"
+
+namespace vrv {
+
+/** The object numbers of the catalog, the page tree and the resources shared by all the pages */
+#define PDF_CATALOG 1
+#define PDF_PAGES 2
+#define PDF_RESOURCES 3
+
+//----------------------------------------------------------------------------
+// Static helpers
+//----------------------------------------------------------------------------
+
+/**
+ * Convert a character to the WinAnsi encoding (0 if it is not available)
+ */
+static unsigned char ToWinAnsi(wchar_t c)
+{
+    if ((c >= 0x20) && (c < 0x7F)) return (unsigned char)c;
+    if ((c >= 0xA0) && (c <= 0xFF)) return (unsigned char)c;
+    switch (c) {
+        case 0x20AC: return 0x80; // euro
+        case 0x2026: return 0x85; // ellipsis
+        case 0x2018: return 0x91; // quotes
+        case 0x2019: return 0x92;
+        case 0x201C: return 0x93;
+        case 0x201D: return 0x94;
+        case 0x2022: return 0x95; // bullet
+        case 0x2013: return 0x96; // dashes
+        case 0x2014: return 0x97;
+        default: return 0;
+    }
+}
+
+//----------------------------------------------------------------------------
+// PdfDeviceContext
+//----------------------------------------------------------------------------
+
+PdfDeviceContext::PdfDeviceContext(std::ostream &output) : DeviceContext(), m_output(output)
+{
+    m_position = 0;
+    m_pageWidth = 0.0;
+    m_pageHeight = 0.0;
+
+    m_fillColour = m_strokeColour = AxNONE;
+    m_fillAlpha = m_strokeAlpha = 255;
+    m_lineWidth = 1.0;
+    m_dashLength = 0;
+    m_lineRound = 0;
+
+    GroupState page;
+    page.m_colour = AxBLACK;
+    page.m_visible = true;
+    const double identity[6] = { 1.0, 0.0, 0.0, 1.0, 0.0, 0.0 };
+    std::copy(identity, identity + 6, page.m_transform);
+    m_groups.push_back(page);
+
+    m_textX = 0;
+    m_textY = 0;
+    m_textAlignment = HORIZONTALALIGNMENT_left;
+
+    m_originX = 0;
+    m_originY = 0;
+    m_facsimile = false;
+    m_ended = false;
+
+    SetBrush(AxNONE, AxSOLID);
+    SetPen(AxNONE, 1, AxSOLID);
+
+    // The header, with a comment of binary characters for the file to be detected as binary
+    this->Write("%PDF-1.4\n%\xE2\xE3\xCF\xD3\n");
+    // The object 0 (the head of the free list) and the objects written at the end
+    m_offsets.resize(PDF_RESOURCES + 1, 0);
+}
+
+PdfDeviceContext::~PdfDeviceContext() {}
+
+void PdfDeviceContext::SetLogicalOrigin(int x, int y)
+{
+    m_originX = -x;
+    m_originY = -y;
+}
+
+Point PdfDeviceContext::GetLogicalOrigin()
+{
+    return Point(m_originX, m_originY);
+}
+
+//----------------------------------------------------------------------------
+// Objects
+//----------------------------------------------------------------------------
+
+void PdfDeviceContext::Write(const std::string &data)
+{
+    m_output.write(data.data(), data.size());
+    m_position += data.size();
+}
+
+int PdfDeviceContext::AddObject()
+{
+    m_offsets.push_back(0);
+    return (int)m_offsets.size() - 1;
+}
+
+void PdfDeviceContext::WriteObject(int number, const std::string &dictionary)
+{
+    assert((number > 0) && (number < (int)m_offsets.size()));
+
+    m_offsets.at(number) = m_position;
+    this->Write(StringFormat("%d 0 obj\n", number));
+    this->Write(dictionary);
+    this->Write("\nendobj\n");
+}
+
+void PdfDeviceContext::WriteStream(int number, const std::string &entries, const std::string &stream)
+{
+    assert((number > 0) && (number < (int)m_offsets.size()));
+
+    std::string data = ZlibCompress(stream);
+    m_offsets.at(number) = m_position;
+    this->Write(StringFormat("%d 0 obj\n<< ", number));
+    this->Write(entries);
+    this->Write(StringFormat(" /Length %d /Filter /FlateDecode >>\nstream\n", (int)data.size()));
+    this->Write(data);
+    this->Write("\nendstream\nendobj\n");
+}
+
+bool PdfDeviceContext::EndDocument()
+{
+    if (m_ended) return m_output.good();
+    m_ended = true;
+
+    // The resources shared by all the pages
+    std::string resources = "<< /ProcSet [/PDF /Text]";
+    if (!m_fontObjects.empty()) {
+        resources += " /Font <<";
+        for (std::map<std::string, int>::iterator iter = m_fontObjects.begin(); iter != m_fontObjects.end(); ++iter) {
+            resources += StringFormat(" /F%d %d 0 R", iter->second, iter->second);
+        }
+        resources += " >>";
+    }
+    if (!m_glyphObjects.empty()) {
+        resources += " /XObject <<";
+        for (std::map<std::string, int>::iterator iter = m_glyphObjects.begin(); iter != m_glyphObjects.end();
+             ++iter) {
+            resources += StringFormat(" /G%d %d 0 R", iter->second, iter->second);
+        }
+        resources += " >>";
+    }
+    if (!m_alphas.empty()) {
+        // One graphics state for the fill alpha (f) and one for the stroke alpha (s) for each value used
+        resources += " /ExtGState <<";
+        for (std::set<int>::iterator iter = m_alphas.begin(); iter != m_alphas.end(); ++iter) {
+            resources += StringFormat(" /Af%d << /Type /ExtGState /ca %.3f >>", *iter, *iter / 255.0);
+            resources += StringFormat(" /As%d << /Type /ExtGState /CA %.3f >>", *iter, *iter / 255.0);
+        }
+        resources += " >>";
+    }
+    resources += " >>";
+    this->WriteObject(PDF_RESOURCES, resources);
+
+    std::string pages = "<< /Type /Pages /Kids [";
+    for (std::vector<int>::iterator iter = m_pageObjects.begin(); iter != m_pageObjects.end(); ++iter) {
+        if (iter != m_pageObjects.begin()) pages += " ";
+        pages += StringFormat("%d 0 R", *iter);
+    }
+    pages += StringFormat("] /Count %d >>", (int)m_pageObjects.size());
+    this->WriteObject(PDF_PAGES, pages);
+
+    this->WriteObject(PDF_CATALOG, StringFormat("<< /Type /Catalog /Pages %d 0 R >>", PDF_PAGES));
+
+    int info = this->AddObject();
+    this->WriteObject(info, "<< /Producer (Verovio " + GetVersion() + ") >>");
+
+    // The cross-reference table, with entries of exactly 20 bytes
+    size_t xref = m_position;
+    std::string table = StringFormat("xref\n0 %d\n0000000000 65535 f \n", (int)m_offsets.size());
+    for (size_t i = 1; i < m_offsets.size(); ++i) {
+        table += StringFormat("%010lu 00000 n \n", (unsigned long)m_offsets.at(i));
+    }
+    this->Write(table);
+    this->Write(StringFormat("trailer\n<< /Size %d /Root %d 0 R /Info %d 0 R >>\nstartxref\n%lu\n%%%%EOF\n",
+        (int)m_offsets.size(), PDF_CATALOG, info, (unsigned long)xref));
+
+    m_output.flush();
+    return m_output.good();
+}
+
+//----------------------------------------------------------------------------
+// Pages and groups
+//----------------------------------------------------------------------------
+
+void PdfDeviceContext::StartPage()
+{
+    assert(!m_ended);
+
+    // The page size as in the SVG with mm output, in points
+    int factor = (m_facsimile) ? 1 : DEFINITION_FACTOR;
+    m_pageWidth = std::max(this->GetWidth() * this->GetUserScaleX() * 72.0 / 254.0, 1.0);
+    m_pageHeight = std::max(this->GetHeight() * this->GetUserScaleY() * 72.0 / 254.0, 1.0);
+    double scale = m_pageWidth / std::max(this->GetWidth() * factor, 1);
+
+    m_content.clear();
+    m_fillColour = m_strokeColour = AxNONE;
+    m_fillAlpha = m_strokeAlpha = 255;
+    m_lineWidth = 1.0;
+    m_dashLength = 0;
+    m_lineRound = 0;
+
+    // The logical coordinates with the y axis going down
+    const double page[6] = { scale, 0.0, 0.0, -scale, 0.0, m_pageHeight };
+    this->AppendMatrix(page);
+    m_content += "cm\n";
+}
+
+void PdfDeviceContext::EndPage()
+{
+    int contents = this->AddObject();
+    this->WriteStream(contents, "", m_content);
+    m_content.clear();
+
+    int page = this->AddObject();
+    this->WriteObject(page,
+        StringFormat("<< /Type /Page /Parent %d 0 R /MediaBox [0 0 %.2f %.2f] /Resources %d 0 R /Contents %d 0 R >>",
+            PDF_PAGES, m_pageWidth, m_pageHeight, PDF_RESOURCES, contents));
+    m_pageObjects.push_back(page);
+
+    // The next page starts as with a new device context (the origin being set relative to the current one)
+    m_originX = 0;
+    m_originY = 0;
+    m_groups.resize(1);
+    m_groupStates.clear();
+}
+
+void PdfDeviceContext::PushGroup(Object *object, const std::string &gId)
+{
+    GroupState state = m_groups.back();
+    if (object && object->HasAttClass(ATT_COLOR)) {
+        AttColor *att = dynamic_cast<AttColor *>(object);
+        assert(att);
+        if (att->HasColor()) ParseColour(att->GetColor(), state.m_colour);
+    }
+    if (object && object->HasAttClass(ATT_VISIBILITY)) {
+        AttVisibility *att = dynamic_cast<AttVisibility *>(object);
+        assert(att);
+        if (att->GetVisible() == BOOLEAN_true) {
+            state.m_visible = true;
+        }
+        else if (att->GetVisible() == BOOLEAN_false) {
+            state.m_visible = false;
+        }
+    }
+    m_groups.push_back(state);
+    if (!gId.empty()) m_groupStates[gId] = state;
+}
+
+void PdfDeviceContext::PopGroup()
+{
+    if (m_groups.size() > 1) m_groups.pop_back();
+}
+
+void PdfDeviceContext::StartGraphic(Object *object, std::string gClass, std::string gId, bool prepend)
+{
+    this->PushGroup(object, gId);
+}
+
+void PdfDeviceContext::EndGraphic(Object *object, View *view)
+{
+    this->PopGroup();
+}
+
+void PdfDeviceContext::StartCustomGraphic(std::string name, std::string gClass, std::string gId)
+{
+    this->PushGroup(NULL, gId);
+}
+
+void PdfDeviceContext::EndCustomGraphic()
+{
+    this->PopGroup();
+}
+
+void PdfDeviceContext::ResumeGraphic(Object *object, std::string gId)
+{
+    std::map<std::string, GroupState>::iterator iter = m_groupStates.find(gId);
+    m_groups.push_back((iter != m_groupStates.end()) ? iter->second : m_groups.back());
+}
+
+void PdfDeviceContext::EndResumedGraphic(Object *object, View *view)
+{
+    this->PopGroup();
+}
+
+void PdfDeviceContext::StartTextGraphic(Object *object, std::string gClass, std::string gId)
+{
+    this->PushGroup(object, "");
+}
+
+void PdfDeviceContext::EndTextGraphic(Object *object, View *view)
+{
+    this->PopGroup();
+}
+
+void PdfDeviceContext::RotateGraphic(Point const &orig, double angle)
+{
+    // rotate(angle orig.x orig.y) applied before the current transformation
+    double *t = m_groups.back().m_transform;
+    double c = cos(DegToRad(angle));
+    double s = sin(DegToRad(angle));
+    double rotation[6] = { c, s, -s, c, orig.x - c * orig.x + s * orig.y, orig.y - s * orig.x - c * orig.y };
+    double result[6] = { t[0] * rotation[0] + t[2] * rotation[1], t[1] * rotation[0] + t[3] * rotation[1],
+        t[0] * rotation[2] + t[2] * rotation[3], t[1] * rotation[2] + t[3] * rotation[3],
+        t[0] * rotation[4] + t[2] * rotation[5] + t[4], t[1] * rotation[4] + t[3] * rotation[5] + t[5] };
+    std::copy(result, result + 6, t);
+}
+
+//----------------------------------------------------------------------------
+// Content
+//----------------------------------------------------------------------------
+
+void PdfDeviceContext::AppendNumber(double value, int decimals)
+{
+    // Without trailing zeros (and never with an exponent, which is not valid in PDF)
+    char buffer[64];
+    int length = snprintf(buffer, sizeof(buffer), "%.*f", decimals, value);
+    while ((length > 0) && (buffer[length - 1] == '0')) --length;
+    if ((length > 0) && (buffer[length - 1] == '.')) --length;
+    if ((length == 2) && (buffer[0] == '-') && (buffer[1] == '0')) {
+        buffer[0] = '0';
+        length = 1;
+    }
+    m_content.append(buffer, length);
+    m_content.push_back(' ');
+}
+
+void PdfDeviceContext::AppendPoint(double x, double y)
+{
+    const double *t = m_groups.back().m_transform;
+    this->AppendNumber(t[0] * x + t[2] * y + t[4] + m_originX);
+    this->AppendNumber(t[1] * x + t[3] * y + t[5] + m_originY);
+}
+
+void PdfDeviceContext::AppendMatrix(const double matrix[6])
+{
+    // Keep the precision of the scaling values
+    for (int i = 0; i < 6; ++i) this->AppendNumber(matrix[i], (i < 4) ? 6 : 2);
+}
+
+void PdfDeviceContext::AppendArc(
+    double cx, double cy, double rx, double ry, double start, double sweep, bool moveTo)
+{
+    // The arc counter-clockwise (with the y axis going down) in curves of 90 degrees at most
+    int n = std::max((int)ceil(fabs(sweep) / 90.0 - 0.001), 1);
+    double step = DegToRad(sweep / n);
+    double kappa = 4.0 / 3.0 * tan(step / 4.0);
+    double angle = DegToRad(start);
+    if (moveTo) {
+        this->AppendPoint(cx + rx * cos(angle), cy - ry * sin(angle));
+        m_content += "m\n";
+    }
+    for (int i = 0; i < n; ++i) {
+        double next = angle + step;
+        double x0 = cx + rx * cos(angle), y0 = cy - ry * sin(angle);
+        double x3 = cx + rx * cos(next), y3 = cy - ry * sin(next);
+        this->AppendPoint(x0 - kappa * rx * sin(angle), y0 - kappa * ry * cos(angle));
+        this->AppendPoint(x3 + kappa * rx * sin(next), y3 + kappa * ry * cos(next));
+        this->AppendPoint(x3, y3);
+        m_content += "c\n";
+        angle = next;
+    }
+}
+
+void PdfDeviceContext::SetFill(int colour, float opacity)
+{
+    if (colour == AxNONE) colour = m_groups.back().m_colour;
+    if (colour != m_fillColour) {
+        m_content += StringFormat("%.3g %.3g %.3g rg\n", ((colour >> 16) & 0xFF) / 255.0,
+            ((colour >> 8) & 0xFF) / 255.0, (colour & 0xFF) / 255.0);
+        m_fillColour = colour;
+    }
+    int alpha = std::min(std::max((int)(opacity * 255 + 0.5), 0), 255);
+    if (alpha != m_fillAlpha) {
+        m_content += StringFormat("/Af%d gs\n", alpha);
+        m_alphas.insert(alpha);
+        m_fillAlpha = alpha;
+    }
+}
+
+void PdfDeviceContext::SetStroke(int colour, float opacity, double width, int dashLength, bool round)
+{
+    if (colour == AxNONE) colour = m_groups.back().m_colour;
+    if (colour != m_strokeColour) {
+        m_content += StringFormat("%.3g %.3g %.3g RG\n", ((colour >> 16) & 0xFF) / 255.0,
+            ((colour >> 8) & 0xFF) / 255.0, (colour & 0xFF) / 255.0);
+        m_strokeColour = colour;
+    }
+    int alpha = std::min(std::max((int)(opacity * 255 + 0.5), 0), 255);
+    if (alpha != m_strokeAlpha) {
+        m_content += StringFormat("/As%d gs\n", alpha);
+        m_alphas.insert(alpha);
+        m_strokeAlpha = alpha;
+    }
+    if (width != m_lineWidth) {
+        this->AppendNumber(width);
+        m_content += "w\n";
+        m_lineWidth = width;
+    }
+    if (dashLength != m_dashLength) {
+        m_content += (dashLength > 0) ? StringFormat("[%d %d] 0 d\n", dashLength, dashLength) : "[] 0 d\n";
+        m_dashLength = dashLength;
+    }
+    // Round caps and joins (1) or the default butt caps and miter joins (0)
+    if ((int)round != m_lineRound) {
+        m_content += (round) ? "1 J 1 j\n" : "0 J 0 j\n";
+        m_lineRound = (int)round;
+    }
+}
+
+//----------------------------------------------------------------------------
+// Drawing methods
+//----------------------------------------------------------------------------
+
+void PdfDeviceContext::DrawComplexBezierPath(Point bezier1[4], Point bezier2[4])
+{
+    assert(m_penStack.size());
+
+    if (!m_groups.back().m_visible) return;
+
+    Pen currentPen = m_penStack.top();
+
+    // The shape is filled with the colour of the group and stroked as in the SVG
+    this->SetFill(AxNONE, 1.0f);
+    this->SetStroke(currentPen.GetColour(), 1.0f, currentPen.GetWidth(), 0, true);
+    this->AppendPoint(bezier1[0].x, bezier1[0].y);
+    m_content += "m\n";
+    this->AppendPoint(bezier1[1].x, bezier1[1].y);
+    this->AppendPoint(bezier1[2].x, bezier1[2].y);
+    this->AppendPoint(bezier1[3].x, bezier1[3].y);
+    m_content += "c\n";
+    this->AppendPoint(bezier2[2].x, bezier2[2].y);
+    this->AppendPoint(bezier2[1].x, bezier2[1].y);
+    this->AppendPoint(bezier2[0].x, bezier2[0].y);
+    m_content += (currentPen.GetWidth() > 0) ? "c\nB\n" : "c\nf\n";
+}
+
+void PdfDeviceContext::DrawCircle(int x, int y, int radius)
+{
+    DrawEllipse(x - radius, y - radius, 2 * radius, 2 * radius);
+}
+
+void PdfDeviceContext::DrawEllipse(int x, int y, int width, int height)
+{
+    assert(m_penStack.size());
+    assert(m_brushStack.size());
+
+    if (!m_groups.back().m_visible) return;
+
+    Pen currentPen = m_penStack.top();
+    Brush currentBrush = m_brushStack.top();
+
+    this->SetFill(currentBrush.GetColour(), currentBrush.GetOpacity());
+    if (currentPen.GetWidth() > 0) {
+        this->SetStroke(currentPen.GetColour(), currentPen.GetOpacity(), currentPen.GetWidth(), 0, false);
+    }
+    this->AppendArc(x + width / 2.0, y + height / 2.0, width / 2.0, height / 2.0, 0.0, 360.0, true);
+    m_content += (currentPen.GetWidth() > 0) ? "b\n" : "f\n";
+}
+
+void PdfDeviceContext::DrawEllipticArc(int x, int y, int width, int height, double start, double end)
+{
+    assert(m_penStack.size());
+    assert(m_brushStack.size());
+
+    if (!m_groups.back().m_visible) return;
+
+    Pen currentPen = m_penStack.top();
+    Brush currentBrush = m_brushStack.top();
+
+    // The arc is counter-clockwise from start to end (a complete ellipse if they are the same)
+    double sweep = end - start;
+    while (sweep <= 0.0) sweep += 360.0;
+
+    this->SetFill(currentBrush.GetColour(), currentBrush.GetOpacity());
+    if (currentPen.GetWidth() > 0) {
+        this->SetStroke(currentPen.GetColour(), currentPen.GetOpacity(), currentPen.GetWidth(), 0, false);
+    }
+    this->AppendArc(x + width / 2.0, y + height / 2.0, width / 2.0, height / 2.0, start, sweep, true);
+    // Filled as a closed shape but stroked along the arc only
+    m_content += (currentPen.GetWidth() > 0) ? "B\n" : "f\n";
+}
+
+void PdfDeviceContext::DrawLine(int x1, int y1, int x2, int y2)
+{
+    assert(m_penStack.size());
+
+    if (!m_groups.back().m_visible) return;
+
+    Pen currentPen = m_penStack.top();
+
+    int width = std::max(currentPen.GetWidth(), 1);
+    this->SetStroke(currentPen.GetColour(), 1.0f, width, currentPen.GetDashLength(), false);
+    this->AppendPoint(x1, y1);
+    m_content += "m ";
+    this->AppendPoint(x2, y2);
+    m_content += "l S\n";
+}
+
+void PdfDeviceContext::DrawPolygon(int n, Point points[], int xOffset, int yOffset, int fillStyle)
+{
+    assert(m_penStack.size());
+    assert(m_brushStack.size());
+
+    if ((n < 2) || !m_groups.back().m_visible) return;
+
+    Pen currentPen = m_penStack.top();
+    Brush currentBrush = m_brushStack.top();
+
+    this->SetFill(currentBrush.GetColour(), currentBrush.GetOpacity());
+    if (currentPen.GetWidth() > 0) {
+        this->SetStroke(currentPen.GetColour(), currentPen.GetOpacity(), currentPen.GetWidth(), 0, false);
+    }
+    this->AppendPoint(points[0].x + xOffset, points[0].y + yOffset);
+    m_content += "m\n";
+    for (int i = 1; i < n; ++i) {
+        this->AppendPoint(points[i].x + xOffset, points[i].y + yOffset);
+        m_content += "l\n";
+    }
+    m_content += (currentPen.GetWidth() > 0) ? "b\n" : "f\n";
+}
+
+void PdfDeviceContext::DrawRectangle(int x, int y, int width, int height)
+{
+    DrawRoundedRectangle(x, y, width, height, 0);
+}
+
+void PdfDeviceContext::DrawRoundedRectangle(int x, int y, int width, int height, double radius)
+{
+    if (!m_groups.back().m_visible) return;
+
+    if (height < 0) {
+        height = -height;
+        y -= height;
+    }
+    if (width < 0) {
+        width = -width;
+        x -= width;
+    }
+
+    // As in the SVG, the rectangle is filled with the colour of the group
+    this->SetFill(AxNONE, 1.0f);
+
+    radius = std::min(std::max(radius, 0.0), std::min(width, height) / 2.0);
+    if (radius == 0.0) {
+        this->AppendPoint(x, y);
+        m_content += "m ";
+        this->AppendPoint(x + width, y);
+        m_content += "l ";
+        this->AppendPoint(x + width, y + height);
+        m_content += "l ";
+        this->AppendPoint(x, y + height);
+        m_content += "l f\n";
+        return;
+    }
+
+    // the corners as quarters of an ellipse
+    this->AppendPoint(x + radius, y);
+    m_content += "m\n";
+    this->AppendPoint(x + width - radius, y);
+    m_content += "l\n";
+    this->AppendArc(x + width - radius, y + radius, radius, radius, 90.0, -90.0, false);
+    this->AppendPoint(x + width, y + height - radius);
+    m_content += "l\n";
+    this->AppendArc(x + width - radius, y + height - radius, radius, radius, 0.0, -90.0, false);
+    this->AppendPoint(x + radius, y + height);
+    m_content += "l\n";
+    this->AppendArc(x + radius, y + height - radius, radius, radius, 270.0, -90.0, false);
+    this->AppendPoint(x, y + radius);
+    m_content += "l\n";
+    this->AppendArc(x + radius, y + radius, radius, radius, 180.0, -90.0, false);
+    m_content += "f\n";
+}
+
+int PdfDeviceContext::GetGlyphObject(Glyph *glyph)
+{
+    const std::string path = glyph->GetPath();
+    std::map<std::string, int>::iterator iter = m_glyphObjects.find(path);
+    if (iter != m_glyphObjects.end()) return iter->second;
+
+    // The outline in the units of the glyph, filled with the colour set when drawing it.
+    // It is appended to an empty content (the content of the page being swapped)
+    const GlyphOutline &outline = glyph->GetOutline();
+    std::string content;
+    content.swap(m_content);
+    double minX = 0.0, minY = 0.0, maxX = 0.0, maxY = 0.0;
+    for (size_t i = 0; i + 1 < outline.m_coords.size(); i += 2) {
+        minX = std::min(minX, outline.m_coords[i]);
+        maxX = std::max(maxX, outline.m_coords[i]);
+        minY = std::min(minY, outline.m_coords[i + 1]);
+        maxY = std::max(maxY, outline.m_coords[i + 1]);
+    }
+    const double *coords = outline.m_coords.data();
+    for (std::vector<char>::const_iterator op = outline.m_ops.begin(); op != outline.m_ops.end(); ++op) {
+        int count = 0;
+        switch (*op) {
+            case 'M': count = 2; break;
+            case 'L': count = 2; break;
+            case 'C': count = 6; break;
+            default: break;
+        }
+        for (int i = 0; i < count; ++i) this->AppendNumber(coords[i]);
+        coords += count;
+        switch (*op) {
+            case 'M': m_content += "m\n"; break;
+            case 'L': m_content += "l\n"; break;
+            case 'C': m_content += "c\n"; break;
+            case 'Z': m_content += "h\n"; break;
+            default: break;
+        }
+    }
+    m_content += "f\n";
+    m_content.swap(content);
+
+    int object = this->AddObject();
+    this->WriteStream(object,
+        StringFormat("/Type /XObject /Subtype /Form /BBox [%d %d %d %d]", (int)floor(minX), (int)floor(minY),
+            (int)ceil(maxX), (int)ceil(maxY)),
+        content);
+    m_glyphObjects[path] = object;
+    return object;
+}
+
+void PdfDeviceContext::DrawGlyph(Glyph *glyph, int x, int y, int pointSize)
+{
+    int object = this->GetGlyphObject(glyph);
+    const GlyphOutline &outline = glyph->GetOutline();
+    const double *t = m_groups.back().m_transform;
+    const double scaleX = pointSize / outline.m_unitsX;
+    const double scaleY = pointSize / outline.m_unitsY;
+
+    // The glyph units to the logical coordinates, with the transformation of the group
+    const double matrix[6] = { t[0] * scaleX, t[1] * scaleX, t[2] * scaleY, t[3] * scaleY,
+        t[0] * x + t[2] * y + t[4] + m_originX, t[1] * x + t[3] * y + t[5] + m_originY };
+    m_content += "q ";
+    this->AppendMatrix(matrix);
+    m_content += StringFormat("cm /G%d Do Q\n", object);
+}
+
+void PdfDeviceContext::DrawMusicText(const std::wstring &text, int x, int y, bool setSmuflGlyph)
+{
+    assert(m_fontStack.top());
+
+    if (!m_groups.back().m_visible) return;
+
+    int w, h, gx, gy;
+    int pointSize = m_fontStack.top()->GetPointSize();
+
+    this->SetFill(AxNONE, 1.0f);
+    for (unsigned int i = 0; i < text.length(); ++i) {
+        wchar_t c = text.at(i);
+        Glyph *glyph = Resources::GetGlyph(c);
+        if (!glyph) {
+            continue;
+        }
+
+        this->DrawGlyph(glyph, x, y, pointSize);
+
+        // Advance as in the SVG
+        if (glyph->GetHorizAdvX() > 0)
+            x += glyph->GetHorizAdvX() * pointSize / glyph->GetUnitsPerEm();
+        else {
+            glyph->GetBoundingBox(gx, gy, w, h);
+            x += w * pointSize / glyph->GetUnitsPerEm();
+        }
+    }
+}
+
+//----------------------------------------------------------------------------
+// Text
+//----------------------------------------------------------------------------
+
+void PdfDeviceContext::StartText(int x, int y, data_HORIZONTALALIGNMENT alignment)
+{
+    m_textRuns.clear();
+    m_textX = x;
+    m_textY = y;
+    m_textAlignment = alignment;
+}
+
+void PdfDeviceContext::EndText()
+{
+    this->FlushTextLine();
+}
+
+void PdfDeviceContext::MoveTextTo(int x, int y, data_HORIZONTALALIGNMENT alignment)
+{
+    this->FlushTextLine();
+    m_textX = x;
+    m_textY = y;
+    if (alignment != HORIZONTALALIGNMENT_NONE) m_textAlignment = alignment;
+}
+
+void PdfDeviceContext::MoveTextVerticallyTo(int y)
+{
+    m_textY = y;
+}
+
+void PdfDeviceContext::DrawText(const std::string &text, const std::wstring wtext, int x, int y)
+{
+    assert(m_fontStack.top());
+
+    // A positioned run starts a new line
+    if ((x != VRV_UNSET) && (y != VRV_UNSET)) {
+        this->FlushTextLine();
+        m_textX = x;
+        m_textY = y;
+    }
+
+    TextRun run;
+    run.m_text = (wtext.empty()) ? UTF8to16(text) : wtext;
+    run.m_font = *m_fontStack.top();
+    run.m_colour = m_groups.back().m_colour;
+    run.m_visible = m_groups.back().m_visible;
+    run.m_y = m_textY;
+    m_textRuns.push_back(run);
+}
+
+int PdfDeviceContext::GetFontObject(FontInfo &font)
+{
+    bool bold = (font.GetWeight() == FONTWEIGHT_bold);
+    bool italic = (font.GetStyle() == FONTSTYLE_italic) || (font.GetStyle() == FONTSTYLE_oblique);
+    std::string baseFont = "Times-Roman";
+    if (bold && italic) {
+        baseFont = "Times-BoldItalic";
+    }
+    else if (bold) {
+        baseFont = "Times-Bold";
+    }
+    else if (italic) {
+        baseFont = "Times-Italic";
+    }
+
+    std::map<std::string, int>::iterator iter = m_fontObjects.find(baseFont);
+    if (iter != m_fontObjects.end()) return iter->second;
+
+    int object = this->AddObject();
+    this->WriteObject(
+        object, "<< /Type /Font /Subtype /Type1 /BaseFont /" + baseFont + " /Encoding /WinAnsiEncoding >>");
+    m_fontObjects[baseFont] = object;
+    return object;
+}
+
+void PdfDeviceContext::FlushTextLine()
+{
+    if (m_textRuns.empty()) return;
+
+    // The width of each run with the text font metrics used for the layout (SMuFL glyphs for VerovioText)
+    std::vector<int> widths(m_textRuns.size(), 0);
+    int lineWidth = 0;
+    int gx, gy, w, h;
+    for (size_t i = 0; i < m_textRuns.size(); ++i) {
+        TextRun &run = m_textRuns.at(i);
+        bool smufl = (run.m_font.GetFaceName() == "VerovioText");
+        for (std::wstring::iterator iter = run.m_text.begin(); iter != run.m_text.end(); ++iter) {
+            Glyph *glyph = (smufl) ? Resources::GetGlyph(*iter) : Resources::GetTextGlyph(*iter);
+            if (!glyph && !smufl) glyph = Resources::GetTextGlyph(L'o');
+            if (!glyph) continue;
+            glyph->GetBoundingBox(gx, gy, w, h);
+            int advX = (glyph->GetHorizAdvX() > 0) ? glyph->GetHorizAdvX() : w;
+            widths.at(i) += advX * run.m_font.GetPointSize() / glyph->GetUnitsPerEm();
+        }
+        lineWidth += widths.at(i);
+    }
+
+    int x = m_textX;
+    if (m_textAlignment == HORIZONTALALIGNMENT_center) {
+        x -= lineWidth / 2;
+    }
+    else if (m_textAlignment == HORIZONTALALIGNMENT_right) {
+        x -= lineWidth;
+    }
+
+    int colour = m_groups.back().m_colour;
+    for (size_t i = 0; i < m_textRuns.size(); ++i) {
+        TextRun &run = m_textRuns.at(i);
+        int pointSize = run.m_font.GetPointSize();
+        if (!run.m_visible || run.m_text.empty()) {
+            x += widths.at(i);
+            continue;
+        }
+        // Draw with the colour of the run
+        m_groups.back().m_colour = run.m_colour;
+        this->SetFill(AxNONE, 1.0f);
+        if (run.m_font.GetFaceName() == "VerovioText") {
+            int glyphX = x;
+            for (std::wstring::iterator iter = run.m_text.begin(); iter != run.m_text.end(); ++iter) {
+                Glyph *glyph = Resources::GetGlyph(*iter);
+                if (!glyph) continue;
+                this->DrawGlyph(glyph, glyphX, run.m_y, pointSize);
+                glyph->GetBoundingBox(gx, gy, w, h);
+                int advX = (glyph->GetHorizAdvX() > 0) ? glyph->GetHorizAdvX() : w;
+                glyphX += advX * pointSize / glyph->GetUnitsPerEm();
+            }
+        }
+        else {
+            std::string string;
+            for (std::wstring::iterator iter = run.m_text.begin(); iter != run.m_text.end(); ++iter) {
+                unsigned char c = ToWinAnsi(*iter);
+                if (c == 0) c = '?';
+                if ((c == '(') || (c == ')') || (c == '\\')) string.push_back('\\');
+                string.push_back((char)c);
+            }
+            // The text space with the y axis going up
+            const double *t = m_groups.back().m_transform;
+            const double matrix[6] = { t[0], t[1], -t[2], -t[3], t[0] * x + t[2] * run.m_y + t[4] + m_originX,
+                t[1] * x + t[3] * run.m_y + t[5] + m_originY };
+            m_content += StringFormat("BT /F%d %d Tf ", this->GetFontObject(run.m_font), pointSize);
+            this->AppendMatrix(matrix);
+            m_content += "Tm (" + string + ") Tj ET\n";
+        }
+        x += widths.at(i);
+    }
+    m_groups.back().m_colour = colour;
+
+    m_textRuns.clear();
+    m_textX = x;
+}
+
+} // namespace vrv
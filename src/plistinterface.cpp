@@ -102,7 +102,7 @@ int PlistInterface::InterfacePreparePlist(FunctorParams *functorParams, Object *
 
     std::vector<std::string>::iterator iter;
     for (iter = m_uuids.begin(); iter != m_uuids.end(); ++iter) {
-        params->m_interfaceUuidPairs.push_back(std::make_pair(this, *iter));
+        params->m_interfaces.emplace(*iter, this);
     }
 
     return FUNCTOR_CONTINUE;
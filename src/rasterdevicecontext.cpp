@@ -0,0 +1,886 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        rasterdevicecontext.cpp
+// Author:      agent
+// Created:     19/10/2026
+// Copyright (c) Authors and others. All rights reserved.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "rasterdevicecontext.h"
+
+//----------------------------------------------------------------------------
+
+#include <algorithm>
+#include <assert.h>
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wctype.h>
+
+//----------------------------------------------------------------------------
+
+#include "atts_shared.h"
+#include "glyph.h"
+#include "object.h"
+#include "vrv.h"
+
+// The maximum size of the RGB image in bytes (256 MB, e.g., about 9400 x 9400 pixels)
+#define RASTER_MAX_IMAGE_SIZE (256.0 * 1024 * 1024)
+
+namespace vrv {
+
+//----------------------------------------------------------------------------
+// RasterDeviceContext
+//----------------------------------------------------------------------------
+
+RasterDeviceContext::RasterDeviceContext(int pixelWidth) : DeviceContext()
+{
+    m_pixelWidth = std::max(pixelWidth, 0);
+    m_pixelHeight = 0;
+    m_scale = 1.0;
+    m_backgroundColour = AxWHITE;
+
+    m_edgesMinX = m_edgesMinY = m_edgesMaxX = m_edgesMaxY = 0.0;
+    m_hasContour = false;
+    m_startX = m_startY = m_currentX = m_currentY = 0.0;
+
+    GroupState page;
+    page.m_colour = AxBLACK;
+    page.m_visible = true;
+    const double identity[6] = { 1.0, 0.0, 0.0, 1.0, 0.0, 0.0 };
+    std::copy(identity, identity + 6, page.m_transform);
+    m_groups.push_back(page);
+
+    m_textX = 0;
+    m_textY = 0;
+    m_textAlignment = HORIZONTALALIGNMENT_left;
+
+    m_originX = 0;
+    m_originY = 0;
+    m_facsimile = false;
+
+    SetBrush(AxNONE, AxSOLID);
+    SetPen(AxNONE, 1, AxSOLID);
+}
+
+RasterDeviceContext::~RasterDeviceContext() {}
+
+void RasterDeviceContext::SetBackground(int colour, int style)
+{
+    m_backgroundColour = colour;
+}
+
+void RasterDeviceContext::SetLogicalOrigin(int x, int y)
+{
+    m_originX = -x;
+    m_originY = -y;
+}
+
+Point RasterDeviceContext::GetLogicalOrigin()
+{
+    return Point(m_originX, m_originY);
+}
+
+void RasterDeviceContext::StartPage()
+{
+    // The scale of the page to the image, the page being as in the viewBox of the SVG
+    int factor = (m_facsimile) ? 1 : DEFINITION_FACTOR;
+    double pixelWidth = (m_pixelWidth > 0) ? m_pixelWidth : floor(this->GetWidth() * this->GetUserScaleX() + 0.5);
+    pixelWidth = std::max(pixelWidth, 1.0);
+    double scale = pixelWidth / std::max(this->GetWidth() * factor, 1);
+    double pixelHeight = std::max(floor(this->GetHeight() * factor * scale + 0.5), 1.0);
+
+    // The size is checked in double for avoiding an overflow
+    if (pixelWidth * pixelHeight * 3 > RASTER_MAX_IMAGE_SIZE) {
+        LogError("The image of %.0f x %.0f pixels is too large", pixelWidth, pixelHeight);
+        m_pixelWidth = 0;
+        m_pixelHeight = 0;
+        m_image.clear();
+        return;
+    }
+
+    m_pixelWidth = (int)pixelWidth;
+    m_pixelHeight = (int)pixelHeight;
+    m_scale = scale;
+    m_image.resize((size_t)m_pixelWidth * m_pixelHeight * 3);
+    const unsigned char background[3] = { (unsigned char)((m_backgroundColour >> 16) & 0xFF),
+        (unsigned char)((m_backgroundColour >> 8) & 0xFF), (unsigned char)(m_backgroundColour & 0xFF) };
+    for (size_t i = 0; i < m_image.size(); i += 3) {
+        std::copy(background, background + 3, m_image.begin() + i);
+    }
+}
+
+void RasterDeviceContext::PushGroup(Object *object, const std::string &gId)
+{
+    GroupState state = m_groups.back();
+    if (object && object->HasAttClass(ATT_COLOR)) {
+        AttColor *att = dynamic_cast<AttColor *>(object);
+        assert(att);
+        if (att->HasColor()) ParseColour(att->GetColor(), state.m_colour);
+    }
+    if (object && object->HasAttClass(ATT_VISIBILITY)) {
+        AttVisibility *att = dynamic_cast<AttVisibility *>(object);
+        assert(att);
+        if (att->GetVisible() == BOOLEAN_true) {
+            state.m_visible = true;
+        }
+        else if (att->GetVisible() == BOOLEAN_false) {
+            state.m_visible = false;
+        }
+    }
+    m_groups.push_back(state);
+    if (!gId.empty()) m_groupStates[gId] = state;
+}
+
+void RasterDeviceContext::PopGroup()
+{
+    if (m_groups.size() > 1) m_groups.pop_back();
+}
+
+void RasterDeviceContext::StartGraphic(Object *object, std::string gClass, std::string gId, bool prepend)
+{
+    this->PushGroup(object, gId);
+}
+
+void RasterDeviceContext::EndGraphic(Object *object, View *view)
+{
+    this->PopGroup();
+}
+
+void RasterDeviceContext::StartCustomGraphic(std::string name, std::string gClass, std::string gId)
+{
+    this->PushGroup(NULL, gId);
+}
+
+void RasterDeviceContext::EndCustomGraphic()
+{
+    this->PopGroup();
+}
+
+void RasterDeviceContext::ResumeGraphic(Object *object, std::string gId)
+{
+    std::map<std::string, GroupState>::iterator iter = m_groupStates.find(gId);
+    m_groups.push_back((iter != m_groupStates.end()) ? iter->second : m_groups.back());
+}
+
+void RasterDeviceContext::EndResumedGraphic(Object *object, View *view)
+{
+    this->PopGroup();
+}
+
+void RasterDeviceContext::StartTextGraphic(Object *object, std::string gClass, std::string gId)
+{
+    this->PushGroup(object, "");
+}
+
+void RasterDeviceContext::EndTextGraphic(Object *object, View *view)
+{
+    this->PopGroup();
+}
+
+void RasterDeviceContext::RotateGraphic(Point const &orig, double angle)
+{
+    // rotate(angle orig.x orig.y) applied before the current transformation
+    double *t = m_groups.back().m_transform;
+    double c = cos(DegToRad(angle));
+    double s = sin(DegToRad(angle));
+    double rotation[6] = { c, s, -s, c, orig.x - c * orig.x + s * orig.y, orig.y - s * orig.x - c * orig.y };
+    double result[6] = { t[0] * rotation[0] + t[2] * rotation[1], t[1] * rotation[0] + t[3] * rotation[1],
+        t[0] * rotation[2] + t[2] * rotation[3], t[1] * rotation[2] + t[3] * rotation[3],
+        t[0] * rotation[4] + t[2] * rotation[5] + t[4], t[1] * rotation[4] + t[3] * rotation[5] + t[5] };
+    std::copy(result, result + 6, t);
+}
+
+//----------------------------------------------------------------------------
+// Path and rasteriser
+//----------------------------------------------------------------------------
+
+void RasterDeviceContext::MoveTo(double x, double y)
+{
+    this->ClosePath();
+    const double *t = m_groups.back().m_transform;
+    m_startX = m_currentX = (t[0] * x + t[2] * y + t[4] + m_originX) * m_scale;
+    m_startY = m_currentY = (t[1] * x + t[3] * y + t[5] + m_originY) * m_scale;
+    m_hasContour = true;
+}
+
+void RasterDeviceContext::LineTo(double x, double y)
+{
+    const double *t = m_groups.back().m_transform;
+    double px = (t[0] * x + t[2] * y + t[4] + m_originX) * m_scale;
+    double py = (t[1] * x + t[3] * y + t[5] + m_originY) * m_scale;
+    this->AddEdge(m_currentX, m_currentY, px, py);
+    m_currentX = px;
+    m_currentY = py;
+}
+
+void RasterDeviceContext::CurveTo(double x1, double y1, double x2, double y2, double x3, double y3)
+{
+    const double *t = m_groups.back().m_transform;
+    // the control points in pixels (the flattening does not depend on the transformation)
+    double p[8] = { m_currentX, m_currentY, 0, 0, 0, 0, 0, 0 };
+    const double in[6] = { x1, y1, x2, y2, x3, y3 };
+    for (int i = 0; i < 3; ++i) {
+        p[2 + 2 * i] = (t[0] * in[2 * i] + t[2] * in[2 * i + 1] + t[4] + m_originX) * m_scale;
+        p[3 + 2 * i] = (t[1] * in[2 * i] + t[3] * in[2 * i + 1] + t[5] + m_originY) * m_scale;
+    }
+    // the number of segments for a deviation of about a quarter of a pixel
+    double ddx = std::max(fabs(p[0] - 2 * p[2] + p[4]), fabs(p[2] - 2 * p[4] + p[6]));
+    double ddy = std::max(fabs(p[1] - 2 * p[3] + p[5]), fabs(p[3] - 2 * p[5] + p[7]));
+    int n = std::min(1 + (int)sqrt(3.0 * sqrt(ddx * ddx + ddy * ddy)), 64);
+    for (int i = 1; i <= n; ++i) {
+        double u = (double)i / n;
+        double v = 1.0 - u;
+        double a = v * v * v, b = 3 * v * v * u, c = 3 * v * u * u, d = u * u * u;
+        double px = a * p[0] + b * p[2] + c * p[4] + d * p[6];
+        double py = a * p[1] + b * p[3] + c * p[5] + d * p[7];
+        this->AddEdge(m_currentX, m_currentY, px, py);
+        m_currentX = px;
+        m_currentY = py;
+    }
+}
+
+void RasterDeviceContext::ClosePath()
+{
+    if (!m_hasContour) return;
+    this->AddEdge(m_currentX, m_currentY, m_startX, m_startY);
+    m_currentX = m_startX;
+    m_currentY = m_startY;
+    m_hasContour = false;
+}
+
+void RasterDeviceContext::AddStroke(double x1, double y1, double x2, double y2, double width)
+{
+    double length = sqrt((x2 - x1) * (x2 - x1) + (y2 - y1) * (y2 - y1));
+    if (length == 0.0) return;
+    // all the segments have the same orientation so overlapping ones do not cancel each other
+    double nx = -(y2 - y1) / length * width / 2;
+    double ny = (x2 - x1) / length * width / 2;
+    this->MoveTo(x1 + nx, y1 + ny);
+    this->LineTo(x2 + nx, y2 + ny);
+    this->LineTo(x2 - nx, y2 - ny);
+    this->LineTo(x1 - nx, y1 - ny);
+    this->ClosePath();
+}
+
+void RasterDeviceContext::AddEllipse(double x, double y, double width, double height)
+{
+    // four cubic curves
+    const double kappa = 0.5522847498;
+    double rx = width / 2, ry = height / 2;
+    double cx = x + rx, cy = y + ry;
+    this->MoveTo(cx + rx, cy);
+    this->CurveTo(cx + rx, cy + kappa * ry, cx + kappa * rx, cy + ry, cx, cy + ry);
+    this->CurveTo(cx - kappa * rx, cy + ry, cx - rx, cy + kappa * ry, cx - rx, cy);
+    this->CurveTo(cx - rx, cy - kappa * ry, cx - kappa * rx, cy - ry, cx, cy - ry);
+    this->CurveTo(cx + kappa * rx, cy - ry, cx + rx, cy - kappa * ry, cx + rx, cy);
+    this->ClosePath();
+}
+
+void RasterDeviceContext::AddEdge(double x0, double y0, double x1, double y1)
+{
+    if (m_edges.empty()) {
+        m_edgesMinX = m_edgesMaxX = x0;
+        m_edgesMinY = m_edgesMaxY = y0;
+    }
+    m_edgesMinX = std::min(m_edgesMinX, std::min(x0, x1));
+    m_edgesMaxX = std::max(m_edgesMaxX, std::max(x0, x1));
+    m_edgesMinY = std::min(m_edgesMinY, std::min(y0, y1));
+    m_edgesMaxY = std::max(m_edgesMaxY, std::max(y0, y1));
+    m_edges.push_back(x0);
+    m_edges.push_back(y0);
+    m_edges.push_back(x1);
+    m_edges.push_back(y1);
+}
+
+void RasterDeviceContext::FillPath(int colour, float opacity)
+{
+    this->ClosePath();
+
+    // the bounding box of the path within the image
+    int left = std::max((int)floor(m_edgesMinX), 0);
+    int top = std::max((int)floor(m_edgesMinY), 0);
+    int right = std::min((int)ceil(m_edgesMaxX), m_pixelWidth);
+    int bottom = std::min((int)ceil(m_edgesMaxY), m_pixelHeight);
+    if (m_edges.empty() || (left >= right) || (top >= bottom) || (opacity <= 0.0)
+        || !m_groups.back().m_visible) {
+        m_edges.clear();
+        return;
+    }
+
+    int width = right - left;
+    int height = bottom - top;
+    m_coverage.assign((width + 2) * height, 0.0f);
+    for (size_t i = 0; i < m_edges.size(); i += 4) {
+        this->AccumulateEdge(
+            m_edges[i] - left, m_edges[i + 1] - top, m_edges[i + 2] - left, m_edges[i + 3] - top, width, height);
+    }
+    m_edges.clear();
+
+    if (colour == AxNONE) colour = m_groups.back().m_colour;
+    const float rgb[3] = { (float)((colour >> 16) & 0xFF), (float)((colour >> 8) & 0xFF), (float)(colour & 0xFF) };
+
+    // the coverage is the accumulation of the signed areas along each row
+    for (int y = 0; y < height; ++y) {
+        const float *cell = &m_coverage[y * (width + 2)];
+        unsigned char *pixel = &m_image[((top + y) * m_pixelWidth + left) * 3];
+        float accumulation = 0.0f;
+        for (int x = 0; x < width; ++x, pixel += 3) {
+            accumulation += cell[x];
+            float alpha = std::min(fabsf(accumulation), 1.0f) * opacity;
+            if (alpha < 1.0f / 512) continue;
+            for (int i = 0; i < 3; ++i) {
+                pixel[i] = (unsigned char)(pixel[i] + (rgb[i] - pixel[i]) * alpha + 0.5f);
+            }
+        }
+    }
+}
+
+void RasterDeviceContext::AccumulateEdge(double x0, double y0, double x1, double y1, int width, int height)
+{
+    // The parts on the left and on the right of the buffer are projected on its borders
+    const double limits[2] = { 0.0, (double)width };
+    for (int i = 0; i < 2; ++i) {
+        double limit = limits[i];
+        if ((x0 - limit) * (x1 - limit) < 0.0) {
+            double y = y0 + (y1 - y0) * (limit - x0) / (x1 - x0);
+            this->AccumulateEdge(x0, y0, limit, y, width, height);
+            this->AccumulateEdge(limit, y, x1, y1, width, height);
+            return;
+        }
+    }
+    x0 = std::min(std::max(x0, 0.0), (double)width);
+    x1 = std::min(std::max(x1, 0.0), (double)width);
+    this->AccumulateLine(x0, y0, x1, y1, width, height);
+}
+
+void RasterDeviceContext::AccumulateLine(double x0, double y0, double x1, double y1, int width, int height)
+{
+    if (y0 == y1) return;
+    // the winding direction, with the segment going down
+    double direction = 1.0;
+    if (y0 > y1) {
+        std::swap(x0, x1);
+        std::swap(y0, y1);
+        direction = -1.0;
+    }
+    double dxdy = (x1 - x0) / (y1 - y0);
+    double x = x0;
+    if (y0 < 0.0) x -= y0 * dxdy;
+    int yStart = std::max((int)y0, 0);
+    int yEnd = std::min((int)ceil(y1), height);
+    const int stride = width + 2;
+
+    for (int y = yStart; y < yEnd; ++y) {
+        float *row = &m_coverage[y * stride];
+        double dy = std::min((double)(y + 1), y1) - std::max((double)y, y0);
+        double xNext = x + dxdy * dy;
+        double d = dy * direction;
+        double xa = std::min(x, xNext);
+        double xb = std::max(x, xNext);
+        double xaFloor = floor(xa);
+        int xai = (int)xaFloor;
+        double xbCeil = ceil(xb);
+        int xbi = (int)xbCeil;
+        if (xbi <= xai + 1) {
+            // within one pixel, split with the pixel on the right by the middle of the segment
+            double xm = 0.5 * (x + xNext) - xaFloor;
+            row[xai] += (float)(d - d * xm);
+            row[xai + 1] += (float)(d * xm);
+        }
+        else {
+            // over several pixels, the area of the trapezoids in each pixel
+            double s = 1.0 / (xb - xa);
+            double xaf = xa - xaFloor;
+            double a0 = 0.5 * s * (1.0 - xaf) * (1.0 - xaf);
+            double xbf = xb - xbCeil + 1.0;
+            double am = 0.5 * s * xbf * xbf;
+            row[xai] += (float)(d * a0);
+            if (xbi == xai + 2) {
+                row[xai + 1] += (float)(d * (1.0 - a0 - am));
+            }
+            else {
+                double a1 = s * (1.5 - xaf);
+                row[xai + 1] += (float)(d * (a1 - a0));
+                for (int xi = xai + 2; xi < xbi - 1; ++xi) {
+                    row[xi] += (float)(d * s);
+                }
+                double a2 = a1 + (xbi - xai - 3) * s;
+                row[xbi - 1] += (float)(d * (1.0 - a2 - am));
+            }
+            row[xbi] += (float)(d * am);
+        }
+        x = xNext;
+    }
+}
+
+//----------------------------------------------------------------------------
+// Drawing methods
+//----------------------------------------------------------------------------
+
+void RasterDeviceContext::DrawComplexBezierPath(Point bezier1[4], Point bezier2[4])
+{
+    assert(m_penStack.size());
+
+    // The shape is filled with the colour of the group and stroked as in the SVG
+    this->MoveTo(bezier1[0].x, bezier1[0].y);
+    this->CurveTo(bezier1[1].x, bezier1[1].y, bezier1[2].x, bezier1[2].y, bezier1[3].x, bezier1[3].y);
+    this->CurveTo(bezier2[2].x, bezier2[2].y, bezier2[1].x, bezier2[1].y, bezier2[0].x, bezier2[0].y);
+    this->FillPath(AxNONE, 1.0f);
+
+    Pen currentPen = m_penStack.top();
+    if (currentPen.GetWidth() <= 0) return;
+
+    // The stroke along the two curves, flattened in logical coordinates
+    Point *curves[2] = { bezier1, bezier2 };
+    for (int c = 0; c < 2; ++c) {
+        const Point *p = curves[c];
+        double ddx = std::max(abs(p[0].x - 2 * p[1].x + p[2].x), abs(p[1].x - 2 * p[2].x + p[3].x)) * m_scale;
+        double ddy = std::max(abs(p[0].y - 2 * p[1].y + p[2].y), abs(p[1].y - 2 * p[2].y + p[3].y)) * m_scale;
+        int n = std::min(1 + (int)sqrt(3.0 * sqrt(ddx * ddx + ddy * ddy)), 64);
+        double lastX = p[0].x, lastY = p[0].y;
+        for (int i = 1; i <= n; ++i) {
+            double u = (double)i / n;
+            double v = 1.0 - u;
+            double a = v * v * v, b = 3 * v * v * u, cc = 3 * v * u * u, d = u * u * u;
+            double x = a * p[0].x + b * p[1].x + cc * p[2].x + d * p[3].x;
+            double y = a * p[0].y + b * p[1].y + cc * p[2].y + d * p[3].y;
+            this->AddStroke(lastX, lastY, x, y, currentPen.GetWidth());
+            lastX = x;
+            lastY = y;
+        }
+    }
+    this->FillPath(currentPen.GetColour(), 1.0f);
+}
+
+void RasterDeviceContext::DrawCircle(int x, int y, int radius)
+{
+    DrawEllipse(x - radius, y - radius, 2 * radius, 2 * radius);
+}
+
+void RasterDeviceContext::DrawEllipse(int x, int y, int width, int height)
+{
+    assert(m_penStack.size());
+    assert(m_brushStack.size());
+
+    Pen currentPen = m_penStack.top();
+    Brush currentBrush = m_brushStack.top();
+
+    this->AddEllipse(x, y, width, height);
+    this->FillPath(currentBrush.GetColour(), currentBrush.GetOpacity());
+
+    if (currentPen.GetWidth() > 0) {
+        // the stroke as the ring between the outer and the inner ellipses (in opposite directions)
+        double w = currentPen.GetWidth();
+        this->AddEllipse(x - w / 2, y - w / 2, width + w, height + w);
+        if ((width > w) && (height > w)) {
+            double rx = (width - w) / 2, ry = (height - w) / 2;
+            double cx = x + width / 2.0, cy = y + height / 2.0;
+            const int steps = 32;
+            this->MoveTo(cx + rx, cy);
+            for (int i = 1; i <= steps; ++i) {
+                double angle = -2 * M_PI * i / steps;
+                this->LineTo(cx + rx * cos(angle), cy + ry * sin(angle));
+            }
+        }
+        this->FillPath(currentPen.GetColour(), currentPen.GetOpacity());
+    }
+}
+
+void RasterDeviceContext::DrawEllipticArc(int x, int y, int width, int height, double start, double end)
+{
+    assert(m_penStack.size());
+    assert(m_brushStack.size());
+
+    Pen currentPen = m_penStack.top();
+    Brush currentBrush = m_brushStack.top();
+
+    // The arc is counter-clockwise from start to end (a complete ellipse if they are the same)
+    double rx = width / 2.0, ry = height / 2.0;
+    double cx = x + rx, cy = y + ry;
+    double sweep = end - start;
+    while (sweep <= 0.0) sweep += 360.0;
+    int n = std::max((int)(sweep / 10.0), 2);
+    std::vector<double> points;
+    for (int i = 0; i <= n; ++i) {
+        double angle = DegToRad(start + sweep * i / n);
+        points.push_back(cx + rx * cos(angle));
+        points.push_back(cy - ry * sin(angle));
+    }
+
+    this->MoveTo(points[0], points[1]);
+    for (size_t i = 2; i < points.size(); i += 2) this->LineTo(points[i], points[i + 1]);
+    this->FillPath(currentBrush.GetColour(), currentBrush.GetOpacity());
+
+    if (currentPen.GetWidth() > 0) {
+        for (size_t i = 2; i < points.size(); i += 2) {
+            this->AddStroke(points[i - 2], points[i - 1], points[i], points[i + 1], currentPen.GetWidth());
+        }
+        this->FillPath(currentPen.GetColour(), currentPen.GetOpacity());
+    }
+}
+
+void RasterDeviceContext::DrawLine(int x1, int y1, int x2, int y2)
+{
+    assert(m_penStack.size());
+
+    Pen currentPen = m_penStack.top();
+    double width = std::max(currentPen.GetWidth(), 1);
+    int dashLength = currentPen.GetDashLength();
+
+    if (dashLength <= 0) {
+        this->AddStroke(x1, y1, x2, y2, width);
+    }
+    else {
+        // dashes and gaps of the same length
+        double length = sqrt((double)(x2 - x1) * (x2 - x1) + (double)(y2 - y1) * (y2 - y1));
+        for (double dash = 0.0; dash < length; dash += 2 * dashLength) {
+            double from = dash / length;
+            double to = std::min(dash + dashLength, length) / length;
+            this->AddStroke(
+                x1 + (x2 - x1) * from, y1 + (y2 - y1) * from, x1 + (x2 - x1) * to, y1 + (y2 - y1) * to, width);
+        }
+    }
+    this->FillPath(currentPen.GetColour(), 1.0f);
+}
+
+void RasterDeviceContext::DrawPolygon(int n, Point points[], int xOffset, int yOffset, int fillStyle)
+{
+    assert(m_penStack.size());
+    assert(m_brushStack.size());
+
+    if (n < 2) return;
+
+    Pen currentPen = m_penStack.top();
+    Brush currentBrush = m_brushStack.top();
+
+    this->MoveTo(points[0].x + xOffset, points[0].y + yOffset);
+    for (int i = 1; i < n; ++i) {
+        this->LineTo(points[i].x + xOffset, points[i].y + yOffset);
+    }
+    this->FillPath(currentBrush.GetColour(), currentBrush.GetOpacity());
+
+    if (currentPen.GetWidth() > 0) {
+        for (int i = 0; i < n; ++i) {
+            const Point &p1 = points[i];
+            const Point &p2 = points[(i + 1) % n];
+            this->AddStroke(p1.x + xOffset, p1.y + yOffset, p2.x + xOffset, p2.y + yOffset, currentPen.GetWidth());
+        }
+        this->FillPath(currentPen.GetColour(), currentPen.GetOpacity());
+    }
+}
+
+void RasterDeviceContext::DrawRectangle(int x, int y, int width, int height)
+{
+    DrawRoundedRectangle(x, y, width, height, 0);
+}
+
+void RasterDeviceContext::DrawRoundedRectangle(int x, int y, int width, int height, double radius)
+{
+    if (height < 0) {
+        height = -height;
+        y -= height;
+    }
+    if (width < 0) {
+        width = -width;
+        x -= width;
+    }
+
+    radius = std::min(std::max(radius, 0.0), std::min(width, height) / 2.0);
+    if (radius == 0.0) {
+        this->MoveTo(x, y);
+        this->LineTo(x + width, y);
+        this->LineTo(x + width, y + height);
+        this->LineTo(x, y + height);
+    }
+    else {
+        // the corners as quarters of a circle
+        const double kappa = 0.5522847498 * radius;
+        this->MoveTo(x + radius, y);
+        this->LineTo(x + width - radius, y);
+        this->CurveTo(x + width - radius + kappa, y, x + width, y + radius - kappa, x + width, y + radius);
+        this->LineTo(x + width, y + height - radius);
+        this->CurveTo(x + width, y + height - radius + kappa, x + width - radius + kappa, y + height,
+            x + width - radius, y + height);
+        this->LineTo(x + radius, y + height);
+        this->CurveTo(x + radius - kappa, y + height, x, y + height - radius + kappa, x, y + height - radius);
+        this->LineTo(x, y + radius);
+        this->CurveTo(x, y + radius - kappa, x + radius - kappa, y, x + radius, y);
+    }
+    // As in the SVG, the rectangle is filled with the colour of the group
+    this->FillPath(AxNONE, 1.0f);
+}
+
+void RasterDeviceContext::FillGlyph(Glyph *glyph, int x, int y, int pointSize, int colour)
+{
+    const GlyphOutline &outline = glyph->GetOutline();
+    const double scaleX = pointSize / outline.m_unitsX;
+    const double scaleY = pointSize / outline.m_unitsY;
+    const double *coords = outline.m_coords.data();
+
+    for (std::vector<char>::const_iterator iter = outline.m_ops.begin(); iter != outline.m_ops.end(); ++iter) {
+        switch (*iter) {
+            case 'M':
+                this->MoveTo(x + coords[0] * scaleX, y + coords[1] * scaleY);
+                coords += 2;
+                break;
+            case 'L':
+                this->LineTo(x + coords[0] * scaleX, y + coords[1] * scaleY);
+                coords += 2;
+                break;
+            case 'C':
+                this->CurveTo(x + coords[0] * scaleX, y + coords[1] * scaleY, x + coords[2] * scaleX,
+                    y + coords[3] * scaleY, x + coords[4] * scaleX, y + coords[5] * scaleY);
+                coords += 6;
+                break;
+            case 'Z': this->ClosePath(); break;
+            default: break;
+        }
+    }
+    this->FillPath(colour, 1.0f);
+}
+
+void RasterDeviceContext::DrawMusicText(const std::wstring &text, int x, int y, bool setSmuflGlyph)
+{
+    assert(m_fontStack.top());
+
+    int w, h, gx, gy;
+    int pointSize = m_fontStack.top()->GetPointSize();
+
+    for (unsigned int i = 0; i < text.length(); ++i) {
+        wchar_t c = text.at(i);
+        Glyph *glyph = Resources::GetGlyph(c);
+        if (!glyph) {
+            continue;
+        }
+
+        this->FillGlyph(glyph, x, y, pointSize, AxNONE);
+
+        // Advance as in the SVG
+        if (glyph->GetHorizAdvX() > 0)
+            x += glyph->GetHorizAdvX() * pointSize / glyph->GetUnitsPerEm();
+        else {
+            glyph->GetBoundingBox(gx, gy, w, h);
+            x += w * pointSize / glyph->GetUnitsPerEm();
+        }
+    }
+}
+
+//----------------------------------------------------------------------------
+// Text
+//----------------------------------------------------------------------------
+
+void RasterDeviceContext::StartText(int x, int y, data_HORIZONTALALIGNMENT alignment)
+{
+    m_textRuns.clear();
+    m_textX = x;
+    m_textY = y;
+    m_textAlignment = alignment;
+}
+
+void RasterDeviceContext::EndText()
+{
+    this->FlushTextLine();
+}
+
+void RasterDeviceContext::MoveTextTo(int x, int y, data_HORIZONTALALIGNMENT alignment)
+{
+    this->FlushTextLine();
+    m_textX = x;
+    m_textY = y;
+    if (alignment != HORIZONTALALIGNMENT_NONE) m_textAlignment = alignment;
+}
+
+void RasterDeviceContext::MoveTextVerticallyTo(int y)
+{
+    m_textY = y;
+}
+
+void RasterDeviceContext::DrawText(const std::string &text, const std::wstring wtext, int x, int y)
+{
+    assert(m_fontStack.top());
+
+    // A positioned run starts a new line
+    if ((x != VRV_UNSET) && (y != VRV_UNSET)) {
+        this->FlushTextLine();
+        m_textX = x;
+        m_textY = y;
+    }
+
+    TextRun run;
+    run.m_text = (wtext.empty()) ? UTF8to16(text) : wtext;
+    run.m_font = *m_fontStack.top();
+    run.m_colour = m_groups.back().m_colour;
+    run.m_visible = m_groups.back().m_visible;
+    run.m_y = m_textY;
+    m_textRuns.push_back(run);
+}
+
+void RasterDeviceContext::FlushTextLine()
+{
+    if (m_textRuns.empty()) return;
+
+    // The advance of each character (SMuFL glyphs for the VerovioText font and the text font otherwise)
+    std::vector<std::vector<int> > advances(m_textRuns.size());
+    int lineWidth = 0;
+    int gx, gy, w, h;
+    for (size_t i = 0; i < m_textRuns.size(); ++i) {
+        TextRun &run = m_textRuns.at(i);
+        bool smufl = (run.m_font.GetFaceName() == "VerovioText");
+        for (std::wstring::iterator iter = run.m_text.begin(); iter != run.m_text.end(); ++iter) {
+            Glyph *glyph = (smufl) ? Resources::GetGlyph(*iter) : Resources::GetTextGlyph(*iter);
+            if (!glyph && !smufl) glyph = Resources::GetTextGlyph(L'o');
+            int advance = 0;
+            if (glyph) {
+                glyph->GetBoundingBox(gx, gy, w, h);
+                int advX = (glyph->GetHorizAdvX() > 0) ? glyph->GetHorizAdvX() : w;
+                advance = advX * run.m_font.GetPointSize() / glyph->GetUnitsPerEm();
+            }
+            advances.at(i).push_back(advance);
+            lineWidth += advance;
+        }
+    }
+
+    int x = m_textX;
+    if (m_textAlignment == HORIZONTALALIGNMENT_center) {
+        x -= lineWidth / 2;
+    }
+    else if (m_textAlignment == HORIZONTALALIGNMENT_right) {
+        x -= lineWidth;
+    }
+
+    std::vector<GroupState> groups = m_groups;
+    for (size_t i = 0; i < m_textRuns.size(); ++i) {
+        TextRun &run = m_textRuns.at(i);
+        // Draw with the colour and the visibility of the run
+        m_groups.back().m_colour = run.m_colour;
+        m_groups.back().m_visible = run.m_visible;
+        bool smufl = (run.m_font.GetFaceName() == "VerovioText");
+        int pointSize = run.m_font.GetPointSize();
+        for (size_t j = 0; j < run.m_text.size(); ++j) {
+            wchar_t c = run.m_text.at(j);
+            if (smufl) {
+                Glyph *glyph = Resources::GetGlyph(c);
+                if (glyph) this->FillGlyph(glyph, x, run.m_y, pointSize, AxNONE);
+            }
+            else {
+                // Greeking with the bounding box of the character
+                Glyph *glyph = Resources::GetTextGlyph(c);
+                if (!glyph && !iswspace(c)) glyph = Resources::GetTextGlyph(L'o');
+                if (glyph) {
+                    glyph->GetBoundingBox(gx, gy, w, h);
+                    double unit = (double)pointSize / glyph->GetUnitsPerEm();
+                    if ((w > 0) && (h > 0)) {
+                        this->MoveTo(x + gx * unit, run.m_y - (gy + h) * unit);
+                        this->LineTo(x + (gx + w) * unit, run.m_y - (gy + h) * unit);
+                        this->LineTo(x + (gx + w) * unit, run.m_y - gy * unit);
+                        this->LineTo(x + gx * unit, run.m_y - gy * unit);
+                        this->FillPath(AxNONE, 0.5f);
+                    }
+                }
+            }
+            x += advances.at(i).at(j);
+        }
+    }
+    m_groups = groups;
+
+    m_textRuns.clear();
+    m_textX = x;
+}
+
+//----------------------------------------------------------------------------
+// PNG encoding
+//----------------------------------------------------------------------------
+
+enum PNGFilter { PNG_FILTER_NONE = 0, PNG_FILTER_SUB, PNG_FILTER_UP, PNG_FILTER_AVERAGE, PNG_FILTER_PAETH };
+
+/**
+ * Filter a row of RGB pixels and return the sum of the absolute values of the filtered bytes.
+ * The filtering stops when the sum reaches the limit.
+ */
+static long FilterPNGRow(unsigned char filter, const unsigned char *row, const unsigned char *above, int stride,
+    unsigned char *output, long limit)
+{
+    long sum = 0;
+    for (int i = 0; (i < stride) && (sum < limit); ++i) {
+        int a = (i >= 3) ? row[i - 3] : 0;
+        int predictor = 0;
+        if (filter == PNG_FILTER_SUB) {
+            predictor = a;
+        }
+        else if (filter == PNG_FILTER_UP) {
+            predictor = above[i];
+        }
+        else if (filter == PNG_FILTER_PAETH) {
+            int b = above[i];
+            int c = (i >= 3) ? above[i - 3] : 0;
+            int p = a + b - c;
+            int pa = abs(p - a), pb = abs(p - b), pc = abs(p - c);
+            predictor = ((pa <= pb) && (pa <= pc)) ? a : ((pb <= pc) ? b : c);
+        }
+        output[i] = (unsigned char)(row[i] - predictor);
+        sum += (output[i] < 128) ? output[i] : 256 - output[i];
+    }
+    return sum;
+}
+
+static void AppendPNGChunk(std::string &png, const char *type, const std::string &data)
+{
+    const unsigned int size = (unsigned int)data.size();
+    for (int i = 3; i >= 0; --i) png.push_back(char((size >> (8 * i)) & 0xFF));
+    std::string chunk = type;
+    chunk.append(data);
+    png.append(chunk);
+    const unsigned int crc = Crc32(chunk);
+    for (int i = 3; i >= 0; --i) png.push_back(char((crc >> (8 * i)) & 0xFF));
+}
+
+std::string RasterDeviceContext::GetPNG() const
+{
+    if (m_image.empty()) return "";
+
+    const int stride = m_pixelWidth * 3;
+
+    // Each row is filtered with the filter giving the smallest sum of absolute differences
+    std::string filtered;
+    filtered.reserve((stride + 1) * m_pixelHeight);
+    std::vector<unsigned char> candidate(stride);
+    std::vector<unsigned char> best(stride);
+    const std::vector<unsigned char> zeros(stride, 0);
+    // up first since most rows are the same as the one above (i.e., a sum of 0)
+    const unsigned char filters[4] = { PNG_FILTER_UP, PNG_FILTER_SUB, PNG_FILTER_NONE, PNG_FILTER_PAETH };
+    for (int y = 0; y < m_pixelHeight; ++y) {
+        const unsigned char *row = &m_image[y * stride];
+        const unsigned char *above = (y > 0) ? &m_image[(y - 1) * stride] : zeros.data();
+        long bestSum = LONG_MAX;
+        unsigned char bestFilter = PNG_FILTER_NONE;
+        for (int f = 0; (f < 4) && (bestSum > 0); ++f) {
+            long sum = FilterPNGRow(filters[f], row, above, stride, candidate.data(), bestSum);
+            if (sum < bestSum) {
+                bestSum = sum;
+                bestFilter = filters[f];
+                best.swap(candidate);
+            }
+        }
+        filtered.push_back((char)bestFilter);
+        filtered.append((const char *)best.data(), stride);
+    }
+
+    std::string png("\x89PNG\r\n\x1A\n", 8);
+    std::string header;
+    const unsigned int size[2] = { (unsigned int)m_pixelWidth, (unsigned int)m_pixelHeight };
+    for (int s = 0; s < 2; ++s) {
+        for (int i = 3; i >= 0; --i) header.push_back(char((size[s] >> (8 * i)) & 0xFF));
+    }
+    // 8 bits per channel, RGB, deflate, adaptive filtering and no interlace
+    const char settings[5] = { 8, 2, 0, 0, 0 };
+    header.append(settings, 5);
+    AppendPNGChunk(png, "IHDR", header);
+    AppendPNGChunk(png, "IDAT", ZlibCompress(filtered));
+    AppendPNGChunk(png, "IEND", "");
+
+    return png;
+}
+
+} // namespace vrv
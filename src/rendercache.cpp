@@ -0,0 +1,248 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        rendercache.cpp
+// Author:      agent
+// Created:     18/10/2026
+// Copyright (c) Authors and others. All rights reserved.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "rendercache.h"
+
+//----------------------------------------------------------------------------
+
+#include <assert.h>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+//----------------------------------------------------------------------------
+
+#include "vrv.h"
+
+namespace vrv {
+
+// Signature at the beginning of the cache files
+const char *RENDER_CACHE_SIGNATURE = "VRVCACHE";
+
+//----------------------------------------------------------------------------
+// RenderCache
+//----------------------------------------------------------------------------
+
+RenderCache::RenderCache(const std::string &directory, int maxSize, bool verify)
+{
+    m_directory = directory;
+    m_maxSize = (maxSize > 0) ? maxSize : 0;
+    m_verify = verify;
+
+    m_size = 0;
+
+    m_hits = 0;
+    m_misses = 0;
+    m_evictions = 0;
+    m_invalids = 0;
+    m_collisions = 0;
+}
+
+RenderCache::~RenderCache() {}
+
+bool RenderCache::Get(const std::string &key, const std::string &source, std::string &content)
+{
+    std::map<std::string, Entry>::iterator iter = m_entries.find(key);
+    std::string entrySource;
+    std::string checksum;
+
+    if (m_directory.empty()) {
+        if (iter == m_entries.end()) {
+            ++m_misses;
+            return false;
+        }
+        entrySource = iter->second.m_source;
+        content = iter->second.m_content;
+        checksum = iter->second.m_checksum;
+    }
+    else {
+        // The file can have been written by another instance or removed in the meantime
+        if (!this->ReadFile(key, entrySource, content, checksum)) {
+            if (iter != m_entries.end()) this->Remove(key);
+            ++m_misses;
+            return false;
+        }
+        if (iter == m_entries.end()) {
+            m_lru.push_front(key);
+            Entry entry;
+            entry.m_source = entrySource;
+            entry.m_checksum = checksum;
+            entry.m_size = (int)content.size();
+            entry.m_lru = m_lru.begin();
+            m_entries[key] = entry;
+            m_size += entry.m_size;
+        }
+    }
+
+    // Another input with the same key - the entry is kept until it is replaced
+    if (entrySource != source) {
+        content.clear();
+        ++m_collisions;
+        ++m_misses;
+        return false;
+    }
+
+    if (m_verify && (RenderCache::Hash(content) != checksum)) {
+        LogWarning("The render cache entry '%s' is invalid and was removed", key.c_str());
+        this->Remove(key);
+        content.clear();
+        ++m_invalids;
+        ++m_misses;
+        return false;
+    }
+
+    this->Touch(key);
+    this->Evict();
+    ++m_hits;
+    return true;
+}
+
+void RenderCache::Put(const std::string &key, const std::string &source, const std::string &content)
+{
+    int size = (int)content.size();
+    if ((m_maxSize > 0) && (size > m_maxSize)) return;
+
+    if (m_entries.count(key)) this->Remove(key);
+
+    std::string checksum = RenderCache::Hash(content);
+    if (!m_directory.empty() && !this->WriteFile(key, source, content, checksum)) {
+        return;
+    }
+
+    m_lru.push_front(key);
+    Entry entry;
+    // With a directory, the content is only in the file
+    if (m_directory.empty()) entry.m_content = content;
+    entry.m_source = source;
+    entry.m_checksum = checksum;
+    entry.m_size = size;
+    entry.m_lru = m_lru.begin();
+    m_entries[key] = entry;
+    m_size += size;
+
+    this->Evict();
+}
+
+void RenderCache::Clear()
+{
+    while (!m_lru.empty()) {
+        this->Remove(m_lru.back());
+    }
+    assert(m_entries.empty());
+    assert(m_size == 0);
+
+    m_hits = 0;
+    m_misses = 0;
+    m_evictions = 0;
+    m_invalids = 0;
+    m_collisions = 0;
+}
+
+std::string RenderCache::Hash(const std::string &data)
+{
+    unsigned long long hash = 14695981039346656037ULL;
+    std::string::const_iterator iter;
+    for (iter = data.begin(); iter != data.end(); ++iter) {
+        hash ^= (unsigned char)(*iter);
+        hash *= 1099511628211ULL;
+    }
+    return StringFormat("%016llx", hash);
+}
+
+void RenderCache::Touch(const std::string &key)
+{
+    std::map<std::string, Entry>::iterator iter = m_entries.find(key);
+    assert(iter != m_entries.end());
+
+    m_lru.splice(m_lru.begin(), m_lru, iter->second.m_lru);
+}
+
+void RenderCache::Remove(const std::string &key)
+{
+    std::map<std::string, Entry>::iterator iter = m_entries.find(key);
+    if (iter == m_entries.end()) return;
+
+    m_size -= iter->second.m_size;
+    m_lru.erase(iter->second.m_lru);
+    m_entries.erase(iter);
+
+    if (!m_directory.empty()) {
+        std::remove(this->GetFilename(key).c_str());
+    }
+}
+
+void RenderCache::Evict()
+{
+    if (m_maxSize == 0) return;
+
+    while ((m_size > m_maxSize) && !m_lru.empty()) {
+        this->Remove(m_lru.back());
+        ++m_evictions;
+    }
+}
+
+std::string RenderCache::GetFilename(const std::string &key) const
+{
+    return m_directory + "/" + key + ".vrvcache";
+}
+
+bool RenderCache::ReadFile(const std::string &key, std::string &source, std::string &content, std::string &checksum)
+{
+    std::ifstream file(this->GetFilename(key).c_str(), std::ios::in | std::ios::binary);
+    if (!file.is_open()) return false;
+
+    // The header line is "VRVCACHE key checksum sourceSize size" and is followed by the source and the content
+    std::string header;
+    if (!std::getline(file, header)) return false;
+
+    std::istringstream iss(header);
+    std::string signature;
+    std::string fileKey;
+    int sourceSize = -1;
+    int size = -1;
+    iss >> signature >> fileKey >> checksum >> sourceSize >> size;
+    if ((signature != RENDER_CACHE_SIGNATURE) || (fileKey != key) || (sourceSize < 0) || (size < 0)) {
+        return false;
+    }
+
+    source.resize(sourceSize);
+    if (sourceSize > 0) {
+        file.read(&source[0], sourceSize);
+        if (file.gcount() != sourceSize) return false;
+    }
+
+    content.resize(size);
+    if (size > 0) {
+        file.read(&content[0], size);
+        if (file.gcount() != size) {
+            content.clear();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool RenderCache::WriteFile(
+    const std::string &key, const std::string &source, const std::string &content, const std::string &checksum)
+{
+    std::string filename = this->GetFilename(key);
+    std::ofstream file(filename.c_str(), std::ios::out | std::ios::binary);
+    if (!file.is_open()) {
+        LogWarning("The render cache file '%s' could not be written", filename.c_str());
+        return false;
+    }
+
+    file << RENDER_CACHE_SIGNATURE << " " << key << " " << checksum << " " << source.size() << " " << content.size()
+         << "\n";
+    file.write(source.data(), source.size());
+    file.write(content.data(), content.size());
+
+    return true;
+}
+
+} // namespace vrv
@@ -29,6 +29,30 @@ namespace vrv {
 #define space " "
 #define semicolon ";"
 
+//----------------------------------------------------------------------------
+// SvgDeviceContext::SvgNode
+//----------------------------------------------------------------------------
+
+SvgDeviceContext::SvgNode::SvgNode(const std::string &name, SvgNode *parent, SvgPosition position, bool streamed)
+{
+    m_name = name;
+    m_parent = parent;
+    m_depth = (parent) ? parent->m_depth + 1 : 0;
+    m_position = position;
+    m_firstGroup = -1;
+    m_streamed = streamed;
+    m_bodyStart = 0;
+    m_bodyFirstGroup = std::string::npos;
+}
+
+SvgDeviceContext::SvgNode::~SvgNode()
+{
+    std::vector<Child>::iterator iter;
+    for (iter = m_children.begin(); iter != m_children.end(); ++iter) {
+        if (iter->m_node) delete iter->m_node;
+    }
+}
+
 //----------------------------------------------------------------------------
 // SvgDeviceContext
 //----------------------------------------------------------------------------
@@ -49,15 +73,16 @@ SvgDeviceContext::SvgDeviceContext() : DeviceContext()
     m_mmOutput = false;
     m_svgBoundingBoxes = false;
     m_svgViewBox = false;
+    m_svgCompact = false;
+    m_svgRemoveEmptyGroups = false;
+    m_svgRemoveXlink = false;
+    m_svgRemoveLabels = false;
     m_facsimile = false;
 
     // create the initial SVG element
-    // width and height need to be set later; these are taken care of in "commit"
-    m_svgNode = m_svgDoc.append_child("svg");
-    m_svgNode.append_attribute("version") = "1.1";
-    m_svgNode.append_attribute("xmlns") = "http://www.w3.org/2000/svg";
-    m_svgNode.append_attribute("xmlns:xlink") = "http://www.w3.org/1999/xlink";
-    m_svgNode.append_attribute("overflow") = "visible";
+    // its start tag (with width and height) is written in "commit"
+    m_svgNode = new SvgNode("svg", NULL, SVG_APPEND, true);
+    m_pageNode = NULL;
 
     // start the stack
     m_svgNodeStack.push_back(m_svgNode);
@@ -66,7 +91,17 @@ SvgDeviceContext::SvgDeviceContext() : DeviceContext()
     m_outdata.clear();
 }
 
-SvgDeviceContext::~SvgDeviceContext() {}
+SvgDeviceContext::~SvgDeviceContext()
+{
+    // The elements still open and not owned by their parent (i.e., with a streamed parent) need to be deleted
+    std::vector<SvgNode *>::iterator iter;
+    for (iter = m_svgNodeStack.begin(); iter != m_svgNodeStack.end(); ++iter) {
+        if ((*iter)->m_parent && !(*iter)->m_parent->m_streamed) continue;
+        // A node can be twice in the stack when resumed
+        if (std::find(m_svgNodeStack.begin(), iter, *iter) != iter) continue;
+        delete *iter;
+    }
+}
 
 bool SvgDeviceContext::CopyFileToStream(const std::string &filename, std::ostream &dest)
 {
@@ -83,6 +118,11 @@ void SvgDeviceContext::Commit(bool xml_declaration)
         return;
     }
 
+    // close the elements that are still open
+    while (m_svgNodeStack.size() > 1) {
+        this->EndNode();
+    }
+
     // take care of width/height once userScale is updated
     double height = (double)GetHeight() * GetUserScaleY();
     double width = (double)GetWidth() * GetUserScaleX();
@@ -94,26 +134,37 @@ void SvgDeviceContext::Commit(bool xml_declaration)
         format = "%gmm";
     }
 
+    // the start of the file, which is inserted before the content written so far
+    std::string header;
+
+    if (xml_declaration) {
+        header.append("<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"no\"?>\n");
+    }
+
+    header.append("<svg");
     if (m_svgViewBox) {
-        m_svgNode.prepend_attribute("viewBox") = StringFormat("0 0 %g %g", width, height).c_str();
+        AppendAttribute(header, "viewBox", StringFormat("0 0 %g %g", width, height));
     }
     else {
-        m_svgNode.prepend_attribute("height") = StringFormat(format, height).c_str();
-        m_svgNode.prepend_attribute("width") = StringFormat(format, width).c_str();
+        AppendAttribute(header, "width", StringFormat(format, width));
+        AppendAttribute(header, "height", StringFormat(format, height));
     }
+    AppendAttribute(header, "version", "1.1");
+    AppendAttribute(header, "xmlns", "http://www.w3.org/2000/svg");
+    AppendAttribute(header, "xmlns:xlink", "http://www.w3.org/1999/xlink");
+    AppendAttribute(header, "overflow", "visible");
+    header.append(">");
 
-    // add the woff VerovioText font if needed
-    if (m_vrvTextFont) {
-        std::string woff = Resources::GetPath() + "/woff.xml";
-        pugi::xml_document woffDoc;
-        woffDoc.load_file(woff.c_str());
-        m_svgNode.prepend_copy(woffDoc.first_child());
-    }
+    // add description statement
+    AppendIndent(header, 1);
+    header.append("<desc>");
+    AppendEscaped(header, StringFormat("Engraved by Verovio %s", GetVersion().c_str()).c_str(), false);
+    header.append("</desc>");
 
-    // header
-    if (m_smuflGlyphs.size() > 0) {
+    // header (the glyphs are defined in the external sprite when there is one)
+    if ((m_smuflGlyphs.size() > 0) && m_glyphSprite.empty()) {
 
-        pugi::xml_node defs = m_svgNode.prepend_child("defs");
+        std::string defs;
         pugi::xml_document sourceDoc;
 
         // for each needed glyph
@@ -123,34 +174,426 @@ void SvgDeviceContext::Commit(bool xml_declaration)
             std::ifstream source((*it).c_str());
             sourceDoc.load(source);
 
-            // copy all the nodes inside into the master document
+            // copy all the nodes inside into the <defs>
             for (pugi::xml_node child = sourceDoc.first_child(); child; child = child.next_sibling()) {
-                defs.append_copy(child);
+                AppendPugiNode(defs, child, 2);
             }
         }
-    }
 
-    unsigned int output_flags = pugi::format_default | pugi::format_no_declaration;
-    if (xml_declaration) {
-        // edit the xml declaration
-        output_flags = pugi::format_default;
-        pugi::xml_node decl = m_svgDoc.prepend_child(pugi::node_declaration);
-        decl.append_attribute("version") = "1.0";
-        decl.append_attribute("encoding") = "UTF-8";
-        decl.append_attribute("standalone") = "no";
+        AppendIndent(header, 1);
+        if (defs.empty()) {
+            header.append("<defs />");
+        }
+        else {
+            header.append("<defs>");
+            header.append(defs);
+            AppendIndent(header, 1);
+            header.append("</defs>");
+        }
     }
 
-    // add description statement
-    pugi::xml_node desc = m_svgNode.prepend_child("desc");
-    desc.append_child(pugi::node_pcdata)
-        .set_value(StringFormat("Engraved by Verovio %s", GetVersion().c_str()).c_str());
+    // add the woff VerovioText font if needed
+    if (m_vrvTextFont) {
+        std::string woff = Resources::GetPath() + "/woff.xml";
+        pugi::xml_document woffDoc;
+        woffDoc.load_file(woff.c_str());
+        if (woffDoc.first_child()) AppendPugiNode(header, woffDoc.first_child(), 1);
+    }
 
-    // save the glyph data to m_outdata
-    m_svgDoc.save(m_outdata, "\t", output_flags);
+    // the content is moved to the output without copying it
+    m_outdata.swap(m_svgBody);
+    m_svgBody.clear();
+    m_outdata.insert(0, header);
+    AppendIndent(m_outdata, 0);
+    m_outdata.append("</svg>\n");
 
     m_committed = true;
 }
 
+SvgDeviceContext::SvgNode *SvgDeviceContext::StartNode(const std::string &name, SvgPosition position)
+{
+    SvgNode *node = new SvgNode(name, m_currentNode, position, false);
+    this->AddNode(node, position);
+
+    m_currentNode = node;
+    m_svgNodeStack.push_back(node);
+    return node;
+}
+
+void SvgDeviceContext::StartStreamedNode(const std::string &name, const std::string &attributes)
+{
+    // A streamed element can only be added to a streamed element
+    if (!m_currentNode->m_streamed) {
+        SvgNode *node = this->StartNode(name);
+        node->m_attributes = attributes;
+        return;
+    }
+
+    SvgNode *node = new SvgNode(name, m_currentNode, SVG_APPEND, true);
+
+    std::string xml;
+    AppendIndent(xml, node->m_depth);
+    xml.append("<" + name + attributes + ">");
+    this->WriteToBody(m_currentNode, xml, SVG_APPEND, (name == "g"));
+    node->m_bodyStart = m_svgBody.size();
+
+    m_currentNode = node;
+    m_svgNodeStack.push_back(node);
+}
+
+void SvgDeviceContext::EndNode()
+{
+    assert(m_svgNodeStack.size() > 1);
+
+    SvgNode *node = m_svgNodeStack.back();
+    m_svgNodeStack.pop_back();
+    m_currentNode = m_svgNodeStack.back();
+
+    // The node is still open because it was resumed
+    if (std::find(m_svgNodeStack.begin(), m_svgNodeStack.end(), node) != m_svgNodeStack.end()) return;
+
+    if (node->m_streamed) {
+        assert(m_svgBody.size() >= node->m_bodyStart);
+        // Nothing was written after the start tag
+        if (m_svgBody.size() == node->m_bodyStart) {
+            m_svgBody.resize(m_svgBody.size() - 1);
+            m_svgBody.append(" />");
+        }
+        else {
+            AppendIndent(m_svgBody, node->m_depth);
+            m_svgBody.append("</" + node->m_name + ">");
+        }
+        delete node;
+    }
+    // The parent is streamed and the node cannot be changed anymore - it can be written
+    else if (node->m_parent->m_streamed) {
+        if (this->IsRemoved(node)) {
+            this->RemoveGroups(node);
+            delete node;
+            return;
+        }
+        SvgNode *parent = node->m_parent;
+        bool isGroup = (node->m_name == "g");
+        bool atEnd = (node->m_position == SVG_APPEND)
+            || ((node->m_position == SVG_BEFORE_GROUP) && (parent->m_bodyFirstGroup == std::string::npos));
+        if (atEnd) {
+            if (isGroup && (parent->m_bodyFirstGroup == std::string::npos)) {
+                parent->m_bodyFirstGroup = m_svgBody.size();
+            }
+            this->WriteNode(m_svgBody, node);
+        }
+        else {
+            std::string xml;
+            this->WriteNode(xml, node);
+            this->WriteToBody(parent, xml, node->m_position, isGroup);
+        }
+        this->RemoveGroups(node);
+        delete node;
+    }
+}
+
+void SvgDeviceContext::AppendChild(const std::string &xml, SvgPosition position, bool isGroup)
+{
+    std::string child;
+    child.reserve(xml.size() + m_currentNode->m_depth + 2);
+    AppendIndent(child, m_currentNode->m_depth + 1);
+    child.append(xml);
+    this->AddSerialized(child, position, isGroup);
+}
+
+void SvgDeviceContext::AddSerialized(const std::string &xml, SvgPosition position, bool isGroup)
+{
+    if (m_currentNode->m_streamed) {
+        this->WriteToBody(m_currentNode, xml, position, isGroup);
+        return;
+    }
+
+    std::vector<SvgNode::Child> &children = m_currentNode->m_children;
+    int index = this->GetChildIndex(position);
+
+    // Consecutive serialized elements are kept in a single string
+    if (!isGroup) {
+        if ((index > 0) && !children.at(index - 1).m_node && !children.at(index - 1).m_isGroup) {
+            children.at(index - 1).m_xml.append(xml);
+            return;
+        }
+        if ((index < (int)children.size()) && !children.at(index).m_node && !children.at(index).m_isGroup) {
+            children.at(index).m_xml.insert(0, xml);
+            return;
+        }
+    }
+
+    SvgNode::Child child;
+    child.m_xml = xml;
+    child.m_node = NULL;
+    child.m_isGroup = isGroup;
+    this->InsertChild(child, index);
+}
+
+void SvgDeviceContext::AddNode(SvgNode *node, SvgPosition position)
+{
+    // The children of a streamed element are written only once closed (see EndNode)
+    if (m_currentNode->m_streamed) return;
+
+    SvgNode::Child child;
+    child.m_node = node;
+    child.m_isGroup = (node->m_name == "g");
+    this->InsertChild(child, this->GetChildIndex(position));
+}
+
+int SvgDeviceContext::GetChildIndex(SvgPosition position)
+{
+    if (position == SVG_PREPEND) {
+        return 0;
+    }
+    else if ((position == SVG_BEFORE_GROUP) && (m_currentNode->m_firstGroup != -1)) {
+        return m_currentNode->m_firstGroup;
+    }
+    return (int)m_currentNode->m_children.size();
+}
+
+void SvgDeviceContext::InsertChild(SvgNode::Child &child, int index)
+{
+    std::vector<SvgNode::Child> &children = m_currentNode->m_children;
+    children.insert(children.begin() + index, child);
+    if (child.m_isGroup) {
+        if ((m_currentNode->m_firstGroup == -1) || (index <= m_currentNode->m_firstGroup)) {
+            m_currentNode->m_firstGroup = index;
+        }
+    }
+    else if ((m_currentNode->m_firstGroup != -1) && (index <= m_currentNode->m_firstGroup)) {
+        m_currentNode->m_firstGroup++;
+    }
+}
+
+std::string &SvgDeviceContext::StartLeaf(const char *name)
+{
+    m_leaf.clear();
+    AppendIndent(m_leaf, m_currentNode->m_depth + 1);
+    m_leaf.push_back('<');
+    m_leaf.append(name);
+    return m_leaf;
+}
+
+void SvgDeviceContext::EndLeaf(bool closeTag)
+{
+    if (closeTag) m_leaf.append(" />");
+    this->AddSerialized(m_leaf, SVG_BEFORE_GROUP);
+}
+
+void SvgDeviceContext::WriteToBody(SvgNode *parent, const std::string &xml, SvgPosition position, bool isGroup)
+{
+    assert(parent->m_streamed);
+
+    size_t pos = m_svgBody.size();
+    if (position == SVG_PREPEND) {
+        pos = parent->m_bodyStart;
+    }
+    else if ((position == SVG_BEFORE_GROUP) && (parent->m_bodyFirstGroup != std::string::npos)) {
+        pos = parent->m_bodyFirstGroup;
+    }
+
+    if (pos == m_svgBody.size()) {
+        m_svgBody.append(xml);
+    }
+    else {
+        m_svgBody.insert(pos, xml);
+    }
+
+    if (isGroup) {
+        if ((parent->m_bodyFirstGroup == std::string::npos) || (pos <= parent->m_bodyFirstGroup)) {
+            parent->m_bodyFirstGroup = pos;
+        }
+    }
+    else if ((parent->m_bodyFirstGroup != std::string::npos) && (pos <= parent->m_bodyFirstGroup)) {
+        parent->m_bodyFirstGroup += xml.size();
+    }
+}
+
+void SvgDeviceContext::WriteNode(std::string &output, SvgNode *node)
+{
+    if (this->IsRemoved(node)) return;
+
+    AppendIndent(output, node->m_depth);
+    output.append("<" + node->m_name);
+    output.append(node->m_attributes);
+    output.append(">");
+    size_t contentStart = output.size();
+
+    std::vector<SvgNode::Child>::iterator iter;
+    for (iter = node->m_children.begin(); iter != node->m_children.end(); ++iter) {
+        if (iter->m_node) {
+            this->WriteNode(output, iter->m_node);
+        }
+        else {
+            output.append(iter->m_xml);
+        }
+    }
+
+    // Nothing was written after the start tag
+    if (output.size() == contentStart) {
+        output.resize(output.size() - 1);
+        output.append(" />");
+        return;
+    }
+
+    AppendIndent(output, node->m_depth);
+    output.append("</" + node->m_name + ">");
+}
+
+bool SvgDeviceContext::IsRemoved(SvgNode *node) const
+{
+    if (!m_svgRemoveEmptyGroups || (node->m_name != "g")) return false;
+
+    std::vector<SvgNode::Child>::iterator iter;
+    for (iter = node->m_children.begin(); iter != node->m_children.end(); ++iter) {
+        if (!iter->m_node || !this->IsRemoved(iter->m_node)) return false;
+    }
+    return true;
+}
+
+void SvgDeviceContext::RemoveGroups(SvgNode *node)
+{
+    if (!node->m_id.empty()) {
+        std::unordered_map<std::string, SvgNode *>::iterator group = m_groupNodes.find(node->m_id);
+        if ((group != m_groupNodes.end()) && (group->second == node)) m_groupNodes.erase(group);
+    }
+
+    std::vector<SvgNode::Child>::iterator iter;
+    for (iter = node->m_children.begin(); iter != node->m_children.end(); ++iter) {
+        if (iter->m_node) this->RemoveGroups(iter->m_node);
+    }
+}
+
+void SvgDeviceContext::AppendAttribute(std::string &xml, const char *name, const std::string &value)
+{
+    AppendAttribute(xml, name, value.c_str());
+}
+
+void SvgDeviceContext::AppendAttribute(std::string &xml, const char *name, const char *value)
+{
+    StartAttribute(xml, name);
+    AppendEscaped(xml, value, true);
+    xml.push_back('"');
+}
+
+void SvgDeviceContext::AppendAttribute(std::string &xml, const char *name, int value)
+{
+    StartAttribute(xml, name);
+    AppendInt(xml, value);
+    xml.push_back('"');
+}
+
+void SvgDeviceContext::AppendAttribute(std::string &xml, const char *name, float value)
+{
+    StartAttribute(xml, name);
+    AppendFormatted(xml, "%.9g", double(value));
+    xml.push_back('"');
+}
+
+void SvgDeviceContext::AppendAttribute(std::string &xml, const char *name, double value)
+{
+    StartAttribute(xml, name);
+    AppendFormatted(xml, "%.17g", value);
+    xml.push_back('"');
+}
+
+void SvgDeviceContext::StartAttribute(std::string &xml, const char *name)
+{
+    xml.push_back(' ');
+    xml.append(name);
+    xml.append("=\"");
+}
+
+void SvgDeviceContext::AppendEscaped(std::string &xml, const char *value, bool attribute)
+{
+    for (const char *c = value; *c; ++c) {
+        unsigned char ch = (unsigned char)*c;
+        switch (ch) {
+            case '&': xml.append("&amp;"); break;
+            case '<': xml.append("&lt;"); break;
+            case '>':
+                if (attribute)
+                    xml.push_back('>');
+                else
+                    xml.append("&gt;");
+                break;
+            case '"':
+                if (attribute)
+                    xml.append("&quot;");
+                else
+                    xml.push_back('"');
+                break;
+            default:
+                // Control characters are written as character references (but tabs and newlines in text)
+                if ((ch < 32) && (attribute || ((ch != '\t') && (ch != '\n') && (ch != '\r')))) {
+                    xml.append("&#");
+                    xml.push_back(char('0' + ch / 10));
+                    xml.push_back(char('0' + ch % 10));
+                    xml.push_back(';');
+                }
+                else {
+                    xml.push_back(*c);
+                }
+        }
+    }
+}
+
+void SvgDeviceContext::AppendIndent(std::string &xml, int depth)
+{
+    if (m_svgCompact) return;
+
+    xml.push_back('\n');
+    xml.append(depth, '\t');
+}
+
+void SvgDeviceContext::AppendInt(std::string &xml, int value)
+{
+    char buffer[12];
+    char *end = buffer + sizeof(buffer);
+    char *digit = end;
+    unsigned int absValue = (value < 0) ? 0u - (unsigned int)value : (unsigned int)value;
+    do {
+        *(--digit) = char('0' + absValue % 10);
+        absValue /= 10;
+    } while (absValue);
+    if (value < 0) *(--digit) = '-';
+    xml.append(digit, end - digit);
+}
+
+void SvgDeviceContext::AppendPoint(std::string &xml, int x, int y, char separator)
+{
+    AppendInt(xml, x);
+    xml.push_back(separator);
+    AppendInt(xml, y);
+}
+
+void SvgDeviceContext::AppendFormatted(std::string &xml, const char *format, double value)
+{
+    char buffer[64];
+    int length = snprintf(buffer, sizeof(buffer), format, value);
+    if ((length < 0) || (length >= (int)sizeof(buffer))) {
+        xml.append(StringFormat(format, value));
+        return;
+    }
+    xml.append(buffer, length);
+}
+
+void SvgDeviceContext::AppendPugiNode(std::string &xml, pugi::xml_node node, int depth)
+{
+    std::ostringstream stream;
+    if (m_svgCompact) {
+        node.print(stream, "", pugi::format_raw);
+        xml.append(stream.str());
+        return;
+    }
+    node.print(stream, "\t", pugi::format_default, pugi::encoding_auto, depth);
+    std::string nodeXml = stream.str();
+    if (!nodeXml.empty() && (nodeXml.at(nodeXml.size() - 1) == '\n')) nodeXml.resize(nodeXml.size() - 1);
+    xml.push_back('\n');
+    xml.append(nodeXml);
+}
+
 void SvgDeviceContext::StartGraphic(Object *object, std::string gClass, std::string gId, bool prepend)
 {
     std::string baseClass = object->GetClassName();
@@ -167,16 +610,13 @@ void SvgDeviceContext::StartGraphic(Object *object, std::string gClass, std::str
         }
     }
 
-    if (prepend) {
-        m_currentNode = m_currentNode.prepend_child("g");
-    }
-    else {
-        m_currentNode = m_currentNode.append_child("g");
-    }
-    m_svgNodeStack.push_back(m_currentNode);
-    m_currentNode.append_attribute("class") = baseClass.c_str();
+    SvgNode *node = this->StartNode("g", (prepend) ? SVG_PREPEND : SVG_APPEND);
+    AppendAttribute(node->m_attributes, "class", baseClass);
     if (gId.length() > 0) {
-        m_currentNode.append_attribute("id") = gId.c_str();
+        AppendAttribute(node->m_attributes, "id", gId);
+        // keep the first one when the id is not unique
+        node->m_id = gId;
+        m_groupNodes.insert(std::make_pair(gId, node));
     }
 
     // this sets staffDef styles for lyrics
@@ -201,24 +641,27 @@ void SvgDeviceContext::StartGraphic(Object *object, std::string gClass, std::str
             styleStr.append(
                 "font-weight:" + staff->AttTyped::FontweightToStr(staff->m_drawingStaffDef->GetLyricWeight()) + ";");
         }
-        if (!styleStr.empty()) m_currentNode.append_attribute("style") = styleStr.c_str();
+        if (!styleStr.empty()) AppendAttribute(node->m_attributes, "style", styleStr);
     }
 
     if (object->HasAttClass(ATT_COLOR)) {
         AttColor *att = dynamic_cast<AttColor *>(object);
         assert(att);
         if (att->HasColor()) {
-            m_currentNode.append_attribute("fill") = att->GetColor().c_str();
+            AppendAttribute(node->m_attributes, "fill", att->GetColor());
         }
     }
 
-    if (object->HasAttClass(ATT_LABELLED)) {
+    if (!m_svgRemoveLabels && object->HasAttClass(ATT_LABELLED)) {
         AttLabelled *att = dynamic_cast<AttLabelled *>(object);
         assert(att);
         if (att->HasLabel()) {
-            pugi::xml_node svgTitle = m_currentNode.prepend_child("title");
-            svgTitle.append_attribute("class") = "labelAttr";
-            svgTitle.append_child(pugi::node_pcdata).set_value(att->GetLabel().c_str());
+            std::string svgTitle = "<title";
+            AppendAttribute(svgTitle, "class", "labelAttr");
+            svgTitle.append(">");
+            AppendEscaped(svgTitle, att->GetLabel().c_str(), false);
+            svgTitle.append("</title>");
+            this->AppendChild(svgTitle, SVG_PREPEND);
         }
     }
 
@@ -226,20 +669,20 @@ void SvgDeviceContext::StartGraphic(Object *object, std::string gClass, std::str
         AttLang *att = dynamic_cast<AttLang *>(object);
         assert(att);
         if (att->HasLang()) {
-            m_currentNode.append_attribute("xml:lang") = att->GetLang().c_str();
+            AppendAttribute(node->m_attributes, "xml:lang", att->GetLang());
         }
     }
 
     if (object->HasAttClass(ATT_TYPOGRAPHY)) {
         AttTypography *att = dynamic_cast<AttTypography *>(object);
         assert(att);
-        if (att->HasFontname()) m_currentNode.append_attribute("font-family") = att->GetFontname().c_str();
+        if (att->HasFontname()) AppendAttribute(node->m_attributes, "font-family", att->GetFontname());
         if (att->HasFontstyle())
-            m_currentNode.append_attribute("font-style")
-                = att->AttConverter::FontstyleToStr(att->GetFontstyle()).c_str();
+            AppendAttribute(
+                node->m_attributes, "font-style", att->AttConverter::FontstyleToStr(att->GetFontstyle()));
         if (att->HasFontweight())
-            m_currentNode.append_attribute("font-weight")
-                = att->AttConverter::FontweightToStr(att->GetFontweight()).c_str();
+            AppendAttribute(
+                node->m_attributes, "font-weight", att->AttConverter::FontweightToStr(att->GetFontweight()));
     }
 
     if (object->HasAttClass(ATT_VISIBILITY)) {
@@ -247,10 +690,10 @@ void SvgDeviceContext::StartGraphic(Object *object, std::string gClass, std::str
         assert(att);
         if (att->HasVisible()) {
             if (att->GetVisible() == BOOLEAN_true) {
-                m_currentNode.append_attribute("visibility") = "visible";
+                AppendAttribute(node->m_attributes, "visibility", "visible");
             }
             else if (att->GetVisible() == BOOLEAN_false) {
-                m_currentNode.append_attribute("visibility") = "hidden";
+                AppendAttribute(node->m_attributes, "visibility", "hidden");
             }
         }
     }
@@ -267,11 +710,12 @@ void SvgDeviceContext::StartCustomGraphic(std::string name, std::string gClass,
         name.append(" " + gClass);
     }
 
-    m_currentNode = m_currentNode.append_child("g");
-    m_svgNodeStack.push_back(m_currentNode);
-    m_currentNode.append_attribute("class") = name.c_str();
+    SvgNode *node = this->StartNode("g");
+    AppendAttribute(node->m_attributes, "class", name);
     if (gId.length() > 0) {
-        m_currentNode.append_attribute("id") = gId.c_str();
+        AppendAttribute(node->m_attributes, "id", gId);
+        node->m_id = gId;
+        m_groupNodes.insert(std::make_pair(gId, node));
     }
 }
 
@@ -283,24 +727,26 @@ void SvgDeviceContext::StartTextGraphic(Object *object, std::string gClass, std:
         baseClass.append(" " + gClass);
     }
 
-    m_currentNode = AppendChild("tspan");
-    m_svgNodeStack.push_back(m_currentNode);
-    m_currentNode.append_attribute("class") = baseClass.c_str();
-    m_currentNode.append_attribute("id") = gId.c_str();
+    SvgNode *node = this->StartNode("tspan", SVG_BEFORE_GROUP);
+    AppendAttribute(node->m_attributes, "class", baseClass);
+    AppendAttribute(node->m_attributes, "id", gId);
 
     if (object->HasAttClass(ATT_COLOR)) {
         AttColor *att = dynamic_cast<AttColor *>(object);
         assert(att);
-        if (att->HasColor()) m_currentNode.append_attribute("fill") = att->GetColor().c_str();
+        if (att->HasColor()) AppendAttribute(node->m_attributes, "fill", att->GetColor());
     }
 
-    if (object->HasAttClass(ATT_LABELLED)) {
+    if (!m_svgRemoveLabels && object->HasAttClass(ATT_LABELLED)) {
         AttLabelled *att = dynamic_cast<AttLabelled *>(object);
         assert(att);
         if (att->HasLabel()) {
-            pugi::xml_node svgTitle = m_currentNode.prepend_child("title");
-            svgTitle.append_attribute("class") = "labelAttr";
-            svgTitle.append_child(pugi::node_pcdata).set_value(att->GetLabel().c_str());
+            std::string svgTitle = "<title";
+            AppendAttribute(svgTitle, "class", "labelAttr");
+            svgTitle.append(">");
+            AppendEscaped(svgTitle, att->GetLabel().c_str(), false);
+            svgTitle.append("</title>");
+            this->AppendChild(svgTitle, SVG_PREPEND);
         }
     }
 
@@ -308,38 +754,37 @@ void SvgDeviceContext::StartTextGraphic(Object *object, std::string gClass, std:
         AttLang *att = dynamic_cast<AttLang *>(object);
         assert(att);
         if (att->HasLang()) {
-            m_currentNode.append_attribute("xml:lang") = att->GetLang().c_str();
+            AppendAttribute(node->m_attributes, "xml:lang", att->GetLang());
         }
     }
 
     if (object->HasAttClass(ATT_TYPOGRAPHY)) {
         AttTypography *att = dynamic_cast<AttTypography *>(object);
         assert(att);
-        if (att->HasFontname()) m_currentNode.append_attribute("font-family") = att->GetFontname().c_str();
+        if (att->HasFontname()) AppendAttribute(node->m_attributes, "font-family", att->GetFontname());
         if (att->HasFontstyle())
-            m_currentNode.append_attribute("font-style")
-                = att->AttConverter::FontstyleToStr(att->GetFontstyle()).c_str();
+            AppendAttribute(
+                node->m_attributes, "font-style", att->AttConverter::FontstyleToStr(att->GetFontstyle()));
         if (att->HasFontweight())
-            m_currentNode.append_attribute("font-weight")
-                = att->AttConverter::FontweightToStr(att->GetFontweight()).c_str();
+            AppendAttribute(
+                node->m_attributes, "font-weight", att->AttConverter::FontweightToStr(att->GetFontweight()));
     }
 
     if (object->HasAttClass(ATT_WHITESPACE)) {
         AttWhitespace *att = dynamic_cast<AttWhitespace *>(object);
         assert(att);
         if (att->HasSpace()) {
-            m_currentNode.append_attribute("xml:space") = att->GetSpace().c_str();
-            ;
+            AppendAttribute(node->m_attributes, "xml:space", att->GetSpace());
         }
     }
 }
 
 void SvgDeviceContext::ResumeGraphic(Object *object, std::string gId)
 {
-    std::string xpath = "//g[@id=\"" + gId + "\"]";
-    pugi::xpath_node selection = m_currentNode.select_node(xpath.c_str());
-    if (selection) {
-        m_currentNode = selection.node();
+    // Only the elements that are not written yet can be resumed
+    std::unordered_map<std::string, SvgNode *>::iterator group = m_groupNodes.find(gId);
+    if (group != m_groupNodes.end()) {
+        m_currentNode = group->second;
     }
     m_svgNodeStack.push_back(m_currentNode);
 }
@@ -347,18 +792,17 @@ void SvgDeviceContext::ResumeGraphic(Object *object, std::string gId)
 void SvgDeviceContext::EndGraphic(Object *object, View *view)
 {
     DrawSvgBoundingBox(object, view);
-    m_svgNodeStack.pop_back();
-    m_currentNode = m_svgNodeStack.back();
+    this->EndNode();
 }
 
 void SvgDeviceContext::EndCustomGraphic()
 {
-    m_svgNodeStack.pop_back();
-    m_currentNode = m_svgNodeStack.back();
+    this->EndNode();
 }
 
 void SvgDeviceContext::EndResumedGraphic(Object *object, View *view)
 {
+    // The resumed element is still open in its parent
     m_svgNodeStack.pop_back();
     m_currentNode = m_svgNodeStack.back();
 }
@@ -366,17 +810,20 @@ void SvgDeviceContext::EndResumedGraphic(Object *object, View *view)
 void SvgDeviceContext::EndTextGraphic(Object *object, View *view)
 {
     DrawSvgBoundingBox(object, view);
-    m_svgNodeStack.pop_back();
-    m_currentNode = m_svgNodeStack.back();
+    this->EndNode();
 }
 
 void SvgDeviceContext::RotateGraphic(Point const &orig, double angle)
 {
-    if (m_currentNode.attribute("transform")) {
+    if (m_currentNode->m_attributes.find(" transform=\"") != std::string::npos) {
         return;
     }
 
-    m_currentNode.append_attribute("transform") = StringFormat("rotate(%f %d,%d)", angle, orig.x, orig.y).c_str();
+    std::string &attributes = m_currentNode->m_attributes;
+    StartAttribute(attributes, "transform");
+    AppendFormatted(attributes, "rotate(%f ", angle);
+    AppendPoint(attributes, orig.x, orig.y, ',');
+    attributes.append(")\"");
 }
 
 void SvgDeviceContext::StartPage()
@@ -386,35 +833,43 @@ void SvgDeviceContext::StartPage()
 
     // default styles
     if (this->UseGlobalStyling()) {
-        m_currentNode = m_currentNode.append_child("style");
-        m_currentNode.append_attribute("type") = "text/css";
-        m_currentNode.append_child(pugi::node_pcdata)
-            .set_value("g.page-margin{color:black;font-family:Times;} "
-                       //"g.bounding-box{stroke:red; stroke-width:10} "
-                       //"g.content-bounding-box{stroke:blue; stroke-width:10} "
-                       "g.tempo{font-weight:bold;} g.dir, g.dynam, "
-                       "g.mNum{font-style:italic;} g.label{font-weight:normal;}");
-        m_currentNode = m_svgNodeStack.back();
+        std::string style = "<style";
+        AppendAttribute(style, "type", "text/css");
+        style.append(">");
+        AppendEscaped(style,
+            "g.page-margin{color:black;font-family:Times;} "
+            //"g.bounding-box{stroke:red; stroke-width:10} "
+            //"g.content-bounding-box{stroke:blue; stroke-width:10} "
+            "g.tempo{font-weight:bold;} g.dir, g.dynam, "
+            "g.mNum{font-style:italic;} g.label{font-weight:normal;}",
+            false);
+        // the stroke of the lines (l) and curves (b) that are in the current colour
+        if (this->UseStrokeStyle()) {
+            style.append(" path.l{stroke:currentColor;} "
+                         "path.b{stroke:currentColor;stroke-linecap:round;stroke-linejoin:round;}");
+        }
+        style.append("</style>");
+        this->AppendChild(style, SVG_APPEND);
     }
 
     // a graphic for definition scaling
-    m_currentNode = m_currentNode.append_child("svg");
-    m_svgNodeStack.push_back(m_currentNode);
-    m_currentNode.append_attribute("class") = "definition-scale";
+    std::string attributes;
+    AppendAttribute(attributes, "class", "definition-scale");
     if (this->GetFacsimile()) {
-        m_currentNode.append_attribute("viewBox") = StringFormat("0 0 %d %d", GetWidth(), GetHeight()).c_str();
+        AppendAttribute(attributes, "viewBox", StringFormat("0 0 %d %d", GetWidth(), GetHeight()));
     }
     else {
-        m_currentNode.append_attribute("viewBox")
-            = StringFormat("0 0 %d %d", GetWidth() * DEFINITION_FACTOR, GetHeight() * DEFINITION_FACTOR).c_str();
+        AppendAttribute(attributes, "viewBox",
+            StringFormat("0 0 %d %d", GetWidth() * DEFINITION_FACTOR, GetHeight() * DEFINITION_FACTOR));
     }
+    this->StartStreamedNode("svg", attributes);
 
     // a graphic for the origin
-    m_currentNode = m_currentNode.append_child("g");
-    m_svgNodeStack.push_back(m_currentNode);
-    m_currentNode.append_attribute("class") = "page-margin";
-    m_currentNode.append_attribute("transform")
-        = StringFormat("translate(%d, %d)", (int)((double)m_originX), (int)((double)m_originY)).c_str();
+    attributes.clear();
+    AppendAttribute(attributes, "class", "page-margin");
+    AppendAttribute(attributes, "transform",
+        StringFormat("translate(%d, %d)", (int)((double)m_originX), (int)((double)m_originY)));
+    this->StartStreamedNode("g", attributes);
 
     m_pageNode = m_currentNode;
 }
@@ -422,12 +877,13 @@ void SvgDeviceContext::StartPage()
 void SvgDeviceContext::EndPage()
 {
     // end page-margin
-    m_svgNodeStack.pop_back();
+    this->EndNode();
     // end definition-scale
-    m_svgNodeStack.pop_back();
+    this->EndNode();
     // end page-scale
-    // m_svgNodeStack.pop_back();
-    m_currentNode = m_svgNodeStack.back();
+    // this->EndNode();
+
+    m_pageNode = NULL;
 }
 
 void SvgDeviceContext::SetBackground(int colour, int style)
@@ -463,32 +919,64 @@ Point SvgDeviceContext::GetLogicalOrigin()
     return Point(m_originX, m_originY);
 }
 
-pugi::xml_node SvgDeviceContext::AppendChild(std::string name)
-{
-    pugi::xml_node g = m_currentNode.child("g");
-    if (g)
-        return m_currentNode.insert_child_before(name.c_str(), g);
-    else
-        return m_currentNode.append_child(name.c_str());
-}
-
 // Drawing methods
 void SvgDeviceContext::DrawComplexBezierPath(Point bezier1[4], Point bezier2[4])
 {
-    pugi::xml_node pathChild = AppendChild("path");
-    pathChild.append_attribute("d")
-        = StringFormat("M%d,%d C%d,%d %d,%d %d,%d C%d,%d %d,%d %d,%d", bezier1[0].x, bezier1[0].y, // M command
-            bezier1[1].x, bezier1[1].y, bezier1[2].x, bezier1[2].y, bezier1[3].x, bezier1[3].y, // First bezier
-            bezier2[2].x, bezier2[2].y, bezier2[1].x, bezier2[1].y, bezier2[0].x, bezier2[0].y // Second Bezier
-            )
-              .c_str();
-    // pathChild.append_attribute("fill") = "currentColor";
-    // pathChild.append_attribute("fill-opacity") = "1";
-    pathChild.append_attribute("stroke") = GetColour(m_penStack.top().GetColour()).c_str();
-    pathChild.append_attribute("stroke-linecap") = "round";
-    pathChild.append_attribute("stroke-linejoin") = "round";
-    // pathChild.append_attribute("stroke-opacity") = "1";
-    pathChild.append_attribute("stroke-width") = m_penStack.top().GetWidth();
+    std::string &pathChild = this->StartLeaf("path");
+    StartAttribute(pathChild, "d");
+    // M command
+    pathChild.push_back('M');
+    AppendPoint(pathChild, bezier1[0].x, bezier1[0].y, ',');
+    if (m_svgCompact) {
+        // Relative curves, the second one starting at the end of the first one
+        pathChild.append(" c");
+        AppendPoint(pathChild, bezier1[1].x - bezier1[0].x, bezier1[1].y - bezier1[0].y, ',');
+        pathChild.push_back(' ');
+        AppendPoint(pathChild, bezier1[2].x - bezier1[0].x, bezier1[2].y - bezier1[0].y, ',');
+        pathChild.push_back(' ');
+        AppendPoint(pathChild, bezier1[3].x - bezier1[0].x, bezier1[3].y - bezier1[0].y, ',');
+        pathChild.append(" c");
+        AppendPoint(pathChild, bezier2[2].x - bezier1[3].x, bezier2[2].y - bezier1[3].y, ',');
+        pathChild.push_back(' ');
+        AppendPoint(pathChild, bezier2[1].x - bezier1[3].x, bezier2[1].y - bezier1[3].y, ',');
+        pathChild.push_back(' ');
+        AppendPoint(pathChild, bezier2[0].x - bezier1[3].x, bezier2[0].y - bezier1[3].y, ',');
+        pathChild.push_back('"');
+        if (this->UseStrokeStyle() && (m_penStack.top().GetColour() == AxNONE)) {
+            AppendAttribute(pathChild, "class", "b");
+        }
+        else {
+            AppendAttribute(pathChild, "stroke", GetColour(m_penStack.top().GetColour()));
+            AppendAttribute(pathChild, "stroke-linecap", "round");
+            AppendAttribute(pathChild, "stroke-linejoin", "round");
+        }
+        AppendAttribute(pathChild, "stroke-width", m_penStack.top().GetWidth());
+        this->EndLeaf();
+        return;
+    }
+    // First bezier
+    pathChild.append(" C");
+    AppendPoint(pathChild, bezier1[1].x, bezier1[1].y, ',');
+    pathChild.push_back(' ');
+    AppendPoint(pathChild, bezier1[2].x, bezier1[2].y, ',');
+    pathChild.push_back(' ');
+    AppendPoint(pathChild, bezier1[3].x, bezier1[3].y, ',');
+    // Second Bezier
+    pathChild.append(" C");
+    AppendPoint(pathChild, bezier2[2].x, bezier2[2].y, ',');
+    pathChild.push_back(' ');
+    AppendPoint(pathChild, bezier2[1].x, bezier2[1].y, ',');
+    pathChild.push_back(' ');
+    AppendPoint(pathChild, bezier2[0].x, bezier2[0].y, ',');
+    pathChild.push_back('"');
+    // AppendAttribute(pathChild, "fill", "currentColor");
+    // AppendAttribute(pathChild, "fill-opacity", "1");
+    AppendAttribute(pathChild, "stroke", GetColour(m_penStack.top().GetColour()));
+    AppendAttribute(pathChild, "stroke-linecap", "round");
+    AppendAttribute(pathChild, "stroke-linejoin", "round");
+    // AppendAttribute(pathChild, "stroke-opacity", "1");
+    AppendAttribute(pathChild, "stroke-width", m_penStack.top().GetWidth());
+    this->EndLeaf();
 }
 
 void SvgDeviceContext::DrawCircle(int x, int y, int radius)
@@ -507,18 +995,18 @@ void SvgDeviceContext::DrawEllipse(int x, int y, int width, int height)
     int rh = height / 2;
     int rw = width / 2;
 
-    pugi::xml_node ellipseChild = AppendChild("ellipse");
-    ellipseChild.append_attribute("cx") = x + rw;
-    ellipseChild.append_attribute("cy") = y + rh;
-    ellipseChild.append_attribute("rx") = rw;
-    ellipseChild.append_attribute("ry") = rh;
-    if (currentBrush.GetOpacity() != 1.0) ellipseChild.append_attribute("fill-opacity") = currentBrush.GetOpacity();
-    if (currentPen.GetOpacity() != 1.0) ellipseChild.append_attribute("stroke-opacity") = currentPen.GetOpacity();
+    std::string &ellipseChild = this->StartLeaf("ellipse");
+    AppendAttribute(ellipseChild, "cx", x + rw);
+    AppendAttribute(ellipseChild, "cy", y + rh);
+    AppendAttribute(ellipseChild, "rx", rw);
+    AppendAttribute(ellipseChild, "ry", rh);
+    if (currentBrush.GetOpacity() != 1.0) AppendAttribute(ellipseChild, "fill-opacity", currentBrush.GetOpacity());
+    if (currentPen.GetOpacity() != 1.0) AppendAttribute(ellipseChild, "stroke-opacity", currentPen.GetOpacity());
     if (currentPen.GetWidth() > 0) {
-        ellipseChild.append_attribute("stroke-width") = currentPen.GetWidth();
-        ellipseChild.append_attribute("stroke")
-            = GetColour(m_penStack.top().GetColour()).c_str();
+        AppendAttribute(ellipseChild, "stroke-width", currentPen.GetWidth());
+        AppendAttribute(ellipseChild, "stroke", GetColour(m_penStack.top().GetColour()));
     }
+    this->EndLeaf();
 }
 
 void SvgDeviceContext::DrawEllipticArc(int x, int y, int width, int height, double start, double end)
@@ -579,29 +1067,71 @@ void SvgDeviceContext::DrawEllipticArc(int x, int y, int width, int height, doub
     else
         fSweep = 0;
 
-    pugi::xml_node pathChild = AppendChild("path");
-    pathChild.append_attribute("d") = StringFormat(
-        "M%d %d A%d %d 0.0 %d %d %d %d", int(xs), int(ys), abs(int(rx)), abs(int(ry)), fArc, fSweep, int(xe), int(ye))
-                                          .c_str();
-    // pathChild.append_attribute("fill") = "currentColor";
-    if (currentBrush.GetOpacity() != 1.0) pathChild.append_attribute("fill-opacity") = currentBrush.GetOpacity();
-    if (currentPen.GetOpacity() != 1.0) pathChild.append_attribute("stroke-opacity") = currentPen.GetOpacity();
+    std::string &pathChild = this->StartLeaf("path");
+    StartAttribute(pathChild, "d");
+    pathChild.push_back('M');
+    AppendPoint(pathChild, int(xs), int(ys), ' ');
+    pathChild.append(m_svgCompact ? " a" : " A");
+    AppendPoint(pathChild, abs(int(rx)), abs(int(ry)), ' ');
+    pathChild.append(m_svgCompact ? " 0 " : " 0.0 ");
+    AppendPoint(pathChild, fArc, fSweep, ' ');
+    pathChild.push_back(' ');
+    if (m_svgCompact) {
+        AppendPoint(pathChild, int(xe) - int(xs), int(ye) - int(ys), ' ');
+    }
+    else {
+        AppendPoint(pathChild, int(xe), int(ye), ' ');
+    }
+    pathChild.push_back('"');
+    // AppendAttribute(pathChild, "fill", "currentColor");
+    if (currentBrush.GetOpacity() != 1.0) AppendAttribute(pathChild, "fill-opacity", currentBrush.GetOpacity());
+    if (currentPen.GetOpacity() != 1.0) AppendAttribute(pathChild, "stroke-opacity", currentPen.GetOpacity());
     if (currentPen.GetWidth() > 0) {
-        pathChild.append_attribute("stroke-width") = currentPen.GetWidth();
-        pathChild.append_attribute("stroke")
-            = GetColour(m_penStack.top().GetColour()).c_str();
+        AppendAttribute(pathChild, "stroke-width", currentPen.GetWidth());
+        AppendAttribute(pathChild, "stroke", GetColour(m_penStack.top().GetColour()));
     }
+    this->EndLeaf();
 }
 
 void SvgDeviceContext::DrawLine(int x1, int y1, int x2, int y2)
 {
-    pugi::xml_node pathChild = AppendChild("path");
-    pathChild.append_attribute("d") = StringFormat("M%d %d L%d %d", x1, y1, x2, y2).c_str();
-    pathChild.append_attribute("stroke") = GetColour(m_penStack.top().GetColour()).c_str();
-    if (m_penStack.top().GetDashLength() > 0)
-        pathChild.append_attribute("stroke-dasharray")
-            = StringFormat("%d, %d", m_penStack.top().GetDashLength(), m_penStack.top().GetDashLength()).c_str();
-    if (m_penStack.top().GetWidth() > 1) pathChild.append_attribute("stroke-width") = m_penStack.top().GetWidth();
+    std::string &pathChild = this->StartLeaf("path");
+    StartAttribute(pathChild, "d");
+    pathChild.push_back('M');
+    AppendPoint(pathChild, x1, y1, ' ');
+    if (!m_svgCompact) {
+        pathChild.append(" L");
+        AppendPoint(pathChild, x2, y2, ' ');
+    }
+    // Relative and, for horizontal and vertical lines, single coordinate commands
+    else if (y1 == y2) {
+        pathChild.append(" h");
+        AppendInt(pathChild, x2 - x1);
+    }
+    else if (x1 == x2) {
+        pathChild.append(" v");
+        AppendInt(pathChild, y2 - y1);
+    }
+    else {
+        pathChild.append(" l");
+        AppendPoint(pathChild, x2 - x1, y2 - y1, ' ');
+    }
+    pathChild.push_back('"');
+    if (this->UseStrokeStyle() && (m_penStack.top().GetColour() == AxNONE)) {
+        AppendAttribute(pathChild, "class", "l");
+    }
+    else {
+        AppendAttribute(pathChild, "stroke", GetColour(m_penStack.top().GetColour()));
+    }
+    if (m_penStack.top().GetDashLength() > 0) {
+        StartAttribute(pathChild, "stroke-dasharray");
+        AppendInt(pathChild, m_penStack.top().GetDashLength());
+        pathChild.append(", ");
+        AppendInt(pathChild, m_penStack.top().GetDashLength());
+        pathChild.push_back('"');
+    }
+    if (m_penStack.top().GetWidth() > 1) AppendAttribute(pathChild, "stroke-width", m_penStack.top().GetWidth());
+    this->EndLeaf();
 }
 
 void SvgDeviceContext::DrawPolygon(int n, Point points[], int xoffset, int yoffset, int fill_style)
@@ -612,28 +1142,31 @@ void SvgDeviceContext::DrawPolygon(int n, Point points[], int xoffset, int yoffs
     Pen currentPen = m_penStack.top();
     Brush currentBrush = m_brushStack.top();
 
-    pugi::xml_node polygonChild = AppendChild("polygon");
+    std::string &polygonChild = this->StartLeaf("polygon");
     // if (fillStyle == wxODDEVEN_RULE)
-    //    polygonChild.append_attribute("fill-rule") = "evenodd;";
+    //    AppendAttribute(polygonChild, "fill-rule", "evenodd;");
     // else
-    if (currentPen.GetWidth() > 0)
-        polygonChild.append_attribute("stroke")
-            = GetColour(currentPen.GetColour()).c_str();
-    if (currentPen.GetWidth() > 1)
-        polygonChild.append_attribute("stroke-width") = StringFormat("%d", currentPen.GetWidth()).c_str();
-    if (currentPen.GetOpacity() != 1.0)
-        polygonChild.append_attribute("stroke-opacity") = StringFormat("%f", currentPen.GetOpacity()).c_str();
-    if (currentBrush.GetColour() != AxNONE)
-        polygonChild.append_attribute("fill")
-            = GetColour(currentBrush.GetColour()).c_str();
-    if (currentBrush.GetOpacity() != 1.0)
-        polygonChild.append_attribute("fill-opacity") = StringFormat("%f", currentBrush.GetOpacity()).c_str();
-
-    std::string pointsString;
+    if (currentPen.GetWidth() > 0) AppendAttribute(polygonChild, "stroke", GetColour(currentPen.GetColour()));
+    if (currentPen.GetWidth() > 1) AppendAttribute(polygonChild, "stroke-width", currentPen.GetWidth());
+    if (currentPen.GetOpacity() != 1.0) {
+        StartAttribute(polygonChild, "stroke-opacity");
+        AppendFormatted(polygonChild, "%f", currentPen.GetOpacity());
+        polygonChild.push_back('"');
+    }
+    if (currentBrush.GetColour() != AxNONE) AppendAttribute(polygonChild, "fill", GetColour(currentBrush.GetColour()));
+    if (currentBrush.GetOpacity() != 1.0) {
+        StartAttribute(polygonChild, "fill-opacity");
+        AppendFormatted(polygonChild, "%f", currentBrush.GetOpacity());
+        polygonChild.push_back('"');
+    }
+
+    StartAttribute(polygonChild, "points");
     for (int i = 0; i < n; ++i) {
-        pointsString += StringFormat("%d,%d ", points[i].x + xoffset, points[i].y + yoffset);
+        AppendPoint(polygonChild, points[i].x + xoffset, points[i].y + yoffset, ',');
+        polygonChild.push_back(' ');
     }
-    polygonChild.append_attribute("points") = pointsString.c_str();
+    polygonChild.push_back('"');
+    this->EndLeaf();
 }
 
 void SvgDeviceContext::DrawRectangle(int x, int y, int width, int height)
@@ -655,12 +1188,13 @@ void SvgDeviceContext::DrawRoundedRectangle(int x, int y, int width, int height,
         x -= width;
     }
 
-    pugi::xml_node rectChild = AppendChild("rect");
-    rectChild.append_attribute("x") = x;
-    rectChild.append_attribute("y") = y;
-    rectChild.append_attribute("height") = height;
-    rectChild.append_attribute("width") = width;
-    if (radius != 0) rectChild.append_attribute("rx") = radius;
+    std::string &rectChild = this->StartLeaf("rect");
+    AppendAttribute(rectChild, "x", x);
+    AppendAttribute(rectChild, "y", y);
+    AppendAttribute(rectChild, "height", height);
+    AppendAttribute(rectChild, "width", width);
+    if (radius != 0) AppendAttribute(rectChild, "rx", radius);
+    this->EndLeaf();
 }
 
 void SvgDeviceContext::StartText(int x, int y, data_HORIZONTALALIGNMENT alignment)
@@ -675,45 +1209,44 @@ void SvgDeviceContext::StartText(int x, int y, data_HORIZONTALALIGNMENT alignmen
         anchor = "middle";
     }
 
-    m_currentNode = m_currentNode.append_child("text");
-    m_svgNodeStack.push_back(m_currentNode);
-    m_currentNode.append_attribute("x") = x;
-    m_currentNode.append_attribute("y") = y;
+    SvgNode *node = this->StartNode("text");
+    AppendAttribute(node->m_attributes, "x", x);
+    AppendAttribute(node->m_attributes, "y", y);
     // unless dx, dy have a value they don't need to be set
-    // m_currentNode.append_attribute("dx") = 0;
-    // m_currentNode.append_attribute("dy") = 0;
+    // AppendAttribute(node->m_attributes, "dx", 0);
+    // AppendAttribute(node->m_attributes, "dy", 0);
     if (!anchor.empty()) {
-        m_currentNode.append_attribute("text-anchor") = anchor.c_str();
+        AppendAttribute(node->m_attributes, "text-anchor", anchor);
     }
     // font-size seems to be required in <text> in FireFox and also we set it to 0px so space
     // is not added between tspan elements
-    m_currentNode.append_attribute("font-size") = "0px";
+    AppendAttribute(node->m_attributes, "font-size", "0px");
     //
     if (!m_fontStack.top()->GetFaceName().empty()) {
-        m_currentNode.append_attribute("font-family") = m_fontStack.top()->GetFaceName().c_str();
+        AppendAttribute(node->m_attributes, "font-family", m_fontStack.top()->GetFaceName());
     }
     if (m_fontStack.top()->GetStyle() != FONTSTYLE_NONE) {
         if (m_fontStack.top()->GetStyle() == FONTSTYLE_italic) {
-            m_currentNode.append_attribute("font-style") = "italic";
+            AppendAttribute(node->m_attributes, "font-style", "italic");
         }
         else if (m_fontStack.top()->GetStyle() == FONTSTYLE_normal) {
-            m_currentNode.append_attribute("font-style") = "normal";
+            AppendAttribute(node->m_attributes, "font-style", "normal");
         }
         else if (m_fontStack.top()->GetStyle() == FONTSTYLE_oblique) {
-            m_currentNode.append_attribute("font-style") = "oblique";
+            AppendAttribute(node->m_attributes, "font-style", "oblique");
         }
     }
     if (m_fontStack.top()->GetWeight() != FONTWEIGHT_NONE) {
         if (m_fontStack.top()->GetWeight() == FONTWEIGHT_bold) {
-            m_currentNode.append_attribute("font-weight") = "bold";
+            AppendAttribute(node->m_attributes, "font-weight", "bold");
         }
     }
 }
 
 void SvgDeviceContext::MoveTextTo(int x, int y, data_HORIZONTALALIGNMENT alignment)
 {
-    m_currentNode.append_attribute("x") = x;
-    m_currentNode.append_attribute("y") = y;
+    AppendAttribute(m_currentNode->m_attributes, "x", x);
+    AppendAttribute(m_currentNode->m_attributes, "y", y);
     if (alignment != HORIZONTALALIGNMENT_NONE) {
         std::string anchor = "start";
         if (alignment == HORIZONTALALIGNMENT_right) {
@@ -722,19 +1255,18 @@ void SvgDeviceContext::MoveTextTo(int x, int y, data_HORIZONTALALIGNMENT alignme
         if (alignment == HORIZONTALALIGNMENT_center) {
             anchor = "middle";
         }
-        m_currentNode.append_attribute("text-anchor") = anchor.c_str();
+        AppendAttribute(m_currentNode->m_attributes, "text-anchor", anchor);
     }
 }
 
 void SvgDeviceContext::MoveTextVerticallyTo(int y)
 {
-    m_currentNode.append_attribute("y") = y;
+    AppendAttribute(m_currentNode->m_attributes, "y", y);
 }
 
 void SvgDeviceContext::EndText()
 {
-    m_svgNodeStack.pop_back();
-    m_currentNode = m_svgNodeStack.back();
+    this->EndNode();
 }
 
 void SvgDeviceContext::DrawText(const std::string &text, const std::wstring wtext, int x, int y)
@@ -751,40 +1283,53 @@ void SvgDeviceContext::DrawText(const std::string &text, const std::wstring wtex
         svgText.replace(svgText.size() - 1, 1, "\xC2\xA0");
     }
 
-    std::string currentFaceName
-        = (m_currentNode.attribute("font-family")) ? m_currentNode.attribute("font-family").value() : "";
+    // The font-family of the current node (escaped as the attribute value)
+    std::string currentFaceName;
+    size_t pos = m_currentNode->m_attributes.find(" font-family=\"");
+    if (pos != std::string::npos) {
+        pos += 14;
+        currentFaceName = m_currentNode->m_attributes.substr(pos, m_currentNode->m_attributes.find('"', pos) - pos);
+    }
     std::string fontFaceName = m_fontStack.top()->GetFaceName();
+    std::string escapedFaceName;
+    AppendEscaped(escapedFaceName, fontFaceName.c_str(), true);
 
-    pugi::xml_node textChild = AppendChild("tspan");
+    std::string &textChild = this->StartLeaf("tspan");
     // We still add @xml::space (No: this seems to create problems with Safari)
-    // textChild.append_attribute("xml:space") = "preserve";
+    // AppendAttribute(textChild, "xml:space", "preserve");
     // Set the @font-family only if it is not the same as in the parent node
-    if (!fontFaceName.empty() && (fontFaceName != currentFaceName)) {
-        textChild.append_attribute("font-family") = m_fontStack.top()->GetFaceName().c_str();
+    if (!fontFaceName.empty() && (escapedFaceName != currentFaceName)) {
+        AppendAttribute(textChild, "font-family", m_fontStack.top()->GetFaceName());
         // Special case where we want to specifiy if the VerovioText font (woff) needs to be included in the output
         if (fontFaceName == "VerovioText") this->VrvTextFont();
     }
     if (m_fontStack.top()->GetPointSize() != 0) {
-        textChild.append_attribute("font-size") = StringFormat("%dpx", m_fontStack.top()->GetPointSize()).c_str();
+        StartAttribute(textChild, "font-size");
+        AppendInt(textChild, m_fontStack.top()->GetPointSize());
+        textChild.append("px\"");
     }
     if (m_fontStack.top()->GetStyle() != FONTSIZE_NONE) {
         if (m_fontStack.top()->GetStyle() == FONTSTYLE_italic) {
-            textChild.append_attribute("font-style") = "italic";
+            AppendAttribute(textChild, "font-style", "italic");
         }
         else if (m_fontStack.top()->GetStyle() == FONTSTYLE_normal) {
-            textChild.append_attribute("font-style") = "normal";
+            AppendAttribute(textChild, "font-style", "normal");
         }
         else if (m_fontStack.top()->GetStyle() == FONTSTYLE_oblique) {
-            textChild.append_attribute("font-style") = "oblique";
+            AppendAttribute(textChild, "font-style", "oblique");
         }
     }
-    textChild.append_attribute("class") = "text";
-    textChild.append_child(pugi::node_pcdata).set_value(svgText.c_str());
+    AppendAttribute(textChild, "class", "text");
 
     if ((x != VRV_UNSET) && (y != VRV_UNSET)) {
-        textChild.append_attribute("x") = StringFormat("%d", x).c_str();
-        textChild.append_attribute("y") = StringFormat("%d", y).c_str();
+        AppendAttribute(textChild, "x", x);
+        AppendAttribute(textChild, "y", y);
     }
+
+    textChild.append(">");
+    AppendEscaped(textChild, svgText.c_str(), false);
+    textChild.append("</tspan>");
+    this->EndLeaf(false);
 }
 
 void SvgDeviceContext::DrawRotatedText(const std::string &text, int x, int y, double angle)
@@ -815,13 +1360,29 @@ void SvgDeviceContext::DrawMusicText(const std::wstring &text, int x, int y, boo
         }
 
         // Write the char in the SVG
-        pugi::xml_node useChild = AppendChild("use");
-        useChild.append_attribute("xlink:href") = StringFormat("#%s", glyph->GetCodeStr().c_str()).c_str();
-        useChild.append_attribute("href") = StringFormat("#%s", glyph->GetCodeStr().c_str()).c_str();
-        useChild.append_attribute("x") = x;
-        useChild.append_attribute("y") = y;
-        useChild.append_attribute("height") = StringFormat("%dpx", m_fontStack.top()->GetPointSize()).c_str();
-        useChild.append_attribute("width") = StringFormat("%dpx", m_fontStack.top()->GetPointSize()).c_str();
+        std::string &useChild = this->StartLeaf("use");
+        // SVG 2 clients only need @href
+        if (!m_svgRemoveXlink) {
+            StartAttribute(useChild, "xlink:href");
+            AppendEscaped(useChild, m_glyphSprite.c_str(), true);
+            useChild.push_back('#');
+            AppendEscaped(useChild, glyph->GetCodeStr().c_str(), true);
+            useChild.push_back('"');
+        }
+        StartAttribute(useChild, "href");
+        AppendEscaped(useChild, m_glyphSprite.c_str(), true);
+        useChild.push_back('#');
+        AppendEscaped(useChild, glyph->GetCodeStr().c_str(), true);
+        useChild.push_back('"');
+        AppendAttribute(useChild, "x", x);
+        AppendAttribute(useChild, "y", y);
+        StartAttribute(useChild, "height");
+        AppendInt(useChild, m_fontStack.top()->GetPointSize());
+        useChild.append("px\"");
+        StartAttribute(useChild, "width");
+        AppendInt(useChild, m_fontStack.top()->GetPointSize());
+        useChild.append("px\"");
+        this->EndLeaf();
 
         // Get the bounds of the char
         if (glyph->GetHorizAdvX() > 0)
@@ -837,11 +1398,13 @@ void SvgDeviceContext::DrawSpline(int n, Point points[]) {}
 
 void SvgDeviceContext::DrawSvgShape(int x, int y, int width, int height, pugi::xml_node svg)
 {
-    m_currentNode.append_attribute("transform")
-        = StringFormat("translate(%d, %d) scale(%d, %d)", x, y, DEFINITION_FACTOR, DEFINITION_FACTOR).c_str();
+    AppendAttribute(m_currentNode->m_attributes, "transform",
+        StringFormat("translate(%d, %d) scale(%d, %d)", x, y, DEFINITION_FACTOR, DEFINITION_FACTOR));
 
     for (pugi::xml_node child : svg.children()) {
-        m_currentNode.append_copy(child);
+        std::string svgChild;
+        AppendPugiNode(svgChild, child, m_currentNode->m_depth + 1);
+        this->AddSerialized(svgChild, SVG_APPEND, (std::string(child.name()) == "g"));
     }
 }
 
@@ -849,16 +1412,14 @@ void SvgDeviceContext::DrawBackgroundImage(int x, int y) {}
 
 void SvgDeviceContext::AddDescription(const std::string &text)
 {
-    pugi::xml_node desc = m_currentNode.append_child("desc");
-    desc.append_child(pugi::node_pcdata).set_value(text.c_str());
+    std::string desc = "<desc>";
+    AppendEscaped(desc, text.c_str(), false);
+    desc.append("</desc>");
+    this->AppendChild(desc, SVG_APPEND);
 }
 
-std::string SvgDeviceContext::GetColour(int colour)
+const char *SvgDeviceContext::GetColour(int colour)
 {
-    std::ostringstream ss;
-    ss << "#";
-    ss << std::hex;
-
     switch (colour) {
         case (AxNONE): return "currentColor";
         case (AxBLACK): return "#000000";
@@ -869,12 +1430,12 @@ std::string SvgDeviceContext::GetColour(int colour)
         case (AxCYAN): return "#00FFFF";
         case (AxLIGHT_GREY): return "#777777";
         default:
+            // the components are written in hexadecimal without padding
             int blue = (colour & 255);
             int green = (colour >> 8) & 255;
             int red = (colour >> 16) & 255;
-            ss << red << green << blue;
-            // std::strin = wxDecToHex(char(red)) + wxDecToHex(char(green)) + wxDecToHex(char(blue)) ;  // ax3
-            return ss.str();
+            snprintf(m_colour, sizeof(m_colour), "#%x%x%x", red, green, blue);
+            return m_colour;
     }
 }
 
@@ -882,7 +1443,7 @@ std::string SvgDeviceContext::GetStringSVG(bool xml_declaration)
 {
     if (!m_committed) Commit(xml_declaration);
 
-    return m_outdata.str();
+    return m_outdata;
 }
 
 void SvgDeviceContext::DrawSvgBoundingBoxRectangle(int x, int y, int width, int height)
@@ -899,13 +1460,14 @@ void SvgDeviceContext::DrawSvgBoundingBoxRectangle(int x, int y, int width, int
         x -= width;
     }
 
-    pugi::xml_node rectChild = AppendChild("rect");
-    rectChild.append_attribute("x") = x;
-    rectChild.append_attribute("y") = y;
-    rectChild.append_attribute("height") = height;
-    rectChild.append_attribute("width") = width;
+    std::string &rectChild = this->StartLeaf("rect");
+    AppendAttribute(rectChild, "x", x);
+    AppendAttribute(rectChild, "y", y);
+    AppendAttribute(rectChild, "height", height);
+    AppendAttribute(rectChild, "width", width);
 
-    rectChild.append_attribute("fill") = "transparent";
+    AppendAttribute(rectChild, "fill", "transparent");
+    this->EndLeaf();
 }
 
 void SvgDeviceContext::DrawSvgBoundingBox(Object *object, View *view)
@@ -926,7 +1488,7 @@ void SvgDeviceContext::DrawSvgBoundingBox(Object *object, View *view)
             if (!box) return;
         }
 
-        pugi::xml_node currentNode = m_currentNode;
+        SvgNode *currentNode = m_currentNode;
         if (groupInPage) {
             m_currentNode = m_pageNode;
         }
@@ -1002,4 +1564,4 @@ void SvgDeviceContext::DrawSvgBoundingBox(Object *object, View *view)
     }
 }
 
-} // namespace vrv
+} // namespace vrv
\ No newline at end of file
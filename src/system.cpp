@@ -79,6 +79,8 @@ void System::Reset()
     m_drawingLabelsWidth = 0;
     m_drawingAbbrLabelsWidth = 0;
     m_drawingIsOptimized = false;
+    m_castOffHeight = VRV_UNSET;
+    m_castOffScoreDefWidth = VRV_UNSET;
 }
 
 void System::AddChild(Object *child)
@@ -767,13 +769,17 @@ int System::CastOffPages(FunctorParams *functorParams)
         currentShift += params->m_pgHead2Height + params->m_pgFoot2Height;
     }
 
-    if ((params->m_currentPage->GetChildCount() > 0) && (this->m_drawingYRel - this->GetHeight() - currentShift < 0)) {
+    // The position is calculated from the stored heights (see Doc::RecastOffDoc)
+    int drawingYRel = params->m_contentYRel;
+    params->m_contentYRel -= (m_castOffHeight + params->m_systemMargin);
+
+    if ((params->m_currentPage->GetChildCount() > 0) && (drawingYRel - m_castOffHeight - currentShift < 0)) {
         params->m_currentPage = new Page();
         // Use VRV_UNSET value as a flag
         params->m_pgHeadHeight = VRV_UNSET;
         assert(params->m_doc->GetPages());
         params->m_doc->GetPages()->AddChild(params->m_currentPage);
-        params->m_shift = this->m_drawingYRel - params->m_pageHeight;
+        params->m_shift = drawingYRel - params->m_pageHeight;
     }
 
     // Special case where we use the Relinquish method.
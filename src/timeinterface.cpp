@@ -236,7 +236,7 @@ int TimePointInterface::InterfacePrepareTimePointing(FunctorParams *functorParam
     if (!this->HasStartid()) return FUNCTOR_CONTINUE;
 
     this->SetUuidStr();
-    params->m_timePointingInterfaces.push_back(std::make_pair(this, object->GetClassId()));
+    params->m_timePointingInterfaces.emplace(m_startUuid, this);
 
     return FUNCTOR_CONTINUE;
 }
@@ -254,8 +254,14 @@ int TimeSpanningInterface::InterfacePrepareTimeSpanning(FunctorParams *functorPa
         return FUNCTOR_CONTINUE;
     }
 
+    // Stack the element once for the start and once for the end
     this->SetUuidStr();
-    params->m_timeSpanningInterfaces.push_back(std::make_pair(this, object->GetClassId()));
+    if (!m_startUuid.empty()) {
+        params->m_timeSpanningInterfaces.emplace(m_startUuid, std::make_pair(this, object));
+    }
+    if (!m_endUuid.empty()) {
+        params->m_timeSpanningInterfaces.emplace(m_endUuid, std::make_pair(this, object));
+    }
 
     return FUNCTOR_CONTINUE;
 }
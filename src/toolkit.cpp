@@ -9,16 +9,21 @@
 
 //----------------------------------------------------------------------------
 
+#include <algorithm>
 #include <assert.h>
+#include <set>
+#include <sstream>
 
 //----------------------------------------------------------------------------
 
 #include "comparison.h"
 #include "custos.h"
+#include "displaylistdevicecontext.h"
 #include "editortoolkit_cmn.h"
 #include "editortoolkit_mensural.h"
 #include "editortoolkit_neume.h"
 #include "functorparams.h"
+#include "glyph.h"
 #include "ioabc.h"
 #include "iodarms.h"
 #include "iohumdrum.h"
@@ -32,6 +37,9 @@
 #include "note.h"
 #include "options.h"
 #include "page.h"
+#include "pdfdevicecontext.h"
+#include "rasterdevicecontext.h"
+#include "rendercache.h"
 #include "slur.h"
 #include "staff.h"
 #include "svgdevicecontext.h"
@@ -42,6 +50,7 @@
 #include "MidiFile.h"
 #include "checked.h"
 #include "jsonxx.h"
+#include "pugixml.hpp"
 #include "unchecked.h"
 
 namespace vrv {
@@ -49,6 +58,152 @@ namespace vrv {
 const char *UTF_16_BE_BOM = "\xFE\xFF";
 const char *UTF_16_LE_BOM = "\xFF\xFE";
 
+// Snapshot signature (including the terminating null character) and format version
+const char SNAPSHOT_SIGNATURE[] = "VRVSNAP";
+const unsigned int SNAPSHOT_FORMAT_VERSION = 1;
+
+static void AppendSnapshotInt(std::string &data, unsigned int value)
+{
+    // Always little-endian
+    for (int i = 0; i < 4; ++i) {
+        data.push_back((char)((value >> (8 * i)) & 0xFF));
+    }
+}
+
+static bool ReadSnapshotInt(const std::string &data, size_t &pos, unsigned int &value)
+{
+    if (pos + 4 > data.size()) return false;
+    value = 0;
+    for (int i = 0; i < 4; ++i) {
+        value |= ((unsigned int)(unsigned char)data.at(pos + i)) << (8 * i);
+    }
+    pos += 4;
+    return true;
+}
+
+static void AppendSnapshotString(std::string &data, const std::string &value)
+{
+    AppendSnapshotInt(data, (unsigned int)value.size());
+    data.append(value);
+}
+
+static bool ReadSnapshotString(const std::string &data, size_t &pos, std::string &value)
+{
+    unsigned int size;
+    if (!ReadSnapshotInt(data, pos, size)) return false;
+    if (pos + size > data.size()) return false;
+    value = data.substr(pos, size);
+    pos += size;
+    return true;
+}
+
+static std::string SerializeSvgNode(pugi::xml_node node)
+{
+    std::ostringstream oss;
+    node.print(oss, "", pugi::format_raw);
+    return oss.str();
+}
+
+// Append a value escaped as in XML so that the values cannot be confused with the markup of the shape
+static void AppendSvgEscaped(std::string &shape, const char *value)
+{
+    for (const char *c = value; *c; ++c) {
+        switch (*c) {
+            case '&': shape.append("&amp;"); break;
+            case '<': shape.append("&lt;"); break;
+            case '>': shape.append("&gt;"); break;
+            case '"': shape.append("&quot;"); break;
+            default: shape.push_back(*c);
+        }
+    }
+}
+
+// Build the shape of an SVG node, i.e., its attributes and its content with the <g> elements with an id replaced by a
+// placeholder (with the id or not). With kept, the <g> elements not kept are skipped and their id added to removed.
+// The <defs> of the root are compared separately.
+static void AppendSvgShape(pugi::xml_node node, std::string &shape, std::vector<pugi::xml_node> &graphics, bool withIds,
+    const std::set<std::string> *kept = NULL, std::vector<std::string> *removed = NULL, bool root = false)
+{
+    for (pugi::xml_attribute attr : node.attributes()) {
+        shape.append(" ").append(attr.name()).append("=\"");
+        AppendSvgEscaped(shape, attr.value());
+        shape.append("\"");
+    }
+    shape.append(">");
+    for (pugi::xml_node child : node.children()) {
+        if (child.type() != pugi::node_element) {
+            AppendSvgEscaped(shape, child.value());
+            continue;
+        }
+        if (root && (std::string(child.name()) == "defs")) continue;
+        std::string id = child.attribute("id").value();
+        if ((std::string(child.name()) == "g") && !id.empty()) {
+            if (kept && (kept->count(id) == 0)) {
+                if (removed) removed->push_back(id);
+                continue;
+            }
+            shape.append("<#").append(withIds ? id : "").append(">");
+            graphics.push_back(child);
+            continue;
+        }
+        shape.append("<").append(child.name());
+        AppendSvgShape(child, shape, graphics, withIds, kept, removed, false);
+        shape.append("</>");
+    }
+}
+
+// Compare the old and the new version of an SVG node and add the <g> elements that changed to the replaced ones and
+// the ones that disappeared to the removed ones. The <g> elements are matched by id, or by position when the ids
+// changed (e.g., for a system cast off again). Return false if the node itself changed. A node with a <g> element
+// that moved elsewhere in the new SVG (with an id in newIds) is considered as changed, so the moved element is only
+// in the replaced ones and the patch can be applied in any order.
+static bool DiffSvgNode(pugi::xml_node oldNode, pugi::xml_node newNode, const std::set<std::string> &newIds,
+    jsonxx::Array &replaced, jsonxx::Array &removed, bool root)
+{
+    std::string newShape;
+    std::vector<pugi::xml_node> newGraphics;
+    AppendSvgShape(newNode, newShape, newGraphics, true, NULL, NULL, root);
+
+    std::set<std::string> ids;
+    for (pugi::xml_node graphic : newGraphics) ids.insert(graphic.attribute("id").value());
+
+    std::string oldShape;
+    std::vector<pugi::xml_node> oldGraphics;
+    std::vector<std::string> oldRemoved;
+    AppendSvgShape(oldNode, oldShape, oldGraphics, true, &ids, &oldRemoved, root);
+
+    if (oldShape == newShape) {
+        for (const std::string &id : oldRemoved) {
+            if (newIds.count(id) != 0) return false;
+        }
+        for (const std::string &id : oldRemoved) removed << id;
+    }
+    else {
+        newShape.clear();
+        newGraphics.clear();
+        AppendSvgShape(newNode, newShape, newGraphics, false, NULL, NULL, root);
+        oldShape.clear();
+        oldGraphics.clear();
+        AppendSvgShape(oldNode, oldShape, oldGraphics, false, NULL, NULL, root);
+        if (oldShape != newShape) return false;
+    }
+
+    // The shapes being identical, the graphics are in the same order
+    for (int i = 0; i < (int)newGraphics.size(); ++i) {
+        std::string id = oldGraphics.at(i).attribute("id").value();
+        if ((id == newGraphics.at(i).attribute("id").value())
+            && DiffSvgNode(oldGraphics.at(i), newGraphics.at(i), newIds, replaced, removed, false)) {
+            continue;
+        }
+        // The id is the one of the graphic replaced
+        jsonxx::Object graphic;
+        graphic << "id" << id;
+        graphic << "svg" << SerializeSvgNode(newGraphics.at(i));
+        replaced << graphic;
+    }
+    return true;
+}
+
 //----------------------------------------------------------------------------
 // Toolkit
 //----------------------------------------------------------------------------
@@ -73,6 +228,12 @@ Toolkit::Toolkit(bool initFont)
     m_options = m_doc.GetOptions();
 
     m_editorToolkit = NULL;
+
+    m_renderCache = NULL;
+    m_xmlIdSeed = 0;
+    m_hasPendingData = false;
+    m_midiTimemapFromCache = false;
+    m_spriteFontVersion = 0;
 }
 
 Toolkit::~Toolkit()
@@ -89,6 +250,10 @@ Toolkit::~Toolkit()
         delete m_editorToolkit;
         m_editorToolkit = NULL;
     }
+    if (m_renderCache) {
+        delete m_renderCache;
+        m_renderCache = NULL;
+    }
 }
 
 bool Toolkit::SetResourcePath(const std::string &path)
@@ -122,8 +287,10 @@ bool Toolkit::SetOutputFormat(std::string const &outformat)
     else if (outformat == "timemap") {
         m_outformat = TIMEMAP;
     }
-    else if (outformat != "svg") {
-        LogError("Output format can only be: mei, humdrum, midi, timemap or svg");
+    // The svgz, png and pdf outputs are rendered with the same layout as the svg
+    else if ((outformat != "svg") && (outformat != "svgz") && (outformat != "png") && (outformat != "pdf")
+        && (outformat != "snapshot")) {
+        LogError("Output format can only be: mei, humdrum, midi, timemap, snapshot, svg, svgz, png or pdf");
         return false;
     }
     return true;
@@ -334,10 +501,55 @@ bool Toolkit::LoadUTF16File(const std::string &filename)
 }
 
 bool Toolkit::LoadData(const std::string &data)
+{
+    m_hasPendingData = false;
+    m_pendingData.clear();
+    m_renderCacheDocKey.clear();
+    m_renderCacheDataDigest.clear();
+    m_midiTimemapFromCache = false;
+    m_svgPatchPages.clear();
+
+    if (m_renderCache) {
+        m_renderCacheDataDigest = Sha256(data);
+        this->SetRenderCacheDocKey();
+        std::string pageCount;
+        // The document was loaded before with the same options - defer loading until something is not in the cache
+        // The page count is cached only when the ids are the same each time the document is loaded
+        if (m_renderCache->Get(m_renderCacheDocKey + "-pages", m_renderCacheDocSource, pageCount)) {
+            m_doc.Reset();
+            m_pendingData = data;
+            m_hasPendingData = true;
+            return true;
+        }
+    }
+
+    if (m_renderCache && (m_xmlIdSeed != 0)) {
+        Object::SeedUuid(m_xmlIdSeed);
+    }
+    if (!this->ImportData(data)) {
+        m_renderCacheDocKey.clear();
+        return false;
+    }
+
+    if (m_renderCache && !this->HasDeterministicIds(data)) {
+        m_renderCacheDocKey.clear();
+    }
+    if (m_renderCache && !m_renderCacheDocKey.empty()) {
+        std::string pageCount = StringFormat("%d", this->GetPageCount());
+        m_renderCache->Put(m_renderCacheDocKey + "-pages", m_renderCacheDocSource, pageCount);
+    }
+
+    return true;
+}
+
+bool Toolkit::ImportData(const std::string &data)
 {
     std::string newData;
     FileInputStream *input = NULL;
 
+    m_castOffOptionValues.clear();
+    m_castOffLayoutOptionValues.clear();
+
     auto inputFormat = m_format;
     if (inputFormat == AUTO) {
         inputFormat = IdentifyInputFormat(data);
@@ -545,7 +757,15 @@ bool Toolkit::LoadData(const std::string &data)
                 LogWarning("Requesting layout with encoded breaks but nothing provided in the data");
             }
             // LogElapsedTimeStart();
-            m_doc.CastOffDoc();
+            // Only the first page is cast off with the progressive layout - see Toolkit::LoadPendingData
+            if (m_options->m_progressiveLayout.GetValue()) {
+                m_doc.CastOffDocProgressive(1);
+            }
+            else {
+                m_doc.CastOffDoc();
+            }
+            m_castOffOptionValues = this->GetOptionValues();
+            m_castOffLayoutOptionValues = this->GetOptionValues(false);
             // LogElapsedTimeEnd("layout");
         }
     }
@@ -573,6 +793,8 @@ bool Toolkit::LoadData(const std::string &data)
 
 std::string Toolkit::GetMEI(int pageNo, bool scoreBased)
 {
+    this->LoadPendingData();
+
     if (GetPageCount() == 0) {
         LogWarning("No data loaded");
         return "";
@@ -591,6 +813,8 @@ std::string Toolkit::GetMEI(int pageNo, bool scoreBased)
 
 bool Toolkit::SaveFile(const std::string &filename)
 {
+    this->LoadPendingData();
+
     MeiOutput meioutput(&m_doc, filename.c_str());
     meioutput.SetScoreBasedMEI(m_scoreBasedMei);
     if (!meioutput.ExportFile()) {
@@ -600,6 +824,286 @@ bool Toolkit::SaveFile(const std::string &filename)
     return true;
 }
 
+std::string Toolkit::GetSnapshot()
+{
+    this->LoadPendingData();
+
+    if (GetPageCount() == 0) {
+        LogWarning("No data loaded");
+        return "";
+    }
+    if (m_doc.IsMensuralMusicOnly() || (m_doc.GetType() == Transcription) || (m_doc.GetType() == Facs)) {
+        LogError("Snapshots are not supported for mensural, transcription or facsimile documents");
+        return "";
+    }
+
+    int initialPageNo = (m_doc.GetDrawingPage() == NULL) ? -1 : m_doc.GetDrawingPage()->GetIdx();
+
+    // The page-based MEI keeps the pages and systems as cast off
+    MeiOutput meioutput(&m_doc, "");
+    meioutput.SetScoreBasedMEI(false);
+    std::string mei = meioutput.GetOutput();
+    if (initialPageNo >= 0) m_doc.SetDrawingPage(initialPageNo);
+
+    std::string snapshot(SNAPSHOT_SIGNATURE, sizeof(SNAPSHOT_SIGNATURE));
+    AppendSnapshotInt(snapshot, SNAPSHOT_FORMAT_VERSION);
+    AppendSnapshotString(snapshot, this->GetVersion());
+    AppendSnapshotString(snapshot, this->GetOptions(false));
+    AppendSnapshotString(snapshot, mei);
+
+    return snapshot;
+}
+
+bool Toolkit::SaveSnapshot(const std::string &filename)
+{
+    std::string snapshot = this->GetSnapshot();
+    if (snapshot.empty()) return false;
+
+    std::ofstream outfile(filename.c_str(), std::ios::out | std::ios::binary);
+    if (!outfile.is_open()) {
+        LogError("The snapshot file '%s' could not be opened", filename.c_str());
+        return false;
+    }
+    outfile.write(snapshot.data(), snapshot.size());
+    outfile.close();
+    return true;
+}
+
+bool Toolkit::LoadSnapshot(const std::string &filename)
+{
+    std::ifstream in(filename.c_str(), std::ios::in | std::ios::binary);
+    if (!in.is_open()) {
+        return false;
+    }
+
+    in.seekg(0, std::ios::end);
+    std::streamsize fileSize = (std::streamsize)in.tellg();
+    if (fileSize < 0) {
+        LogError("Unable to read the snapshot file '%s'", filename.c_str());
+        return false;
+    }
+    in.clear();
+    in.seekg(0, std::ios::beg);
+
+    // read the file in a single read
+    std::string content(fileSize, 0);
+    in.read(&content[0], fileSize);
+
+    return LoadSnapshotData(content);
+}
+
+bool Toolkit::LoadSnapshotData(const std::string &data)
+{
+    // Documents loaded from a snapshot are not cached
+    m_hasPendingData = false;
+    m_pendingData.clear();
+    m_renderCacheDocKey.clear();
+    m_midiTimemapFromCache = false;
+    m_svgPatchPages.clear();
+    m_castOffOptionValues.clear();
+    m_castOffLayoutOptionValues.clear();
+
+    size_t pos = sizeof(SNAPSHOT_SIGNATURE);
+    if (data.compare(0, pos, std::string(SNAPSHOT_SIGNATURE, pos)) != 0) {
+        LogError("The data is not a Verovio snapshot");
+        return false;
+    }
+
+    unsigned int formatVersion;
+    std::string version;
+    std::string options;
+    std::string mei;
+    if (!ReadSnapshotInt(data, pos, formatVersion) || (formatVersion != SNAPSHOT_FORMAT_VERSION)) {
+        LogError("Unsupported snapshot format version");
+        return false;
+    }
+    if (!ReadSnapshotString(data, pos, version) || !ReadSnapshotString(data, pos, options)
+        || !ReadSnapshotString(data, pos, mei)) {
+        LogError("The snapshot data is truncated");
+        return false;
+    }
+    // The layout could be different with another version
+    if (version != this->GetVersion()) {
+        LogError("The snapshot was created with version %s and cannot be loaded with version %s", version.c_str(),
+            this->GetVersion().c_str());
+        return false;
+    }
+
+    if (!this->SetOptions(options)) {
+        return false;
+    }
+    // The document in the snapshot is already a selection
+    m_options->m_measureRange.SetValue("");
+    m_options->m_staffSelection.SetValue(std::vector<std::string>());
+
+    MeiInput input(&m_doc, "");
+    if (!input.ImportString(mei)) {
+        LogError("Error importing snapshot data");
+        return false;
+    }
+
+    m_doc.GenerateHeaderAndFooter();
+    m_doc.GenerateMeasureNumbers();
+    m_doc.PrepareDrawing();
+
+    // No cast off is necessary since the pages are stored in the snapshot
+
+    m_view.SetDoc(&m_doc);
+
+    return true;
+}
+
+void Toolkit::EnableRenderCache(const std::string &directory, int maxSize, bool verify)
+{
+    if (m_renderCache) {
+        delete m_renderCache;
+    }
+    m_renderCache = new RenderCache(directory, maxSize, verify);
+}
+
+void Toolkit::DisableRenderCache()
+{
+    // Make sure we do not keep a document that is not loaded
+    this->LoadPendingData();
+
+    if (m_renderCache) {
+        delete m_renderCache;
+        m_renderCache = NULL;
+    }
+    m_renderCacheDocKey.clear();
+}
+
+void Toolkit::ClearRenderCache()
+{
+    if (m_renderCache) {
+        m_renderCache->Clear();
+    }
+}
+
+std::string Toolkit::GetRenderCacheStats() const
+{
+    jsonxx::Object o;
+
+    if (m_renderCache) {
+        o << "hits" << m_renderCache->GetHits();
+        o << "misses" << m_renderCache->GetMisses();
+        o << "evictions" << m_renderCache->GetEvictions();
+        o << "invalids" << m_renderCache->GetInvalids();
+        o << "collisions" << m_renderCache->GetCollisions();
+        o << "entries" << m_renderCache->GetEntryCount();
+        o << "size" << m_renderCache->GetSize();
+    }
+
+    return o.json();
+}
+
+void Toolkit::LoadPendingData(int pageNo)
+{
+    if (m_hasPendingData) {
+        std::string data;
+        data.swap(m_pendingData);
+        m_hasPendingData = false;
+
+        // The options could have been changed since LoadData
+        this->SetRenderCacheDocKey();
+        if (m_xmlIdSeed != 0) {
+            Object::SeedUuid(m_xmlIdSeed);
+        }
+        if (!this->ImportData(data)) {
+            LogError("The data found in the render cache could not be loaded");
+            m_renderCacheDocKey.clear();
+        }
+        else if (!this->HasDeterministicIds(data)) {
+            m_renderCacheDocKey.clear();
+        }
+        else {
+            // For the page count with the current options
+            std::string pageCount = StringFormat("%d", m_doc.GetPageCount());
+            m_renderCache->Put(m_renderCacheDocKey + "-pages", m_renderCacheDocSource, pageCount);
+        }
+    }
+
+    if (!m_doc.IsCastOffPending()) return;
+
+    m_doc.CastOffDocProgressive(pageNo);
+}
+
+void Toolkit::SetRenderCacheDocKey()
+{
+    // The source is compared when an entry is found. It has the digest of the data, so a collision of the 64-bit
+    // keys of two documents is detected and gives a miss
+    m_renderCacheDocSource = vrv::GetVersion() + "\n" + StringFormat("%d", m_format) + "\n";
+    m_renderCacheDocSource += StringFormat("xmlIdSeed=%d\n", m_xmlIdSeed);
+    m_renderCacheDocSource += this->GetOptionValues() + "\n";
+    m_renderCacheDocSource += "sha256=" + m_renderCacheDataDigest + "\n";
+    m_renderCacheDocKey = RenderCache::Hash(m_renderCacheDocSource);
+}
+
+bool Toolkit::GetRenderCacheEntry(const std::string &output, std::string &content)
+{
+    std::string options = this->GetOptionValues() + StringFormat("scale=%d\n", m_scale);
+    std::string key = m_renderCacheDocKey + "-" + RenderCache::Hash(options) + "-" + output;
+    return m_renderCache->Get(key, m_renderCacheDocSource + options + output, content);
+}
+
+void Toolkit::PutRenderCacheEntry(const std::string &output, const std::string &content)
+{
+    std::string options = this->GetOptionValues() + StringFormat("scale=%d\n", m_scale);
+    std::string key = m_renderCacheDocKey + "-" + RenderCache::Hash(options) + "-" + output;
+    m_renderCache->Put(key, m_renderCacheDocSource + options + output, content);
+}
+
+bool Toolkit::HasDeterministicIds(const std::string &data)
+{
+    // The ids of the systems and the pages cast off progressively depend on what was done before
+    if (m_doc.IsCastOffPending()) return false;
+
+    // The ids are generated in the same sequence since the seed is set again before loading
+    if (m_xmlIdSeed != 0) return true;
+
+    // Otherwise all the elements need to have an xml:id in the data
+    std::set<std::string> ids;
+    const std::string attribute = "xml:id=\"";
+    std::string::size_type pos = data.find(attribute);
+    while (pos != std::string::npos) {
+        pos += attribute.size();
+        std::string::size_type end = data.find('"', pos);
+        if (end == std::string::npos) break;
+        ids.insert(data.substr(pos, end - pos));
+        pos = data.find(attribute, end);
+    }
+
+    ArrayOfObjects objects;
+    m_doc.FillFlatList(&objects);
+    ArrayOfObjects::iterator iter;
+    for (iter = objects.begin(); iter != objects.end(); ++iter) {
+        // The doc itself is not rendered
+        if ((*iter) == &m_doc) continue;
+        if (ids.count((*iter)->GetUuid()) == 0) return false;
+    }
+    return true;
+}
+
+std::string Toolkit::GetOptionValues(bool withPageGeometry) const
+{
+    std::string options;
+    const MapOfStrOptions *items = m_options->GetItems();
+    MapOfStrOptions::const_iterator iter;
+    for (iter = items->begin(); iter != items->end(); ++iter) {
+        if (!withPageGeometry) {
+            const Option *option = iter->second;
+            if ((option == &m_options->m_landscape) || (option == &m_options->m_pageHeight)
+                || (option == &m_options->m_pageMarginBottom) || (option == &m_options->m_pageMarginLeft)
+                || (option == &m_options->m_pageMarginRight) || (option == &m_options->m_pageMarginTop)
+                || (option == &m_options->m_pageWidth)) {
+                continue;
+            }
+        }
+        options += iter->first + "=" + iter->second->GetStrValue() + "\n";
+    }
+    return options;
+}
+
 std::string Toolkit::GetOptions(bool defaultValues) const
 {
     jsonxx::Object o;
@@ -769,7 +1273,8 @@ bool Toolkit::SetOptions(const std::string &json_options)
             }
             else if (iter->first == "xmlIdSeed") {
                 if (json.has<jsonxx::Number>("xmlIdSeed")) {
-                    Object::SeedUuid(json.get<jsonxx::Number>("xmlIdSeed"));
+                    m_xmlIdSeed = json.get<jsonxx::Number>("xmlIdSeed");
+                    Object::SeedUuid(m_xmlIdSeed);
                 }
             }
             // Deprecated option
@@ -922,6 +1427,8 @@ bool Toolkit::SetOption(const std::string &option, const std::string &value)
 
 std::string Toolkit::GetElementAttr(const std::string &xmlId)
 {
+    this->LoadPendingData();
+
     jsonxx::Object o;
 
     Object *element = NULL;
@@ -955,11 +1462,22 @@ std::string Toolkit::GetElementAttr(const std::string &xmlId)
 
 bool Toolkit::Edit(const std::string &json_editorAction)
 {
+    this->LoadPendingData();
+    // The edited document does not correspond to the data anymore
+    m_renderCacheDocKey.clear();
+
+    // Only the CMN editor marks the edited measures, otherwise the whole layout has to be redone
+    if (!dynamic_cast<EditorToolkitCMN *>(m_editorToolkit)) {
+        m_doc.MarkLayoutDirty();
+    }
+
     return m_editorToolkit->ParseEditorAction(json_editorAction);
 }
 
 std::string Toolkit::EditInfo()
 {
+    this->LoadPendingData();
+
     return m_editorToolkit->EditInfo();
 }
 
@@ -992,17 +1510,45 @@ void Toolkit::ResetLogBuffer()
 
 void Toolkit::RedoLayout()
 {
+    this->LoadPendingData();
+
     if ((GetPageCount() == 0) || (m_doc.GetType() == Transcription) || (m_doc.GetType() == Facs)) {
         LogWarning("No data to re-layout");
         return;
     }
 
-    m_doc.UnCastOffDoc();
-    m_doc.CastOffDoc();
+    // Cast off only the edited part of the document if the options did not change, or only break the systems
+    // and the pages again if only the page size or margins changed
+    std::string optionValues = this->GetOptionValues();
+    std::string layoutOptionValues = this->GetOptionValues(false);
+    bool castOff = false;
+    if (optionValues == m_castOffOptionValues) {
+        castOff = m_doc.RecastOffDoc();
+    }
+    else if (layoutOptionValues == m_castOffLayoutOptionValues) {
+        castOff = m_doc.RebreakDoc();
+    }
+    if (!castOff) {
+        m_doc.UnCastOffDoc();
+        if (m_options->m_progressiveLayout.GetValue()) {
+            m_doc.CastOffDocProgressive(1);
+        }
+        else {
+            m_doc.CastOffDoc();
+        }
+    }
+    m_castOffOptionValues = optionValues;
+    m_castOffLayoutOptionValues = layoutOptionValues;
+
+    // The systems and the pages cast off again have new ids that a document loaded again will not have
+    m_renderCacheDocKey.clear();
 }
 
 void Toolkit::RedoPagePitchPosLayout()
 {
+    this->LoadPendingData();
+    m_renderCacheDocKey.clear();
+
     Page *page = m_doc.GetDrawingPage();
 
     if (!page) {
@@ -1015,6 +1561,8 @@ void Toolkit::RedoPagePitchPosLayout()
 
 bool Toolkit::RenderToDeviceContext(int pageNo, DeviceContext *deviceContext)
 {
+    this->LoadPendingData(std::max(pageNo, 1));
+
     if (pageNo > GetPageCount()) {
         LogWarning("Page %d does not exist", pageNo);
         return false;
@@ -1039,6 +1587,11 @@ bool Toolkit::RenderToDeviceContext(int pageNo, DeviceContext *deviceContext)
         height = m_doc.GetAdjustedDrawingPageHeight();
     }
 
+    if (m_view.HasClip()) {
+        width = m_view.GetClipWidth() / DEFINITION_FACTOR;
+        height = m_view.GetClipHeight() / DEFINITION_FACTOR;
+    }
+
     // set dimensions
     deviceContext->SetWidth(width);
     deviceContext->SetHeight(height);
@@ -1050,14 +1603,72 @@ bool Toolkit::RenderToDeviceContext(int pageNo, DeviceContext *deviceContext)
         deviceContext->SetHeight(m_doc.GetFacsimile()->GetMaxY());
     }
 
+    // Convert the detail threshold from pixels to logical units
+    int detailThreshold = 0;
+    if (m_options->m_detailThreshold.GetValue() > 0.0) {
+        int factor = (m_doc.GetType() == Facs) ? 1 : DEFINITION_FACTOR;
+        double pixelsPerUnit = userScale / factor;
+        if (deviceContext->Is(RASTER_DEVICE_CONTEXT)) {
+            RasterDeviceContext *rasterDC = dynamic_cast<RasterDeviceContext *>(deviceContext);
+            assert(rasterDC);
+            if (rasterDC->GetPixelWidth() > 0) {
+                pixelsPerUnit = (double)rasterDC->GetPixelWidth() / std::max(deviceContext->GetWidth() * factor, 1);
+            }
+        }
+        if (pixelsPerUnit > 0.0) detailThreshold = (int)(m_options->m_detailThreshold.GetValue() / pixelsPerUnit);
+    }
+    m_view.SetDetailThreshold(detailThreshold);
+
     // render the page
     m_view.DrawCurrentPage(deviceContext, false);
 
     return true;
 }
 
+bool Toolkit::RenderToDeviceContext(int pageNo, DeviceContext *deviceContext, int x, int y, int width, int height)
+{
+    if ((width <= 0) || (height <= 0)) {
+        LogWarning("The clip rectangle %d x %d is empty", width, height);
+        return false;
+    }
+
+    m_view.SetClip(x * DEFINITION_FACTOR, y * DEFINITION_FACTOR, width * DEFINITION_FACTOR, height * DEFINITION_FACTOR);
+    bool success = this->RenderToDeviceContext(pageNo, deviceContext);
+    m_view.ResetClip();
+
+    return success;
+}
+
 std::string Toolkit::RenderToSVG(int pageNo, bool xml_declaration)
 {
+    std::string clip;
+    if (m_view.HasClip()) {
+        clip = StringFormat("-clip-%d-%d-%d-%d", m_view.GetClipX(), m_view.GetClipY(), m_view.GetClipWidth(),
+            m_view.GetClipHeight());
+    }
+    const std::string cacheOutput = StringFormat("svg-%d%s%s", pageNo, clip.c_str(), xml_declaration ? "-decl" : "");
+    bool useCache = (m_renderCache && !m_renderCacheDocKey.empty());
+    bool useSprite = !m_options->m_svgGlyphSprite.GetValue().empty();
+    if (useCache) {
+        std::string output;
+        if (this->GetRenderCacheEntry(cacheOutput, output)) {
+            if (!useSprite) return output;
+            // The glyphs of the page are needed for the sprite
+            std::string glyphs;
+            if (this->GetRenderCacheEntry(cacheOutput + "-glyphs", glyphs)) {
+                std::vector<std::string> glyphList;
+                std::istringstream iss(glyphs);
+                for (std::string line; std::getline(iss, line);) {
+                    if (!line.empty()) glyphList.push_back(line);
+                }
+                this->AddSpriteGlyphs(glyphList);
+                return output;
+            }
+        }
+    }
+
+    this->LoadPendingData(std::max(pageNo, 1));
+
     int initialPageNo = (m_doc.GetDrawingPage() == NULL) ? -1 : m_doc.GetDrawingPage()->GetIdx();
     // Create the SVG object, h & w come from the system
     // We will need to set the size of the page after having drawn it depending on the options
@@ -1080,20 +1691,245 @@ std::string Toolkit::RenderToSVG(int pageNo, bool xml_declaration)
         svg.SetSvgViewBox(true);
     }
 
+    // compact output options
+    svg.SetSvgCompact(m_options->m_svgCompact.GetValue());
+    svg.SetSvgRemoveEmptyGroups(m_options->m_svgRemoveEmptyGroups.GetValue());
+    svg.SetSvgRemoveXlink(m_options->m_svgRemoveXlink.GetValue());
+    svg.SetSvgRemoveLabels(m_options->m_detailThreshold.GetValue() > 0.0);
+    svg.SetGlyphSprite(m_options->m_svgGlyphSprite.GetValue());
+
     // render the page
     RenderToDeviceContext(pageNo, &svg);
 
     std::string out_str = svg.GetStringSVG(xml_declaration);
     if (initialPageNo >= 0) m_doc.SetDrawingPage(initialPageNo);
+    this->AddSpriteGlyphs(svg.GetSmuflGlyphs());
+
+    // Loading the pending data can have changed the key
+    if (useCache && !m_renderCacheDocKey.empty() && (pageNo >= 1) && (pageNo <= GetPageCount())) {
+        this->PutRenderCacheEntry(cacheOutput, out_str);
+        if (useSprite) {
+            std::string glyphs;
+            std::vector<std::string>::const_iterator iter;
+            for (iter = svg.GetSmuflGlyphs().begin(); iter != svg.GetSmuflGlyphs().end(); ++iter) {
+                glyphs.append(*iter + "\n");
+            }
+            this->PutRenderCacheEntry(cacheOutput + "-glyphs", glyphs);
+        }
+    }
     return out_str;
 }
 
+std::string Toolkit::RenderToSVG(int pageNo, int x, int y, int width, int height, bool xml_declaration)
+{
+    if ((width <= 0) || (height <= 0)) {
+        LogWarning("The clip rectangle %d x %d is empty", width, height);
+        return "";
+    }
+
+    m_view.SetClip(x * DEFINITION_FACTOR, y * DEFINITION_FACTOR, width * DEFINITION_FACTOR, height * DEFINITION_FACTOR);
+    std::string output = this->RenderToSVG(pageNo, xml_declaration);
+    m_view.ResetClip();
+
+    return output;
+}
+
+std::string Toolkit::RenderToSVGPatch(int pageNo)
+{
+    std::string svg = this->RenderToSVG(pageNo, false);
+
+    jsonxx::Object o;
+    o << "page" << pageNo;
+
+    bool full = true;
+    std::map<int, std::string>::iterator iter = m_svgPatchPages.find(pageNo);
+    if (iter != m_svgPatchPages.end()) {
+        unsigned int parseOptions = pugi::parse_default | pugi::parse_ws_pcdata_single;
+        pugi::xml_document oldDoc;
+        pugi::xml_document newDoc;
+        if (oldDoc.load_string(iter->second.c_str(), parseOptions) && newDoc.load_string(svg.c_str(), parseOptions)) {
+            // The ids of all the <g> elements of the new SVG for detecting the ones that moved
+            std::set<std::string> newIds;
+            pugi::xpath_node_set graphics = newDoc.select_nodes("//g[@id]");
+            for (pugi::xpath_node graphic : graphics) newIds.insert(graphic.node().attribute("id").value());
+            jsonxx::Array replaced;
+            jsonxx::Array removed;
+            if (DiffSvgNode(oldDoc.document_element(), newDoc.document_element(), newIds, replaced, removed, true)) {
+                full = false;
+                o << "replace" << replaced;
+                o << "remove" << removed;
+                pugi::xml_node oldDefs = oldDoc.document_element().child("defs");
+                pugi::xml_node newDefs = newDoc.document_element().child("defs");
+                std::string defs = (newDefs) ? SerializeSvgNode(newDefs) : "";
+                if (((oldDefs) ? SerializeSvgNode(oldDefs) : "") != defs) o << "defs" << defs;
+            }
+        }
+    }
+
+    o << "full" << full;
+    if (full) o << "svg" << svg;
+
+    m_svgPatchPages[pageNo] = svg;
+
+    return o.json();
+}
+
+std::string Toolkit::RenderMeasureRangeToSVG(int firstMeasure, int lastMeasure, bool xml_declaration)
+{
+    this->LoadPendingData();
+
+    const std::vector<Measure *> &measures = m_doc.GetMeasureIndex();
+
+    if ((firstMeasure < 1) || (lastMeasure < firstMeasure) || (lastMeasure > (int)measures.size())) {
+        LogWarning("Measure range %d-%d does not exist", firstMeasure, lastMeasure);
+        return "";
+    }
+
+    Measure *first = measures.at(firstMeasure - 1);
+    assert(first);
+    Measure *last = measures.at(lastMeasure - 1);
+    assert(last);
+    Page *page = dynamic_cast<Page *>(first->GetFirstParent(PAGE));
+    if (!page || (first->GetFirstParent(SYSTEM) != last->GetFirstParent(SYSTEM))) {
+        LogWarning("Measures %d and %d are not in the same system", firstMeasure, lastMeasure);
+        return "";
+    }
+
+    int initialPageNo = (m_doc.GetDrawingPage() == NULL) ? -1 : m_doc.GetDrawingPage()->GetIdx();
+    // The page needs to be laid out for getting the measure positions - it is not done again when rendering
+    m_view.SetPage(page->GetIdx());
+
+    int left = first->GetDrawingX();
+    int right = last->GetDrawingX() + last->GetWidth();
+    if (first->HasContentHorizontalBB()) left = std::min(left, first->GetContentLeft());
+    if (last->HasContentHorizontalBB()) right = std::max(right, last->GetContentRight());
+
+    int height = m_options->m_pageHeight.GetUnfactoredValue();
+    if (m_options->m_adjustPageHeight.GetValue() || (m_options->m_breaks.GetValue() == BREAKS_none))
+        height = m_doc.GetAdjustedDrawingPageHeight();
+
+    // The clip is in page units and from the left of the page (including the margin)
+    int x = (left + m_doc.m_drawingPageMarginLeft) / DEFINITION_FACTOR;
+    int width = (right + m_doc.m_drawingPageMarginLeft) / DEFINITION_FACTOR - x + 1;
+
+    if (initialPageNo >= 0) m_doc.SetDrawingPage(initialPageNo);
+
+    // Only the measures of the range and their neighbours within the clip are visited
+    m_view.SetClipMeasures(first, last);
+    std::string output = this->RenderToSVG(page->GetIdx() + 1, x, 0, width, height, xml_declaration);
+    m_view.ResetClip();
+
+    return output;
+}
+
+std::string Toolkit::RenderToDisplayList(int pageNo)
+{
+    this->LoadPendingData(std::max(pageNo, 1));
+
+    int initialPageNo = (m_doc.GetDrawingPage() == NULL) ? -1 : m_doc.GetDrawingPage()->GetIdx();
+    DisplayListDeviceContext displayList;
+
+    if (m_doc.GetType() == Facs) {
+        displayList.SetFacsimile(true);
+    }
+
+    RenderToDeviceContext(pageNo, &displayList);
+    if (initialPageNo >= 0) m_doc.SetDrawingPage(initialPageNo);
+
+    return displayList.GetDisplayList();
+}
+
+std::string Toolkit::RenderToPNG(int pageNo, int width)
+{
+    this->LoadPendingData(std::max(pageNo, 1));
+
+    int initialPageNo = (m_doc.GetDrawingPage() == NULL) ? -1 : m_doc.GetDrawingPage()->GetIdx();
+    RasterDeviceContext raster(width);
+
+    if (m_doc.GetType() == Facs) {
+        raster.SetFacsimile(true);
+    }
+
+    bool success = this->RenderToDeviceContext(pageNo, &raster);
+    if (initialPageNo >= 0) m_doc.SetDrawingPage(initialPageNo);
+
+    return (success) ? raster.GetPNG() : "";
+}
+
+bool Toolkit::RenderToPNGFile(const std::string &filename, int pageNo, int width)
+{
+    std::string output = RenderToPNG(pageNo, width);
+    if (output.empty()) return false;
+
+    std::ofstream outfile;
+    outfile.open(filename.c_str(), std::ios::out | std::ios::binary);
+
+    if (!outfile.is_open()) {
+        return false;
+    }
+
+    outfile << output;
+    outfile.close();
+    return true;
+}
+
+std::string Toolkit::RenderToPDF()
+{
+    std::ostringstream output;
+    if (!RenderToPDFStream(output)) return "";
+
+    return output.str();
+}
+
+bool Toolkit::RenderToPDFFile(const std::string &filename)
+{
+    std::ofstream outfile;
+    outfile.open(filename.c_str(), std::ios::out | std::ios::binary);
+
+    if (!outfile.is_open()) {
+        return false;
+    }
+
+    bool success = RenderToPDFStream(outfile);
+    outfile.close();
+    return success;
+}
+
+bool Toolkit::RenderToPDFStream(std::ostream &output)
+{
+    this->LoadPendingData();
+
+    int initialPageNo = (m_doc.GetDrawingPage() == NULL) ? -1 : m_doc.GetDrawingPage()->GetIdx();
+    PdfDeviceContext pdf(output);
+
+    if (m_doc.GetType() == Facs) {
+        pdf.SetFacsimile(true);
+    }
+
+    bool success = true;
+    for (int pageNo = 1; success && (pageNo <= GetPageCount()); ++pageNo) {
+        success = RenderToDeviceContext(pageNo, &pdf);
+    }
+    if (initialPageNo >= 0) m_doc.SetDrawingPage(initialPageNo);
+    if (!success) return false;
+
+    if (!pdf.EndDocument()) {
+        LogError("The PDF could not be written");
+        return false;
+    }
+    return true;
+}
+
 bool Toolkit::RenderToSVGFile(const std::string &filename, int pageNo)
 {
     std::string output = RenderToSVG(pageNo, true);
 
+    // gzip compressed SVG
+    bool svgz = ((filename.size() > 5) && (filename.compare(filename.size() - 5, 5, ".svgz") == 0));
+    if (svgz) output = GzipCompress(output);
+
     std::ofstream outfile;
-    outfile.open(filename.c_str());
+    outfile.open(filename.c_str(), svgz ? std::ios::out | std::ios::binary : std::ios::out);
 
     if (!outfile.is_open()) {
         // add message?
@@ -1105,6 +1941,56 @@ bool Toolkit::RenderToSVGFile(const std::string &filename, int pageNo)
     return true;
 }
 
+std::string Toolkit::GetGlyphSprite(bool allGlyphs)
+{
+    std::vector<std::string> glyphs;
+    if (allGlyphs) {
+        std::map<wchar_t, Glyph>::const_iterator iter;
+        for (iter = Resources::GetFont().begin(); iter != Resources::GetFont().end(); ++iter) {
+            glyphs.push_back(iter->second.GetPath());
+        }
+    }
+    // The glyphs of another font are not used
+    else if (m_spriteFontVersion == Resources::GetFontVersion()) {
+        glyphs = m_spriteGlyphs;
+    }
+
+    // An SVG without page and with the <defs> only
+    SvgDeviceContext svg;
+    svg.SetSvgCompact(m_options->m_svgCompact.GetValue());
+    svg.SetSmuflGlyphs(glyphs);
+    return svg.GetStringSVG(true);
+}
+
+bool Toolkit::GetGlyphSpriteFile(const std::string &filename, bool allGlyphs)
+{
+    std::ofstream outfile;
+    outfile.open(filename.c_str());
+
+    if (!outfile.is_open()) {
+        return false;
+    }
+
+    outfile << this->GetGlyphSprite(allGlyphs);
+    outfile.close();
+    return true;
+}
+
+void Toolkit::AddSpriteGlyphs(const std::vector<std::string> &glyphs)
+{
+    if (m_spriteFontVersion != Resources::GetFontVersion()) {
+        m_spriteGlyphs.clear();
+        m_spriteFontVersion = Resources::GetFontVersion();
+    }
+
+    std::vector<std::string>::const_iterator iter;
+    for (iter = glyphs.begin(); iter != glyphs.end(); ++iter) {
+        if (std::find(m_spriteGlyphs.begin(), m_spriteGlyphs.end(), *iter) == m_spriteGlyphs.end()) {
+            m_spriteGlyphs.push_back(*iter);
+        }
+    }
+}
+
 std::string Toolkit::GetHumdrum()
 {
     return GetHumdrumBuffer();
@@ -1132,6 +2018,17 @@ void Toolkit::GetHumdrum(std::ostream &output)
 
 std::string Toolkit::RenderToMIDI()
 {
+    bool useCache = (m_renderCache && !m_renderCacheDocKey.empty());
+    if (useCache) {
+        std::string output;
+        if (this->GetRenderCacheEntry("midi", output)) {
+            m_midiTimemapFromCache = true;
+            return output;
+        }
+    }
+
+    this->LoadPendingData();
+
     smf::MidiFile outputfile;
     outputfile.absoluteTicks();
     m_doc.ExportMIDI(&outputfile);
@@ -1142,24 +2039,47 @@ std::string Toolkit::RenderToMIDI()
     std::string outputstr = Base64Encode(
         reinterpret_cast<const unsigned char *>(strstrem.str().c_str()), (unsigned int)strstrem.str().length());
 
+    // Loading the pending data can have changed the key
+    if (useCache && !m_renderCacheDocKey.empty()) {
+        this->PutRenderCacheEntry("midi", outputstr);
+    }
     return outputstr;
 }
 
 std::string Toolkit::RenderToTimemap()
 {
     std::string output;
+    bool useCache = (m_renderCache && !m_renderCacheDocKey.empty());
+    if (useCache) {
+        if (this->GetRenderCacheEntry("timemap", output)) {
+            m_midiTimemapFromCache = true;
+            return output;
+        }
+    }
+
+    this->LoadPendingData();
+
     m_doc.ExportTimemap(output);
+
+    // Loading the pending data can have changed the key
+    if (useCache && !m_renderCacheDocKey.empty()) {
+        this->PutRenderCacheEntry("timemap", output);
+    }
     return output;
 }
 
 std::string Toolkit::GetElementsAtTime(int millisec)
 {
+    this->LoadPendingData();
+
     jsonxx::Object o;
     jsonxx::Array a;
 
     // Here we need to check that the midi timemap is done
     if (!m_doc.HasMidiTimemap()) {
-        return o.json();
+        // It is not done when RenderToMIDI or RenderToTimemap was found in the render cache
+        if (m_midiTimemapFromCache) m_doc.CalculateMidiTimemap();
+        if (!m_doc.HasMidiTimemap()) return o.json();
     }
 
     MeasureOnsetOffsetComparison matchMeasureTime(millisec);
@@ -1195,6 +2115,8 @@ std::string Toolkit::GetElementsAtTime(int millisec)
 
 bool Toolkit::RenderToMIDIFile(const std::string &filename)
 {
+    this->LoadPendingData();
+
     smf::MidiFile outputfile;
     outputfile.absoluteTicks();
     m_doc.ExportMIDI(&outputfile);
@@ -1206,6 +2128,8 @@ bool Toolkit::RenderToMIDIFile(const std::string &filename)
 
 bool Toolkit::RenderToTimemapFile(const std::string &filename)
 {
+    this->LoadPendingData();
+
     std::string outputString;
     m_doc.ExportTimemap(outputString);
 
@@ -1220,11 +2144,33 @@ bool Toolkit::RenderToTimemapFile(const std::string &filename)
 
 int Toolkit::GetPageCount()
 {
+    if (m_hasPendingData) {
+        // The options could have been changed since LoadData - the data is loaded if the count is not in the cache
+        this->SetRenderCacheDocKey();
+        std::string pageCount;
+        if (m_renderCache->Get(m_renderCacheDocKey + "-pages", m_renderCacheDocSource, pageCount)) {
+            return atoi(pageCount.c_str());
+        }
+        this->LoadPendingData();
+    }
+
     return m_doc.GetPageCount();
 }
 
+bool Toolkit::IsLayoutComplete()
+{
+    return !m_doc.IsCastOffPending();
+}
+
+void Toolkit::CompleteLayout()
+{
+    this->LoadPendingData();
+}
+
 int Toolkit::GetPageWithElement(const std::string &xmlId)
 {
+    this->LoadPendingData();
+
     Object *element = m_doc.FindChildByUuid(xmlId);
     if (!element) {
         return 0;
@@ -1238,6 +2184,8 @@ int Toolkit::GetPageWithElement(const std::string &xmlId)
 
 int Toolkit::GetTimeForElement(const std::string &xmlId)
 {
+    this->LoadPendingData();
+
     Object *element = m_doc.FindChildByUuid(xmlId);
 
     if (!element) {
@@ -1267,6 +2215,8 @@ int Toolkit::GetTimeForElement(const std::string &xmlId)
 
 std::string Toolkit::GetMIDIValuesForElement(const std::string &xmlId)
 {
+    this->LoadPendingData();
+
     Object *element = m_doc.FindChildByUuid(xmlId);
 
     if (!element) {
@@ -1303,6 +2253,8 @@ void Toolkit::SetHumdrumBuffer(const char *data)
 }
 const char *Toolkit::GetHumdrumBuffer()
 {
+    this->LoadPendingData();
+
     if (m_humdrumBuffer) {
         return m_humdrumBuffer;
     }
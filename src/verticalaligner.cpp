@@ -343,7 +343,7 @@ int StaffAlignment::AdjustFloatingPositioners(FunctorParams *functorParams)
             this->SetOverflowBelow(minMargin + this->GetVerseCount() * (height - descender + margin));
             // For now just clear the overflowBelow, which avoids the overlap to be calculated. We could also keep them
             // and check if they are some lyrics in order to know if the overlap needs to be calculated or not.
-            m_overflowBelowBBoxes.clear();
+            m_overflowBelowBBoxes.Clear();
         }
         return FUNCTOR_SIBLINGS;
     }
@@ -377,7 +377,7 @@ int StaffAlignment::AdjustFloatingPositioners(FunctorParams *functorParams)
             if (overflowAbove > params->m_doc->GetDrawingStaffLineWidth(staffSize) / 2) {
                 // LogMessage("%sparams->m_doctop overflow: %d", current->GetUuid().c_str(), overflowAbove);
                 this->SetOverflowAbove(overflowAbove);
-                this->m_overflowAboveBBoxes.push_back((*iter));
+                this->m_overflowAboveBBoxes.Add((*iter));
             }
 
             int overflowBelow = 0;
@@ -385,7 +385,7 @@ int StaffAlignment::AdjustFloatingPositioners(FunctorParams *functorParams)
             if (overflowBelow > params->m_doc->GetDrawingStaffLineWidth(staffSize) / 2) {
                 // LogMessage("%s bottom overflow: %d", current->GetUuid().c_str(), overflowBelow);
                 this->SetOverflowBelow(overflowBelow);
-                this->m_overflowBelowBBoxes.push_back((*iter));
+                this->m_overflowBelowBBoxes.Add((*iter));
             }
             continue;
         }
@@ -393,33 +393,29 @@ int StaffAlignment::AdjustFloatingPositioners(FunctorParams *functorParams)
         // This sets the default position (without considering any overflowing box)
         (*iter)->CalcDrawingYRel(params->m_doc, this, NULL);
 
-        ArrayOfBoundingBoxes *overflowBoxes = &m_overflowBelowBBoxes;
+        BoundingBoxIndex *overflowBoxes = &m_overflowBelowBBoxes;
         // above?
         data_STAFFREL place = (*iter)->GetDrawingPlace();
         if (place == STAFFREL_above) {
             overflowBoxes = &m_overflowAboveBBoxes;
         }
-        auto i = overflowBoxes->begin();
-        auto end = overflowBoxes->end();
-        while (i != end) {
-            // find all the overflowing elements from the staff that overlap horizonatally
-            i = std::find_if(i, end, [iter](BoundingBox *elem) { return (*iter)->HorizontalContentOverlap(elem); });
-            if (i != end) {
-                // update the yRel accordingly
-                (*iter)->CalcDrawingYRel(params->m_doc, this, *i);
-                i++;
-            }
+        // find all the overflowing elements from the staff that overlap horizonatally
+        ArrayOfBoundingBoxes overlappingBoxes;
+        overflowBoxes->FindHorizontalContentOverlaps(*iter, overlappingBoxes);
+        for (auto &box : overlappingBoxes) {
+            // update the yRel accordingly
+            (*iter)->CalcDrawingYRel(params->m_doc, this, box);
         }
         //  Now update the staffAlignment max overflow (above or below) and add the positioner to the list of
         //  overflowing elements
         if (place == STAFFREL_above) {
             int overflowAbove = this->CalcOverflowAbove((*iter));
-            overflowBoxes->push_back((*iter));
+            overflowBoxes->Add((*iter));
             this->SetOverflowAbove(overflowAbove);
         }
         else {
             int overflowBelow = this->CalcOverflowBelow((*iter));
-            overflowBoxes->push_back((*iter));
+            overflowBoxes->Add((*iter));
             this->SetOverflowBelow(overflowBelow);
         }
     }
@@ -546,25 +542,21 @@ int StaffAlignment::AdjustStaffOverlap(FunctorParams *functorParams)
         return FUNCTOR_SIBLINGS;
     }
 
-    ArrayOfBoundingBoxes::iterator iter;
+    ArrayOfBoundingBoxes::const_iterator iter;
+    ArrayOfBoundingBoxes overlappingBoxes;
     // go through all the elements of the top staff that have an overflow below
-    for (iter = params->m_previous->m_overflowBelowBBoxes.begin();
-         iter != params->m_previous->m_overflowBelowBBoxes.end(); ++iter) {
-        auto i = m_overflowAboveBBoxes.begin();
-        auto end = m_overflowAboveBBoxes.end();
-        while (i != end) {
-            // find all the elements from the bottom staff that have an overflow at the top with an horizontal overlap
-            i = std::find_if(i, end, [iter](BoundingBox *elem) { return (*iter)->HorizontalContentOverlap(elem); });
-            if (i != end) {
-                // calculate the vertical overlap and see if this is more than the expected space
-                int overflowBelow = params->m_previous->CalcOverflowBelow(*iter);
-                int overflowAbove = this->CalcOverflowAbove(*i);
-                int spacing = std::max(params->m_previous->m_overflowBelow, this->m_overflowAbove);
-                if (spacing < (overflowBelow + overflowAbove)) {
-                    // LogDebug("Overlap %d", (overflowBelow + overflowAbove) - spacing);
-                    this->SetOverlap((overflowBelow + overflowAbove) - spacing);
-                }
-                i++;
+    const ArrayOfBoundingBoxes &previousBoxes = params->m_previous->m_overflowBelowBBoxes.GetBoxes();
+    for (iter = previousBoxes.begin(); iter != previousBoxes.end(); ++iter) {
+        // find all the elements from the bottom staff that have an overflow at the top with an horizontal overlap
+        m_overflowAboveBBoxes.FindHorizontalContentOverlaps(*iter, overlappingBoxes);
+        for (auto &box : overlappingBoxes) {
+            // calculate the vertical overlap and see if this is more than the expected space
+            int overflowBelow = params->m_previous->CalcOverflowBelow(*iter);
+            int overflowAbove = this->CalcOverflowAbove(box);
+            int spacing = std::max(params->m_previous->m_overflowBelow, this->m_overflowAbove);
+            if (spacing < (overflowBelow + overflowAbove)) {
+                // LogDebug("Overlap %d", (overflowBelow + overflowAbove) - spacing);
+                this->SetOverlap((overflowBelow + overflowAbove) - spacing);
             }
         }
     }
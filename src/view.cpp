@@ -30,6 +30,20 @@ View::View()
     m_options = NULL;
     m_pageIdx = 0;
 
+    m_hasClip = false;
+    m_clipX = 0;
+    m_clipY = 0;
+    m_clipWidth = 0;
+    m_clipHeight = 0;
+    m_clipFirstMeasure = NULL;
+    m_clipLastMeasure = NULL;
+    m_drawingClipLeft = 0;
+    m_drawingClipRight = 0;
+    m_drawingClipTop = 0;
+    m_drawingClipBottom = 0;
+
+    m_detailThreshold = 0;
+
     m_currentColour = AxNONE;
     m_currentElement = NULL;
     m_currentLayer = NULL;
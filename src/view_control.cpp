@@ -67,6 +67,9 @@ void View::DrawControlElement(DeviceContext *dc, ControlElement *element, Measur
     assert(measure);
     assert(element);
 
+    // Text elements and ornaments are not drawn below the detail threshold
+    if (this->IsBelowDetailThreshold(dc, element, 100)) return;
+
     // For dir, dynam, fermata, and harm, we do not consider the @tstamp2 for rendering
     if (element->Is({ BRACKETSPAN, FIGURE, HAIRPIN, OCTAVE, SLUR, TIE })) {
         // create placeholder
@@ -140,6 +143,9 @@ void View::DrawTimeSpanningElement(DeviceContext *dc, Object *element, System *s
     assert(element);
     assert(system);
 
+    // Neither are their extenders and connectors (e.g., for lyrics or trills)
+    if (this->IsBelowDetailThreshold(dc, element, 100)) return;
+
     if (dc->Is(BBOX_DEVICE_CONTEXT)) {
         BBoxDeviceContext *bBoxDC = dynamic_cast<BBoxDeviceContext *>(dc);
         assert(bBoxDC);
@@ -75,6 +75,9 @@ void View::DrawLayerElement(DeviceContext *dc, LayerElement *element, Layer *lay
         return;
     }
 
+    // Articulations and lyrics are not drawn below the detail threshold
+    if (this->IsBelowDetailThreshold(dc, element, staff->m_drawingStaffSize)) return;
+
     int previousColor = m_currentColour;
 
     if (element == m_currentElement) {
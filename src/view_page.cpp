@@ -9,6 +9,7 @@
 
 //----------------------------------------------------------------------------
 
+#include <algorithm>
 #include <assert.h>
 
 //----------------------------------------------------------------------------
@@ -46,6 +47,7 @@
 #include "syl.h"
 #include "system.h"
 #include "text.h"
+#include "timeinterface.h"
 #include "tuplet.h"
 #include "vrv.h"
 
@@ -75,14 +77,38 @@ void View::DrawCurrentPage(DeviceContext *dc, bool background)
 
     dc->DrawBackgroundImage();
 
+    int marginLeft = m_doc->m_drawingPageMarginLeft;
+    int marginTop = m_doc->m_drawingPageMarginTop;
+    // With a clip, its top-left corner becomes the origin
+    bool clip = (m_hasClip && (m_doc->GetType() != Facs));
+    if (clip) {
+        m_drawingClipLeft = m_clipX - marginLeft;
+        m_drawingClipRight = m_drawingClipLeft + m_clipWidth;
+        m_drawingClipTop = ToLogicalY(m_clipY - marginTop);
+        m_drawingClipBottom = m_drawingClipTop - m_clipHeight;
+        marginLeft -= m_clipX;
+        marginTop -= m_clipY;
+    }
+
     Point origin = dc->GetLogicalOrigin();
-    dc->SetLogicalOrigin(origin.x - m_doc->m_drawingPageMarginLeft, origin.y - m_doc->m_drawingPageMarginTop);
+    dc->SetLogicalOrigin(origin.x - marginLeft, origin.y - marginTop);
 
     dc->StartPage();
 
     for (i = 0; i < m_currentPage->GetSystemCount(); ++i) {
         // cast to System check in DrawSystem
         System *system = dynamic_cast<System *>(m_currentPage->GetChild(i));
+        assert(system);
+        if (clip) {
+            int top = system->GetDrawingY();
+            int bottom = top - system->GetHeight();
+            if (system->HasContentVerticalBB()) {
+                top = std::max(top, system->GetContentTop());
+                bottom = std::min(bottom, system->GetContentBottom());
+            }
+            // Systems are fully independent, so nothing else is needed for the ones outside the clip
+            if (this->IsClippedY(top, bottom)) continue;
+        }
         DrawSystem(dc, system);
     }
 
@@ -91,6 +117,117 @@ void View::DrawCurrentPage(DeviceContext *dc, bool background)
     dc->EndPage();
 }
 
+void View::SetClip(int x, int y, int width, int height)
+{
+    m_hasClip = true;
+    m_clipX = x;
+    m_clipY = y;
+    m_clipWidth = width;
+    m_clipHeight = height;
+}
+
+void View::SetClipMeasures(Measure *first, Measure *last)
+{
+    m_clipFirstMeasure = first;
+    m_clipLastMeasure = last;
+}
+
+void View::ResetClip()
+{
+    m_hasClip = false;
+    m_clipFirstMeasure = NULL;
+    m_clipLastMeasure = NULL;
+}
+
+bool View::IsClippedX(int left, int right) const
+{
+    if (!m_hasClip || (m_doc->GetType() == Facs)) return false;
+
+    // Keep a margin because the bounding boxes are not updated after the justification
+    int margin = m_doc->GetDrawingDoubleUnit(100) * 2;
+    return ((right < m_drawingClipLeft - margin) || (left > m_drawingClipRight + margin));
+}
+
+bool View::IsClippedY(int top, int bottom) const
+{
+    if (!m_hasClip || (m_doc->GetType() == Facs)) return false;
+
+    int margin = m_doc->GetDrawingDoubleUnit(100) * 2;
+    return ((top < m_drawingClipBottom - margin) || (bottom > m_drawingClipTop + margin));
+}
+
+bool View::IsClippedMeasure(Measure *measure) const
+{
+    assert(measure);
+
+    int left = measure->GetDrawingX();
+    int right = left + measure->GetWidth();
+    if (measure->HasContentHorizontalBB()) {
+        left = std::min(left, measure->GetContentLeft());
+        right = std::max(right, measure->GetContentRight());
+    }
+    return this->IsClippedX(left, right);
+}
+
+bool View::IsClippedSpanning(Object *element, System *system)
+{
+    assert(element);
+    assert(system);
+
+    TimeSpanningInterface *interface = element->GetTimeSpanningInterface();
+    if (!interface) return false;
+
+    Measure *startMeasure = interface->GetStartMeasure();
+    Measure *endMeasure = interface->GetEndMeasure();
+    // Elements with no end (e.g., with @next) are kept
+    if (!startMeasure || !endMeasure) return false;
+
+    // Start and end measures in another system extend the element to the beginning or to the end of the system
+    int left = VRV_UNSET;
+    int right = -VRV_UNSET;
+    if (startMeasure->GetFirstParent(SYSTEM) == system) left = startMeasure->GetDrawingX();
+    if (endMeasure->GetFirstParent(SYSTEM) == system) right = endMeasure->GetDrawingX() + endMeasure->GetWidth();
+    return this->IsClippedX(left, right);
+}
+
+bool View::IsBelowDetailThreshold(DeviceContext *dc, int size) const
+{
+    assert(dc);
+
+    // The bounding boxes are always calculated with all the details
+    if ((m_detailThreshold <= 0) || dc->Is(BBOX_DEVICE_CONTEXT)) return false;
+
+    return (size < m_detailThreshold);
+}
+
+bool View::IsBelowDetailThreshold(DeviceContext *dc, Object *element, int staffSize)
+{
+    assert(dc);
+    assert(element);
+
+    if (m_detailThreshold <= 0) return false;
+
+    switch (element->GetClassId()) {
+        // Text elements with the size of the lyric font
+        case DIR:
+        case DYNAM:
+        case HARM:
+        case SYL:
+        case TEMPO:
+        case VERSE: return this->IsBelowDetailThreshold(dc, m_doc->GetDrawingLyricFont(staffSize)->GetPointSize());
+        // Glyph elements with the size of the staff space
+        case ARTIC:
+        case ARTIC_PART:
+        case BREATH:
+        case FERMATA:
+        case MORDENT:
+        case PEDAL:
+        case TRILL:
+        case TURN: return this->IsBelowDetailThreshold(dc, m_doc->GetDrawingDoubleUnit(staffSize));
+        default: return false;
+    }
+}
+
 double View::GetPPUFactor() const
 {
     if (!m_currentPage) return 1.0;
@@ -163,7 +300,9 @@ void View::DrawSystem(DeviceContext *dc, System *system)
     system->ResetDrawingList();
 
     Measure *systemStart = dynamic_cast<Measure *>(system->FindChildByType(MEASURE));
-    if (systemStart) {
+    // The scoreDef (and the brace or bracket on its left) is not drawn when the clip is after the first measure
+    if (systemStart && !this->IsClippedX(system->GetDrawingX() - system->GetDrawingLabelsWidth(),
+                           systemStart->GetDrawingX() + systemStart->GetWidth())) {
         DrawScoreDef(dc, system->GetDrawingScoreDef(), systemStart, system->GetDrawingX(), NULL);
     }
 
@@ -874,6 +1013,26 @@ void View::DrawMeasure(DeviceContext *dc, Measure *measure, System *system)
     }
 }
 
+void View::DrawClippedMeasure(DeviceContext *dc, Measure *measure, System *system)
+{
+    assert(dc);
+    assert(measure);
+    assert(system);
+
+    // Nothing is drawn but the spanning elements and the ending need to be postponed to the end of the system
+    // because they can extend into the clip. The spanning elements starting in the measure are only drawn from the
+    // following measures (see View::DrawClippedStaff)
+    for (auto &child : *measure->GetChildren()) {
+        if (child->Is(STAFF)) {
+            DrawClippedStaff(dc, dynamic_cast<Staff *>(child), measure, system);
+        }
+    }
+
+    if (measure->GetDrawingEnding()) {
+        system->AddToDrawingList(measure->GetDrawingEnding());
+    }
+}
+
 void View::DrawMNum(DeviceContext *dc, MNum *mnum, Measure *measure)
 {
     assert(dc);
@@ -974,12 +1133,33 @@ void View::DrawStaff(DeviceContext *dc, Staff *staff, Measure *measure, System *
     DrawStaffDefCautionary(dc, staff, measure);
 
     for (auto &spanningElement : staff->m_timeSpanningElements) {
+        if (this->IsClippedSpanning(spanningElement, system)) continue;
         system->AddToDrawingListIfNeccessary(spanningElement);
     }
 
     dc->EndGraphic(staff, this);
 }
 
+void View::DrawClippedStaff(DeviceContext *dc, Staff *staff, Measure *measure, System *system)
+{
+    assert(dc);
+    assert(staff);
+    assert(measure);
+    assert(system);
+
+    assert(system->GetDrawingScoreDef());
+    StaffDef *staffDef = system->GetDrawingScoreDef()->GetStaffDef(staff->GetN());
+    if (staffDef && (staffDef->GetDrawingVisibility() == OPTIMIZATION_HIDDEN)) {
+        return;
+    }
+
+    // Nothing is drawn but the elements spanning from previous measures need to be postponed to the end of the system
+    for (auto &spanningElement : staff->m_timeSpanningElements) {
+        if (this->IsClippedSpanning(spanningElement, system)) continue;
+        system->AddToDrawingListIfNeccessary(spanningElement);
+    }
+}
+
 void View::DrawStaffLines(DeviceContext *dc, Staff *staff, Measure *measure, System *system)
 {
     assert(dc);
@@ -1004,10 +1184,16 @@ void View::DrawStaffLines(DeviceContext *dc, Staff *staff, Measure *measure, Sys
     dc->SetPen(m_currentColour, ToDeviceContextX(lineWidth), AxSOLID);
     dc->SetBrush(m_currentColour, AxSOLID);
 
+    int doubleUnit = m_doc->GetDrawingDoubleUnit(staff->m_drawingStaffSize);
+    // Below the detail threshold, only the outer lines are drawn
+    bool simplified = this->IsBelowDetailThreshold(dc, doubleUnit);
+
     for (j = 0; j < staff->m_drawingLines; ++j) {
-        dc->DrawLine(ToDeviceContextX(x1), ToDeviceContextY(y), ToDeviceContextX(x2), ToDeviceContextY(y));
+        if (!simplified || (j == 0) || (j == staff->m_drawingLines - 1)) {
+            dc->DrawLine(ToDeviceContextX(x1), ToDeviceContextY(y), ToDeviceContextX(x2), ToDeviceContextY(y));
+        }
         // For drawing rectangles instead of lines
-        y -= m_doc->GetDrawingDoubleUnit(staff->m_drawingStaffSize);
+        y -= doubleUnit;
     }
 
     dc->ResetPen();
@@ -1232,10 +1418,41 @@ void View::DrawSystemChildren(DeviceContext *dc, Object *parent, System *system)
     assert(parent);
     assert(system);
 
-    for (auto current : *parent->GetChildren()) {
+    const ArrayOfObjects *children = parent->GetChildren();
+    int first = 0;
+    int last = (int)children->size() - 1;
+
+    // With a measure range, only the measures of the range and the neighbouring children within the clip are visited
+    int firstPosition, lastPosition;
+    if (m_hasClip && m_clipFirstMeasure && (parent == system)
+        && (m_doc->GetMeasureSystem(m_clipFirstMeasure, firstPosition) == system)
+        && (m_doc->GetMeasureSystem(m_clipLastMeasure, lastPosition) == system)) {
+        first = firstPosition;
+        last = lastPosition;
+        while (first > 0) {
+            Object *previous = children->at(first - 1);
+            if (previous->Is(MEASURE) && this->IsClippedMeasure(dynamic_cast<Measure *>(previous))) break;
+            --first;
+        }
+        while (last < (int)children->size() - 1) {
+            Object *next = children->at(last + 1);
+            if (next->Is(MEASURE) && this->IsClippedMeasure(dynamic_cast<Measure *>(next))) break;
+            ++last;
+        }
+    }
+
+    for (int i = first; i <= last; ++i) {
+        Object *current = children->at(i);
         if (current->Is(MEASURE)) {
             // cast to Measure check in DrawMeasure
-            DrawMeasure(dc, dynamic_cast<Measure *>(current), system);
+            Measure *measure = dynamic_cast<Measure *>(current);
+            assert(measure);
+            if (this->IsClippedMeasure(measure)) {
+                DrawClippedMeasure(dc, measure, system);
+            }
+            else {
+                DrawMeasure(dc, measure, system);
+            }
         }
         // scoreDef are not drawn directly, but anything else should not be possible
         else if (current->Is(SCOREDEF)) {
@@ -1268,7 +1485,20 @@ void View::DrawMeasureChildren(DeviceContext *dc, Object *parent, Measure *measu
     for (auto current : *parent->GetChildren()) {
         if (current->Is(STAFF)) {
             // cast to Staff check in DrawStaff
-            DrawStaff(dc, dynamic_cast<Staff *>(current), measure, system);
+            Staff *staff = dynamic_cast<Staff *>(current);
+            assert(staff);
+            int top = staff->GetDrawingY();
+            int bottom = top - (staff->m_drawingLines - 1) * m_doc->GetDrawingDoubleUnit(staff->m_drawingStaffSize);
+            if (staff->HasContentVerticalBB()) {
+                top = std::max(top, staff->GetContentTop());
+                bottom = std::min(bottom, staff->GetContentBottom());
+            }
+            if (this->IsClippedY(top, bottom)) {
+                DrawClippedStaff(dc, staff, measure, system);
+            }
+            else {
+                DrawStaff(dc, staff, measure, system);
+            }
         }
         else if (current->IsControlElement()) {
             // cast to ControlElement check in DrawControlElement
@@ -62,6 +62,8 @@ void View::DrawTextString(DeviceContext *dc, std::wstring str, TextDrawingParams
 {
     assert(dc);
 
+    if (this->IsBelowDetailThreshold(dc, dc->GetFont()->GetPointSize())) return;
+
     dc->DrawText(UTF16to8(str), str);
 }
 
@@ -200,6 +202,8 @@ void View::DrawLyricString(DeviceContext *dc, std::wstring str, int staffSize)
 {
     assert(dc);
 
+    if (this->IsBelowDetailThreshold(dc, dc->GetFont()->GetPointSize())) return;
+
     std::wistringstream iss(str);
     std::wstring token;
     while (std::getline(iss, token, L'_')) {
@@ -10,6 +10,7 @@
 
 //----------------------------------------------------------------------------
 
+#include <algorithm>
 #include <assert.h>
 #include <cmath>
 #include <sstream>
@@ -62,6 +63,7 @@ namespace vrv {
 
 std::string Resources::m_path = "/usr/local/share/verovio";
 std::map<wchar_t, Glyph> Resources::m_font;
+int Resources::m_fontVersion = 0;
 std::map<wchar_t, Glyph> Resources::m_textFont;
 
 //----------------------------------------------------------------------------
@@ -118,6 +120,9 @@ bool Resources::LoadFont(std::string fontName)
         return false;
     }
 
+    // The glyphs are going to be replaced
+    m_fontVersion++;
+
     // First loop through the fontName directory and load each glyph
     // Since the filename starts with the Unicode code, it is used
     // to assign the glyph to the corresponding position in m_fonts
@@ -467,6 +472,47 @@ std::string GetVersion()
     return StringFormat("%d.%d.%d%s-%s", VERSION_MAJOR, VERSION_MINOR, VERSION_REVISION, dev.c_str(), GIT_COMMIT);
 }
 
+bool ParseColour(const std::string &value, int &colour)
+{
+    static const std::map<std::string, int> keywords = { { "black", 0x000000 }, { "silver", 0xC0C0C0 },
+        { "gray", 0x808080 }, { "grey", 0x808080 }, { "white", 0xFFFFFF }, { "maroon", 0x800000 },
+        { "red", 0xFF0000 }, { "purple", 0x800080 }, { "fuchsia", 0xFF00FF }, { "magenta", 0xFF00FF },
+        { "green", 0x008000 }, { "lime", 0x00FF00 }, { "olive", 0x808000 }, { "yellow", 0xFFFF00 },
+        { "navy", 0x000080 }, { "blue", 0x0000FF }, { "teal", 0x008080 }, { "aqua", 0x00FFFF },
+        { "cyan", 0x00FFFF }, { "orange", 0xFFA500 } };
+
+    if ((value.size() == 7) && (value[0] == '#')) {
+        char *end = NULL;
+        long rgb = strtol(value.c_str() + 1, &end, 16);
+        if (*end != 0) return false;
+        colour = (int)rgb;
+        return true;
+    }
+    if ((value.size() == 4) && (value[0] == '#')) {
+        char *end = NULL;
+        long rgb = strtol(value.c_str() + 1, &end, 16);
+        if (*end != 0) return false;
+        int red = (rgb >> 8) & 0xF;
+        int green = (rgb >> 4) & 0xF;
+        int blue = rgb & 0xF;
+        colour = (red * 17) << 16 | (green * 17) << 8 | (blue * 17);
+        return true;
+    }
+    if (value.compare(0, 4, "rgb(") == 0) {
+        int red, green, blue;
+        if (sscanf(value.c_str(), "rgb(%d,%d,%d)", &red, &green, &blue) != 3) return false;
+        colour = (std::min(std::max(red, 0), 255) << 16) | (std::min(std::max(green, 0), 255) << 8)
+            | std::min(std::max(blue, 0), 255);
+        return true;
+    }
+    std::string lower = value;
+    std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+    std::map<std::string, int>::const_iterator iter = keywords.find(lower);
+    if (iter == keywords.end()) return false;
+    colour = iter->second;
+    return true;
+}
+
 //----------------------------------------------------------------------------
 // Base64 code borrowed
 //----------------------------------------------------------------------------
@@ -538,4 +584,286 @@ std::string Base64Encode(unsigned char const *bytesToEncode, unsigned int inLen)
     return ret;
 }
 
+//----------------------------------------------------------------------------
+// Gzip and zlib compression
+//----------------------------------------------------------------------------
+
+static const int deflateLengthBase[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67,
+    83, 99, 115, 131, 163, 195, 227, 258 };
+static const int deflateLengthExtra[29]
+    = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+static const int deflateDistanceBase[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513,
+    769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+static const int deflateDistanceExtra[30]
+    = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+/**
+ * Write the bits of a deflate stream (starting with the least significant bit)
+ */
+class DeflateWriter {
+public:
+    DeflateWriter(std::string &output) : m_output(output), m_bits(0), m_bitCount(0) {}
+
+    void WriteBits(unsigned int value, int count)
+    {
+        m_bits |= value << m_bitCount;
+        m_bitCount += count;
+        while (m_bitCount >= 8) {
+            m_output.push_back(char(m_bits & 0xFF));
+            m_bits >>= 8;
+            m_bitCount -= 8;
+        }
+    }
+
+    // Huffman codes are written starting with the most significant bit
+    void WriteCode(unsigned int code, int length)
+    {
+        unsigned int reversed = 0;
+        for (int i = 0; i < length; ++i) {
+            reversed = (reversed << 1) | (code & 1);
+            code >>= 1;
+        }
+        this->WriteBits(reversed, length);
+    }
+
+    // Literal and length symbols with the fixed Huffman codes
+    void WriteSymbol(int symbol)
+    {
+        if (symbol < 144)
+            this->WriteCode(0x30 + symbol, 8);
+        else if (symbol < 256)
+            this->WriteCode(0x190 + symbol - 144, 9);
+        else if (symbol < 280)
+            this->WriteCode(symbol - 256, 7);
+        else
+            this->WriteCode(0xC0 + symbol - 280, 8);
+    }
+
+    void WriteMatch(int length, int distance)
+    {
+        int code = 0;
+        while ((code < 28) && (deflateLengthBase[code + 1] <= length)) ++code;
+        this->WriteSymbol(257 + code);
+        this->WriteBits(length - deflateLengthBase[code], deflateLengthExtra[code]);
+        code = 0;
+        while ((code < 29) && (deflateDistanceBase[code + 1] <= distance)) ++code;
+        this->WriteCode(code, 5);
+        this->WriteBits(distance - deflateDistanceBase[code], deflateDistanceExtra[code]);
+    }
+
+    void Flush()
+    {
+        if (m_bitCount > 0) m_output.push_back(char(m_bits & 0xFF));
+        m_bits = 0;
+        m_bitCount = 0;
+    }
+
+private:
+    std::string &m_output;
+    unsigned int m_bits;
+    int m_bitCount;
+};
+
+static std::vector<unsigned int> CreateCrc32Table()
+{
+    std::vector<unsigned int> table(256);
+    for (unsigned int i = 0; i < 256; ++i) {
+        unsigned int crc = i;
+        for (int j = 0; j < 8; ++j) crc = (crc & 1) ? (0xEDB88320u ^ (crc >> 1)) : (crc >> 1);
+        table[i] = crc;
+    }
+    return table;
+}
+
+static void AppendUInt32(std::string &output, unsigned int value)
+{
+    for (int i = 0; i < 4; ++i) output.push_back(char((value >> (8 * i)) & 0xFF));
+}
+
+/**
+ * Append the deflate stream of the data, as a single final block with the fixed Huffman codes
+ */
+static void Deflate(const std::string &data, std::string &output)
+{
+    const int windowSize = 32768;
+    const int hashSize = 32768;
+    const int maxChain = 64;
+    const int minMatch = 3;
+    const int maxMatch = 258;
+
+    const unsigned char *bytes = (const unsigned char *)data.data();
+    const int size = (int)data.size();
+
+    DeflateWriter writer(output);
+    // a single final block with the fixed Huffman codes
+    writer.WriteBits(1, 1);
+    writer.WriteBits(1, 2);
+
+    // the last position for each hash of three bytes and the previous position with the same hash
+    std::vector<int> head(hashSize, -1);
+    std::vector<int> prev(windowSize, -1);
+
+    int pos = 0;
+    int inserted = 0;
+    while (pos < size) {
+        int bestLength = 0;
+        int bestDistance = 0;
+        if (pos + minMatch <= size) {
+            const int maxLength = std::min(maxMatch, size - pos);
+            unsigned int hash = ((bytes[pos] << 10) ^ (bytes[pos + 1] << 5) ^ bytes[pos + 2]) & (hashSize - 1);
+            int candidate = head[hash];
+            int chain = maxChain;
+            while ((candidate >= 0) && (pos - candidate <= windowSize) && (chain-- > 0)) {
+                if (bytes[candidate + bestLength] == bytes[pos + bestLength]) {
+                    int length = 0;
+                    while ((length < maxLength) && (bytes[candidate + length] == bytes[pos + length])) ++length;
+                    if (length > bestLength) {
+                        bestLength = length;
+                        bestDistance = pos - candidate;
+                        if (length == maxLength) break;
+                    }
+                }
+                int next = prev[candidate & (windowSize - 1)];
+                if (next >= candidate) break;
+                candidate = next;
+            }
+        }
+
+        if (bestLength >= minMatch) {
+            writer.WriteMatch(bestLength, bestDistance);
+        }
+        else {
+            bestLength = 1;
+            writer.WriteSymbol(bytes[pos]);
+        }
+        pos += bestLength;
+
+        // add the positions to the hash chains
+        for (; (inserted < pos) && (inserted + minMatch <= size); ++inserted) {
+            unsigned int hash
+                = ((bytes[inserted] << 10) ^ (bytes[inserted + 1] << 5) ^ bytes[inserted + 2]) & (hashSize - 1);
+            prev[inserted & (windowSize - 1)] = head[hash];
+            head[hash] = inserted;
+        }
+    }
+
+    // end of block
+    writer.WriteSymbol(256);
+    writer.Flush();
+}
+
+unsigned int Crc32(const std::string &data)
+{
+    static const std::vector<unsigned int> crcTable = CreateCrc32Table();
+    unsigned int crc = 0xFFFFFFFFu;
+    for (std::string::const_iterator iter = data.begin(); iter != data.end(); ++iter) {
+        crc = crcTable[(crc ^ (unsigned char)*iter) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+static unsigned int RotateRight(unsigned int value, int bits)
+{
+    return (value >> bits) | (value << (32 - bits));
+}
+
+std::string Sha256(const std::string &data)
+{
+    static const unsigned int k[64] = { 0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1,
+        0x923f82a4, 0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7,
+        0xc19bf174, 0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+        0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967, 0x27b70a85,
+        0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+        0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070, 0x19a4c116, 0x1e376c08, 0x2748774c,
+        0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+        0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2 };
+    unsigned int h[8]
+        = { 0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19 };
+
+    // padding with 0x80, zeros and the length in bits (big-endian) to a multiple of 64 bytes
+    std::string message = data;
+    message.push_back((char)0x80);
+    while (message.size() % 64 != 56) message.push_back((char)0);
+    unsigned long long bits = (unsigned long long)data.size() * 8;
+    for (int i = 7; i >= 0; --i) message.push_back((char)((bits >> (8 * i)) & 0xFF));
+
+    const unsigned char *bytes = (const unsigned char *)message.data();
+    unsigned int w[64];
+    for (size_t chunk = 0; chunk < message.size(); chunk += 64) {
+        for (int i = 0; i < 16; ++i) {
+            const unsigned char *b = bytes + chunk + 4 * i;
+            w[i] = ((unsigned int)b[0] << 24) | ((unsigned int)b[1] << 16) | ((unsigned int)b[2] << 8) | b[3];
+        }
+        for (int i = 16; i < 64; ++i) {
+            unsigned int s0 = RotateRight(w[i - 15], 7) ^ RotateRight(w[i - 15], 18) ^ (w[i - 15] >> 3);
+            unsigned int s1 = RotateRight(w[i - 2], 17) ^ RotateRight(w[i - 2], 19) ^ (w[i - 2] >> 10);
+            w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+        }
+        unsigned int a[8];
+        std::copy(h, h + 8, a);
+        for (int i = 0; i < 64; ++i) {
+            unsigned int s1 = RotateRight(a[4], 6) ^ RotateRight(a[4], 11) ^ RotateRight(a[4], 25);
+            unsigned int ch = (a[4] & a[5]) ^ (~a[4] & a[6]);
+            unsigned int temp1 = a[7] + s1 + ch + k[i] + w[i];
+            unsigned int s0 = RotateRight(a[0], 2) ^ RotateRight(a[0], 13) ^ RotateRight(a[0], 22);
+            unsigned int maj = (a[0] & a[1]) ^ (a[0] & a[2]) ^ (a[1] & a[2]);
+            unsigned int temp2 = s0 + maj;
+            std::copy_backward(a, a + 7, a + 8);
+            a[4] += temp1;
+            a[0] = temp1 + temp2;
+        }
+        for (int i = 0; i < 8; ++i) h[i] += a[i];
+    }
+
+    std::string digest;
+    for (int i = 0; i < 8; ++i) digest += StringFormat("%08x", h[i]);
+    return digest;
+}
+
+std::string GzipCompress(const std::string &data)
+{
+    std::string output;
+    output.reserve(data.size() / 4 + 64);
+    // gzip header without file name and modification time
+    const unsigned char header[10] = { 0x1F, 0x8B, 8, 0, 0, 0, 0, 0, 0, 3 };
+    output.append((const char *)header, 10);
+
+    Deflate(data, output);
+
+    // trailer with the CRC-32 and the size
+    AppendUInt32(output, Crc32(data));
+    AppendUInt32(output, (unsigned int)data.size());
+
+    return output;
+}
+
+std::string ZlibCompress(const std::string &data)
+{
+    std::string output;
+    output.reserve(data.size() / 4 + 64);
+    // zlib header for deflate with a 32K window and the default level
+    output.push_back((char)0x78);
+    output.push_back((char)0x9C);
+
+    Deflate(data, output);
+
+    // trailer with the Adler-32 checksum (big-endian), with the modulo every 5552 bytes (before b overflows)
+    const unsigned char *bytes = (const unsigned char *)data.data();
+    unsigned int a = 1, b = 0;
+    for (size_t pos = 0; pos < data.size();) {
+        size_t blockEnd = std::min(pos + 5552, data.size());
+        for (; pos < blockEnd; ++pos) {
+            a += bytes[pos];
+            b += a;
+        }
+        a %= 65521;
+        b %= 65521;
+    }
+    unsigned int adler = (b << 16) | a;
+    for (int i = 3; i >= 0; --i) output.push_back(char((adler >> (8 * i)) & 0xFF));
+
+    return output;
+}
+
+
 } // namespace vrv
@@ -19,6 +19,11 @@ extern "C" {
  * Methods exported to use the Toolkit class
  ****************************************************************/
 
+void vrvToolkit_completeLayout(Toolkit *tk)
+{
+    tk->CompleteLayout();
+}
+
 void *vrvToolkit_constructor()
 {
     // set the default resource path
@@ -56,6 +61,11 @@ const char *vrvToolkit_editInfo(Toolkit *tk)
     return tk->GetCString();
 }
 
+void vrvToolkit_enableRenderCache(Toolkit *tk, const char *directory, int maxSize, bool verify)
+{
+    tk->EnableRenderCache(directory, maxSize, verify);
+}
+
 const char *vrvToolkit_getAvailableOptions(Toolkit *tk)
 {
     tk->SetCString(tk->GetAvailableOptions());
@@ -74,6 +84,12 @@ const char *vrvToolkit_getElementsAtTime(Toolkit *tk, int millisec)
     return tk->GetCString();
 }
 
+const char *vrvToolkit_getGlyphSprite(Toolkit *tk, bool all_glyphs)
+{
+    tk->SetCString(tk->GetGlyphSprite(all_glyphs));
+    return tk->GetCString();
+}
+
 const char *vrvToolkit_getHumdrum(Toolkit *tk)
 {
     const char *buffer = tk->GetHumdrumBuffer();
@@ -114,6 +130,12 @@ int vrvToolkit_getPageWithElement(Toolkit *tk, const char *xmlId)
     return tk->GetPageWithElement(xmlId);
 }
 
+const char *vrvToolkit_getRenderCacheStats(Toolkit *tk)
+{
+    tk->SetCString(tk->GetRenderCacheStats());
+    return tk->GetCString();
+}
+
 double vrvToolkit_getTimeForElement(Toolkit *tk, const char *xmlId)
 {
     return tk->GetTimeForElement(xmlId);
@@ -125,12 +147,30 @@ const char *vrvToolkit_getVersion(Toolkit *tk)
     return tk->GetCString();
 }
 
+bool vrvToolkit_isLayoutComplete(Toolkit *tk)
+{
+    return tk->IsLayoutComplete();
+}
+
 bool vrvToolkit_loadData(Toolkit *tk, const char *data)
 {
     tk->ResetLogBuffer();
     return tk->LoadData(data);
 }
 
+bool vrvToolkit_loadSnapshot(Toolkit *tk, const char *filename)
+{
+    tk->ResetLogBuffer();
+    return tk->LoadSnapshot(filename);
+}
+
+const char *vrvToolkit_renderMeasureRangeToSVG(Toolkit *tk, int first_measure, int last_measure)
+{
+    tk->ResetLogBuffer();
+    tk->SetCString(tk->RenderMeasureRangeToSVG(first_measure, last_measure, false));
+    return tk->GetCString();
+}
+
 const char *vrvToolkit_renderToMIDI(Toolkit *tk, const char *c_options)
 {
     tk->ResetLogBuffer();
@@ -145,6 +185,21 @@ const char *vrvToolkit_renderToSVG(Toolkit *tk, int page_no, const char *c_optio
     return tk->GetCString();
 }
 
+const char *vrvToolkit_renderToSVGClip(
+    Toolkit *tk, int page_no, int x, int y, int width, int height, const char *c_options)
+{
+    tk->ResetLogBuffer();
+    tk->SetCString(tk->RenderToSVG(page_no, x, y, width, height, false));
+    return tk->GetCString();
+}
+
+const char *vrvToolkit_renderToSVGPatch(Toolkit *tk, int page_no)
+{
+    tk->ResetLogBuffer();
+    tk->SetCString(tk->RenderToSVGPatch(page_no));
+    return tk->GetCString();
+}
+
 const char *vrvToolkit_renderToTimemap(Toolkit *tk)
 {
     tk->ResetLogBuffer();
@@ -171,6 +226,12 @@ const char *vrvToolkit_renderData(Toolkit *tk, const char *data, const char *opt
     return vrvToolkit_renderToSVG(tk, 1, options);
 }
 
+bool vrvToolkit_saveSnapshot(Toolkit *tk, const char *filename)
+{
+    tk->ResetLogBuffer();
+    return tk->SaveSnapshot(filename);
+}
+
 void vrvToolkit_setOptions(Toolkit *tk, const char *options)
 {
     if (!tk->SetOptions(options)) {
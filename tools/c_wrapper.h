@@ -9,13 +9,16 @@
  * Methods exported a functions to use the Toolkit class
  ****************************************************************/
 
+void vrvToolkit_completeLayout(Toolkit *tk);
 void *vrvToolkit_constructor();
 void *vrvToolkit_constructorResourcePath(const char * resourcePath);
 void vrvToolkit_destructor(Toolkit *tk);
 bool vrvToolkit_edit(Toolkit *tk, const char *editorAction);
+void vrvToolkit_enableRenderCache(Toolkit *tk, const char *directory, int maxSize, bool verify);
 const char *vrvToolkit_getAvailableOptions(Toolkit *tk);
 const char *vrvToolkit_getElementAttr(Toolkit *tk, const char *xmlId);
 const char *vrvToolkit_getElementsAtTime(Toolkit *tk, int millisec);
+const char *vrvToolkit_getGlyphSprite(Toolkit *tk, bool all_glyphs);
 const char *vrvToolkit_getHumdrum(Toolkit *tk);
 const char *vrvToolkit_getLog(Toolkit *tk);
 const char *vrvToolkit_getMEI(Toolkit *tk, int page_no, bool score_based);
@@ -23,13 +26,21 @@ const char *vrvToolkit_getMIDIValuesForElement(Toolkit *tk, const char *xmlId);
 const char *vrvToolkit_getOptions(Toolkit *tk, bool default_values);
 int vrvToolkit_getPageCount(Toolkit *tk);
 int vrvToolkit_getPageWithElement(Toolkit *tk, const char *xmlId);
+const char *vrvToolkit_getRenderCacheStats(Toolkit *tk);
 double vrvToolkit_getTimeForElement(Toolkit *tk, const char *xmlId);
 const char *vrvToolkit_getVersion(Toolkit *tk);
+bool vrvToolkit_isLayoutComplete(Toolkit *tk);
 bool vrvToolkit_loadData(Toolkit *tk, const char *data);
+bool vrvToolkit_loadSnapshot(Toolkit *tk, const char *filename);
+const char *vrvToolkit_renderMeasureRangeToSVG(Toolkit *tk, int first_measure, int last_measure);
 const char *vrvToolkit_renderToMIDI(Toolkit *tk, const char *c_options);
 const char *vrvToolkit_renderToSVG(Toolkit *tk, int page_no, const char *c_options);
+const char *vrvToolkit_renderToSVGClip(
+    Toolkit *tk, int page_no, int x, int y, int width, int height, const char *c_options);
+const char *vrvToolkit_renderToSVGPatch(Toolkit *tk, int page_no);
 const char *vrvToolkit_renderToTimemap(Toolkit *tk);
 void vrvToolkit_redoLayout(Toolkit *tk);
 void vrvToolkit_redoPagePitchPosLayout(Toolkit *tk);
 const char *vrvToolkit_renderData(Toolkit *tk, const char *data, const char *options);
+bool vrvToolkit_saveSnapshot(Toolkit *tk, const char *filename);
 void vrvToolkit_setOptions(Toolkit *tk, const char *options);
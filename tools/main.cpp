@@ -113,7 +113,8 @@ void display_usage()
     std::cout << " -p, --page <i>        Select the page to engrave (default is 1)" << std::endl;
     std::cout << " -r, --resources <s>   Path to SVG resources (default is " << vrv::Resources::GetPath() << ")" << std::endl;
     std::cout << " -s, --scale <i>       Scale percent (default is " << DEFAULT_SCALE << ")" << std::endl;
-    std::cout << " -t, --type <s>        Select output format: mei, svg, or midi (default is svg)" << std::endl;
+    std::cout << " -t, --type <s>        Select output format: mei, svg, svgz, png, pdf, midi, or snapshot (default is svg)"
+              << std::endl;
     std::cout << " -v, --version         Display the version number" << std::endl;
     std::cout << " -x, --xml-id-seed <i> Seed the random number generator for XML IDs" << std::endl;
 
@@ -399,9 +400,12 @@ int main(int argc, char **argv)
         exit(1);
     }
 
-    if ((outformat != "svg") && (outformat != "mei") && (outformat != "midi") && (outformat != "timemap")
-        && (outformat != "humdrum") && (outformat != "hum")) {
-        std::cerr << "Output format (" << outformat << ") can only be 'mei', 'svg', 'midi', or 'humdrum'." << std::endl;
+    if ((outformat != "svg") && (outformat != "svgz") && (outformat != "png") && (outformat != "pdf")
+        && (outformat != "mei") && (outformat != "midi") && (outformat != "timemap") && (outformat != "humdrum")
+        && (outformat != "hum") && (outformat != "snapshot")) {
+        std::cerr << "Output format (" << outformat
+                  << ") can only be 'mei', 'svg', 'svgz', 'png', 'pdf', 'midi', 'humdrum', or 'snapshot'."
+                  << std::endl;
         exit(1);
     }
 
@@ -434,6 +438,12 @@ int main(int argc, char **argv)
             exit(1);
         }
     }
+    else if (infile.size() > 8 && infile.compare(infile.size() - 8, 8, ".vrvsnap") == 0) {
+        if (!toolkit.LoadSnapshot(infile)) {
+            std::cerr << "The snapshot '" << infile << "' could not be loaded." << std::endl;
+            exit(1);
+        }
+    }
     else {
         if (!toolkit.LoadFile(infile)) {
             std::cerr << "The file '" << infile << "' could not be opened." << std::endl;
@@ -442,6 +452,10 @@ int main(int argc, char **argv)
     }
 
     if (toolkit.GetOutputFormat() != vrv::HUMDRUM) {
+        // With the progressive layout, the pages after the one requested are cast off only when needed
+        if (all_pages || (page > toolkit.GetPageCount())) {
+            toolkit.CompleteLayout();
+        }
         // Check the page range
         if (page > toolkit.GetPageCount()) {
             std::cerr << "The page requested (" << page << ") is not in the page range (max is " << toolkit.GetPageCount()
@@ -460,15 +474,18 @@ int main(int argc, char **argv)
         to = toolkit.GetPageCount() + 1;
     }
 
-    if (outformat == "svg") {
+    if ((outformat == "svg") || (outformat == "svgz")) {
         int p;
         for (p = from; p < to; ++p) {
             std::string cur_outfile = outfile;
             if (all_pages) {
                 cur_outfile += vrv::StringFormat("_%03d", p);
             }
-            cur_outfile += ".svg";
-            if (std_output) {
+            cur_outfile += "." + outformat;
+            if (std_output && (outformat == "svgz")) {
+                std::cout << vrv::GzipCompress(toolkit.RenderToSVG(p, true));
+            }
+            else if (std_output) {
                 std::cout << toolkit.RenderToSVG(p);
             }
             else if (!toolkit.RenderToSVGFile(cur_outfile, p)) {
@@ -479,6 +496,54 @@ int main(int argc, char **argv)
                 std::cerr << "Output written to " << cur_outfile << "." << std::endl;
             }
         }
+        // The glyph sprite referenced by the pages is written relative to the output
+        std::string glyphSprite = options->m_svgGlyphSprite.GetValue();
+        if (!glyphSprite.empty() && !std_output) {
+            std::string spriteFile = outfile.substr(0, outfile.find_last_of('/') + 1) + glyphSprite;
+            if (!toolkit.GetGlyphSpriteFile(spriteFile)) {
+                std::cerr << "Unable to write the glyph sprite to " << spriteFile << "." << std::endl;
+                exit(1);
+            }
+            else {
+                std::cerr << "Glyph sprite written to " << spriteFile << "." << std::endl;
+            }
+        }
+    }
+
+    else if (outformat == "png") {
+        int p;
+        for (p = from; p < to; ++p) {
+            std::string cur_outfile = outfile;
+            if (all_pages) {
+                cur_outfile += vrv::StringFormat("_%03d", p);
+            }
+            cur_outfile += ".png";
+            if (std_output) {
+                std::cout << toolkit.RenderToPNG(p, options->m_pngWidth.GetValue());
+            }
+            else if (!toolkit.RenderToPNGFile(cur_outfile, p, options->m_pngWidth.GetValue())) {
+                std::cerr << "Unable to write PNG to " << cur_outfile << "." << std::endl;
+                exit(1);
+            }
+            else {
+                std::cerr << "Output written to " << cur_outfile << "." << std::endl;
+            }
+        }
+    }
+
+    else if (outformat == "pdf") {
+        // All the pages are always written in a single file
+        outfile += ".pdf";
+        if (std_output) {
+            std::cout << toolkit.RenderToPDF();
+        }
+        else if (!toolkit.RenderToPDFFile(outfile)) {
+            std::cerr << "Unable to write PDF to " << outfile << "." << std::endl;
+            exit(1);
+        }
+        else {
+            std::cerr << "Output written to " << outfile << "." << std::endl;
+        }
     }
 
     else if (outformat == "midi") {
@@ -509,6 +574,20 @@ int main(int argc, char **argv)
             std::cerr << "Output written to " << outfile << "." << std::endl;
         }
     }
+    else if (outformat == "snapshot") {
+        outfile += ".vrvsnap";
+        if (std_output) {
+            std::cerr << "Snapshot cannot write to standard output." << std::endl;
+            exit(1);
+        }
+        else if (!toolkit.SaveSnapshot(outfile)) {
+            std::cerr << "Unable to write snapshot to " << outfile << "." << std::endl;
+            exit(1);
+        }
+        else {
+            std::cerr << "Output written to " << outfile << "." << std::endl;
+        }
+    }
     else if (outformat == "humdrum" || outformat == "hum") {
         outfile += ".krn";
         if (std_output) {